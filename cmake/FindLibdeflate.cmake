@@ -0,0 +1,21 @@
+# - Try to find libdeflate
+#   https://github.com/ebiggers/libdeflate
+#
+# Exports:
+#  Libdeflate_FOUND
+#  LIBDEFLATE_INCLUDE_DIR
+#  LIBDEFLATE_LIBRARY
+# Hints:
+#  LIBDEFLATE_LIBRARY_DIR
+
+find_path(LIBDEFLATE_INCLUDE_DIR
+          libdeflate.h)
+
+find_library(LIBDEFLATE_LIBRARY
+             NAMES deflate
+             HINTS "${LIBDEFLATE_LIBRARY_DIR}")
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Libdeflate DEFAULT_MSG
+                                  LIBDEFLATE_LIBRARY LIBDEFLATE_INCLUDE_DIR)
+mark_as_advanced(LIBDEFLATE_INCLUDE_DIR LIBDEFLATE_LIBRARY)
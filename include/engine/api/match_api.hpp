@@ -11,6 +11,10 @@
 #include "engine/map_matching/sub_matching.hpp"
 
 #include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstdint>
+#include <vector>
 
 namespace osrm
 {
@@ -39,10 +43,11 @@ class MatchAPI final : public RouteAPI
         BOOST_ASSERT(sub_matchings.size() == sub_routes.size());
         for (auto index : util::irange<std::size_t>(0UL, sub_matchings.size()))
         {
-            auto route = MakeRoute(sub_routes[index].segment_end_coordinates,
-                                   sub_routes[index].unpacked_path_segments,
-                                   sub_routes[index].source_traversed_in_reverse,
-                                   sub_routes[index].target_traversed_in_reverse);
+            auto route = IsCompact() ? MakeCompactRoute(sub_routes[index])
+                                     : MakeRoute(sub_routes[index].segment_end_coordinates,
+                                                 sub_routes[index].unpacked_path_segments,
+                                                 sub_routes[index].source_traversed_in_reverse,
+                                                 sub_routes[index].target_traversed_in_reverse);
             route.values["confidence"] = sub_matchings[index].confidence;
             routes.values.push_back(std::move(route));
         }
@@ -52,6 +57,48 @@ class MatchAPI final : public RouteAPI
     }
 
   protected:
+    // Only the matched node ids are requested, which skips assembling legs and geometries
+    bool IsCompact() const
+    {
+        return parameters.geometries == RouteParameters::GeometriesType::None &&
+               !parameters.steps &&
+               parameters.annotations_type == RouteParameters::AnnotationsType::Nodes;
+    }
+
+    // Matching with the OSM node ids of all its legs in one array
+    util::json::Object MakeCompactRoute(const InternalRouteResult &sub_route) const
+    {
+        std::vector<OSMNodeID> node_ids;
+        const auto number_of_legs = sub_route.segment_end_coordinates.size();
+        for (const auto idx : util::irange<std::size_t>(0UL, number_of_legs))
+        {
+            const auto &phantoms = sub_route.segment_end_coordinates[idx];
+            const auto leg_node_ids =
+                guidance::assembleNodeIds(BaseAPI::facade,
+                                          sub_route.unpacked_path_segments[idx],
+                                          phantoms.source_phantom,
+                                          phantoms.target_phantom,
+                                          sub_route.source_traversed_in_reverse[idx],
+                                          sub_route.target_traversed_in_reverse[idx]);
+
+            guidance::appendLegNodeIds(node_ids,
+                                       leg_node_ids,
+                                       idx > 0 && sub_route.target_traversed_in_reverse[idx - 1],
+                                       sub_route.source_traversed_in_reverse[idx]);
+        }
+
+        util::json::Array nodes;
+        nodes.values.reserve(node_ids.size());
+        for (const auto node_id : node_ids)
+        {
+            nodes.values.push_back(static_cast<std::uint64_t>(node_id));
+        }
+
+        util::json::Object route;
+        route.values["nodes"] = std::move(nodes);
+        return route;
+    }
+
     // FIXME this logic is a little backwards. We should change the output format of the
     // map_matching
     // routing algorithm to be easier to consume here.
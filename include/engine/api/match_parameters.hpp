@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "engine/api/route_parameters.hpp"
 
+#include <string>
 #include <vector>
 
 namespace osrm
@@ -44,6 +45,8 @@ namespace api
  *
  * Holds member attributes:
  *  - timestamps: timestamp(s) for the corresponding input coordinate(s)
+ *  - vehicle: id of a live trace, the coordinates are appended to the points of earlier
+ *    requests with the same id and only the finally matched part is returned
  *
  * \see OSRM, Coordinate, Hint, Bearing, RouteParame, RouteParameters, TableParameters,
  *      NearestParameters, TripParameters, MatchParameters and TileParameters
@@ -77,11 +80,16 @@ struct MatchParameters : public RouteParameters
     std::vector<unsigned> timestamps;
     GapsType gaps;
     bool tidy;
+    std::string vehicle;
 
     bool IsValid() const
     {
-        return RouteParameters::IsValid() &&
-               (timestamps.empty() || timestamps.size() == coordinates.size());
+        // live traces may be extended by a single point and can not be tidied
+        const auto coordinates_ok =
+            vehicle.empty() ? RouteParameters::IsValid()
+                            : !coordinates.empty() && BaseParameters::IsValid() && !tidy &&
+                                  (geometries != GeometriesType::None || !steps);
+        return coordinates_ok && (timestamps.empty() || timestamps.size() == coordinates.size());
     }
 };
 }
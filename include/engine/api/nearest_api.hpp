@@ -9,6 +9,8 @@
 
 #include <boost/assert.hpp>
 
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -42,45 +44,11 @@ class NearestAPI final : public BaseAPI
                            auto waypoint = MakeWaypoint(phantom_node);
                            waypoint.values["distance"] = phantom_with_distance.distance;
 
-                           util::json::Array nodes;
-
-                           std::uint64_t from_node = 0;
-                           std::uint64_t to_node = 0;
-
-                           std::vector<NodeID> forward_geometry;
-                           if (phantom_node.forward_segment_id.enabled)
-                           {
-                               auto segment_id = phantom_node.forward_segment_id.id;
-                               const auto geometry_id = facade.GetGeometryIndex(segment_id).id;
-                               forward_geometry =
-                                   facade.GetUncompressedForwardGeometry(geometry_id);
-
-                               auto osm_node_id = facade.GetOSMNodeIDOfNode(
-                                   forward_geometry[phantom_node.fwd_segment_position]);
-                               to_node = static_cast<std::uint64_t>(osm_node_id);
-                           }
-
-                           if (phantom_node.reverse_segment_id.enabled)
-                           {
-                               auto segment_id = phantom_node.reverse_segment_id.id;
-                               const auto geometry_id = facade.GetGeometryIndex(segment_id).id;
-                               std::vector<NodeID> geometry =
-                                   facade.GetUncompressedForwardGeometry(geometry_id);
-                               auto osm_node_id = facade.GetOSMNodeIDOfNode(
-                                   geometry[phantom_node.fwd_segment_position + 1]);
-                               from_node = static_cast<std::uint64_t>(osm_node_id);
-                           }
-                           else if (phantom_node.forward_segment_id.enabled &&
-                                    phantom_node.fwd_segment_position > 0)
-                           {
-                               // In the case of one way, rely on forward segment only
-                               auto osm_node_id = facade.GetOSMNodeIDOfNode(
-                                   forward_geometry[phantom_node.fwd_segment_position - 1]);
-                               from_node = static_cast<std::uint64_t>(osm_node_id);
-                           }
-                           nodes.values.push_back(from_node);
-                           nodes.values.push_back(to_node);
-                           waypoint.values["nodes"] = std::move(nodes);
+                           const auto nodes = MakeNodes(phantom_node);
+                           util::json::Array json_nodes;
+                           json_nodes.values.push_back(nodes.first);
+                           json_nodes.values.push_back(nodes.second);
+                           waypoint.values["nodes"] = std::move(json_nodes);
 
                            return waypoint;
                        });
@@ -89,7 +57,89 @@ class NearestAPI final : public BaseAPI
         response.values["waypoints"] = std::move(waypoints);
     }
 
+    // Batch responses hold one entry per input coordinate: null if nothing could be
+    // snapped, otherwise an array of [longitude, latitude, distance, from_node, to_node]
+    // arrays. No names or hints are rendered to keep responses for thousands of points small.
+    void MakeBatchResponse(const std::vector<std::vector<PhantomNodeWithDistance>> &phantom_nodes,
+                           util::json::Object &response) const
+    {
+        BOOST_ASSERT(phantom_nodes.size() == parameters.coordinates.size());
+
+        util::json::Array waypoints;
+        waypoints.values.reserve(phantom_nodes.size());
+        for (const auto &candidates : phantom_nodes)
+        {
+            if (candidates.empty())
+            {
+                waypoints.values.push_back(util::json::Null());
+                continue;
+            }
+
+            util::json::Array snapped;
+            snapped.values.reserve(candidates.size());
+            for (const auto &phantom_with_distance : candidates)
+            {
+                const auto &phantom_node = phantom_with_distance.phantom_node;
+                const auto nodes = MakeNodes(phantom_node);
+
+                util::json::Array compact;
+                compact.values.reserve(5);
+                compact.values.push_back(
+                    static_cast<double>(util::toFloating(phantom_node.location.lon)));
+                compact.values.push_back(
+                    static_cast<double>(util::toFloating(phantom_node.location.lat)));
+                compact.values.push_back(phantom_with_distance.distance);
+                compact.values.push_back(nodes.first);
+                compact.values.push_back(nodes.second);
+                snapped.values.push_back(std::move(compact));
+            }
+            waypoints.values.push_back(std::move(snapped));
+        }
+
+        response.values["code"] = "Ok";
+        response.values["waypoints"] = std::move(waypoints);
+    }
+
     const NearestParameters &parameters;
+
+  private:
+    // Returns the OSM ids of the nodes enclosing the snapped segment as (from, to)
+    std::pair<std::uint64_t, std::uint64_t> MakeNodes(const PhantomNode &phantom_node) const
+    {
+        std::uint64_t from_node = 0;
+        std::uint64_t to_node = 0;
+
+        std::vector<NodeID> forward_geometry;
+        if (phantom_node.forward_segment_id.enabled)
+        {
+            auto segment_id = phantom_node.forward_segment_id.id;
+            const auto geometry_id = facade.GetGeometryIndex(segment_id).id;
+            forward_geometry = facade.GetUncompressedForwardGeometry(geometry_id);
+
+            auto osm_node_id =
+                facade.GetOSMNodeIDOfNode(forward_geometry[phantom_node.fwd_segment_position]);
+            to_node = static_cast<std::uint64_t>(osm_node_id);
+        }
+
+        if (phantom_node.reverse_segment_id.enabled)
+        {
+            auto segment_id = phantom_node.reverse_segment_id.id;
+            const auto geometry_id = facade.GetGeometryIndex(segment_id).id;
+            std::vector<NodeID> geometry = facade.GetUncompressedForwardGeometry(geometry_id);
+            auto osm_node_id =
+                facade.GetOSMNodeIDOfNode(geometry[phantom_node.fwd_segment_position + 1]);
+            from_node = static_cast<std::uint64_t>(osm_node_id);
+        }
+        else if (phantom_node.forward_segment_id.enabled && phantom_node.fwd_segment_position > 0)
+        {
+            // In the case of one way, rely on forward segment only
+            auto osm_node_id =
+                facade.GetOSMNodeIDOfNode(forward_geometry[phantom_node.fwd_segment_position - 1]);
+            from_node = static_cast<std::uint64_t>(osm_node_id);
+        }
+
+        return std::make_pair(from_node, to_node);
+    }
 };
 
 } // ns api
@@ -42,6 +42,7 @@ namespace api
  *
  * Holds member attributes:
  *  - number of results: number of nearest segments that should be returned
+ *  - batch: snap every coordinate at once and return a compact result per coordinate
  *
  * \see OSRM, Coordinate, Hint, Bearing, RouteParame, RouteParameters, TableParameters,
  *      NearestParameters, TripParameters, MatchParameters and TileParameters
@@ -49,6 +50,7 @@ namespace api
 struct NearestParameters : public BaseParameters
 {
     unsigned number_of_results = 1;
+    bool batch = false;
 
     bool IsValid() const { return BaseParameters::IsValid() && number_of_results >= 1; }
 };
@@ -190,7 +190,8 @@ class RouteAPI : public BaseAPI
 
         auto route = guidance::assembleRoute(legs);
         boost::optional<util::json::Value> json_overview;
-        if (parameters.overview != RouteParameters::OverviewType::False)
+        if (parameters.overview != RouteParameters::OverviewType::False &&
+            parameters.geometries != RouteParameters::GeometriesType::None)
         {
             const auto use_simplification =
                 parameters.overview == RouteParameters::OverviewType::Simplified;
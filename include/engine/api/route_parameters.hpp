@@ -45,7 +45,7 @@ namespace api
  * Holds member attributes:
  *  - steps: return route step for each route leg
  *  - alternatives: tries to find alternative routes
- *  - geometries: route geometry encoded in Polyline, Polyline6 or GeoJSON
+ *  - geometries: route geometry encoded in Polyline, Polyline6 or GeoJSON, or None to skip it
  *  - overview: adds overview geometry either Full, Simplified (according to highest zoom level) or
  *              False (not at all)
  *  - continue_straight: enable or disable continue_straight (disabled by default)
@@ -59,7 +59,8 @@ struct RouteParameters : public BaseParameters
     {
         Polyline,
         Polyline6,
-        GeoJSON
+        GeoJSON,
+        None
     };
     enum class OverviewType
     {
@@ -149,7 +150,9 @@ struct RouteParameters : public BaseParameters
     {
         const auto coordinates_ok = coordinates.size() >= 2;
         const auto base_params_ok = BaseParameters::IsValid();
-        return coordinates_ok && base_params_ok;
+        // steps come with their geometry
+        const auto geometries_ok = geometries != GeometriesType::None || !steps;
+        return coordinates_ok && base_params_ok && geometries_ok;
     }
 };
 
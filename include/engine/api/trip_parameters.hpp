@@ -31,6 +31,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "engine/api/route_parameters.hpp"
 
 #include <boost/optional.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -43,6 +47,10 @@ namespace api
 /**
  * Parameters specific to the OSRM Trip service.
  *
+ * Holds member attributes:
+ *  - precedences: pairs of coordinate indices, the first has to be visited before the second
+ *  - max_duration: upper bound on the duration of the trip in seconds
+ *
  * \see OSRM, Coordinate, Hint, Bearing, RouteParame, RouteParameters, TableParameters,
  *      NearestParameters, TripParameters, MatchParameters and TileParameters
  */
@@ -73,8 +81,23 @@ struct TripParameters : public RouteParameters
     SourceType source = SourceType::Any;
     DestinationType destination = DestinationType::Any;
     bool roundtrip = true;
+    std::vector<std::pair<std::size_t, std::size_t>> precedences;
+    boost::optional<double> max_duration;
+
+    bool IsConstrained() const { return !precedences.empty() || max_duration; }
 
-    bool IsValid() const { return RouteParameters::IsValid(); }
+    bool IsValid() const
+    {
+        const auto precedences_valid =
+            std::all_of(precedences.begin(), precedences.end(), [this](const auto &precedence) {
+                return precedence.first < coordinates.size() &&
+                       precedence.second < coordinates.size() &&
+                       precedence.first != precedence.second;
+            });
+        // also rejects NaN
+        const auto max_duration_valid = !max_duration || *max_duration >= 0;
+        return RouteParameters::IsValid() && precedences_valid && max_duration_valid;
+    }
 };
 }
 }
@@ -36,7 +36,8 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
     using Facade = datafacade::ContiguousInternalMemoryDataFacade<AlgorithmT>;
 
   public:
-    DataWatchdogImpl() : active(true), timestamp(0)
+    DataWatchdogImpl(const util::MMapAdvice &rtree_leaf_advice_ = {})
+        : active(true), timestamp(0), rtree_leaf_advice(rtree_leaf_advice_)
     {
         // create the initial facade before launching the watchdog thread
         {
@@ -44,7 +45,9 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
 
             facade_factory =
                 DataFacadeFactory<datafacade::ContiguousInternalMemoryDataFacade, AlgorithmT>(
-                    std::make_shared<datafacade::SharedMemoryAllocator>(barrier.data().region));
+                    std::make_shared<datafacade::SharedMemoryAllocator>(
+                        barrier.data().region, barrier.data().timestamp),
+                    rtree_leaf_advice);
             timestamp = barrier.data().timestamp;
         }
 
@@ -84,7 +87,9 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
                 auto region = barrier.data().region;
                 facade_factory =
                     DataFacadeFactory<datafacade::ContiguousInternalMemoryDataFacade, AlgorithmT>(
-                        std::make_shared<datafacade::SharedMemoryAllocator>(region));
+                        std::make_shared<datafacade::SharedMemoryAllocator>(
+                            region, barrier.data().timestamp),
+                        rtree_leaf_advice);
                 timestamp = barrier.data().timestamp;
                 util::Log() << "updated facade to region " << region << " with timestamp "
                             << timestamp;
@@ -98,6 +103,7 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
     std::thread watcher;
     bool active;
     unsigned timestamp;
+    util::MMapAdvice rtree_leaf_advice;
     DataFacadeFactory<datafacade::ContiguousInternalMemoryDataFacade, AlgorithmT> facade_factory;
 };
 }
@@ -18,6 +18,8 @@ class ContiguousBlockAllocator
     // interface to give access to the datafacades
     virtual storage::DataLayout &GetLayout() = 0;
     virtual char *GetMemory() = 0;
+    // changes whenever a different dataset is loaded, e.g. after a weight update
+    virtual unsigned GetDatasetGeneration() const = 0;
 };
 
 } // namespace datafacade
@@ -38,11 +38,13 @@
 #include "util/guidance/turn_bearing.hpp"
 #include "util/guidance/turn_lanes.hpp"
 #include "util/log.hpp"
+#include "util/mmap_advice.hpp"
 #include "util/name_table.hpp"
 #include "util/packed_vector.hpp"
 #include "util/range_table.hpp"
 #include "util/rectangle.hpp"
 #include "util/static_graph.hpp"
+#include "util/static_grid.hpp"
 #include "util/static_rtree.hpp"
 #include "util/typedefs.hpp"
 
@@ -180,7 +182,8 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     using IndexBlock = util::RangeTable<16, storage::Ownership::View>::BlockT;
     using RTreeLeaf = super::RTreeLeaf;
     using SharedRTree = util::StaticRTree<RTreeLeaf, storage::Ownership::View>;
-    using SharedGeospatialQuery = GeospatialQuery<SharedRTree, BaseDataFacade>;
+    using SharedGrid = util::StaticGridView<RTreeLeaf>;
+    using SharedGeospatialQuery = GeospatialQuery<SharedRTree, BaseDataFacade, SharedGrid>;
     using RTreeNode = SharedRTree::TreeNode;
 
     extractor::ClassData exclude_mask;
@@ -205,8 +208,10 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     util::vector_view<util::guidance::LaneTupleIdPair> m_lane_tupel_id_pairs;
 
     std::unique_ptr<SharedRTree> m_static_rtree;
+    SharedGrid m_spatial_grid;
     std::unique_ptr<SharedGeospatialQuery> m_geospatial_query;
     boost::filesystem::path file_index_path;
+    util::MMapAdvice rtree_leaf_advice;
 
     extractor::IntersectionBearingsView intersection_bearings_view;
 
@@ -252,26 +257,74 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
         const auto file_index_ptr =
             data_layout.GetBlockPtr<char>(memory_block, storage::DataLayout::FILE_INDEX_PATH);
         file_index_path = boost::filesystem::path(file_index_ptr);
-        if (!boost::filesystem::exists(file_index_path))
-        {
-            util::Log(logDEBUG) << "Leaf file name " << file_index_path.string();
-            throw util::exception("Could not load " + file_index_path.string() +
-                                  "Is any data loaded into shared memory?" + SOURCE_REF);
-        }
 
         auto tree_nodes_ptr =
             data_layout.GetBlockPtr<RTreeNode>(memory_block, storage::DataLayout::R_SEARCH_TREE);
         auto tree_level_sizes_ptr = data_layout.GetBlockPtr<std::uint64_t>(
             memory_block, storage::DataLayout::R_SEARCH_TREE_LEVELS);
-        m_static_rtree.reset(
-            new SharedRTree(tree_nodes_ptr,
-                            data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE],
-                            tree_level_sizes_ptr,
-                            data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE_LEVELS],
-                            file_index_path,
-                            m_coordinate_list));
-        m_geospatial_query.reset(
-            new SharedGeospatialQuery(*m_static_rtree, m_coordinate_list, *this));
+
+        // The leaves were loaded by osrm-datastore --embed-rtree-leaves, no need to touch the file
+        const auto number_of_leaves =
+            data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE_LEAVES];
+        if (number_of_leaves > 0)
+        {
+            // the leaves are already resident in the data block, there is no mapping to advise
+            if (rtree_leaf_advice.populate || rtree_leaf_advice.huge_pages ||
+                rtree_leaf_advice.prefetch)
+            {
+                util::Log(logWARNING) << "The r-tree leaves are loaded into the data block, "
+                                         "ignoring the advice for "
+                                      << file_index_path.string();
+            }
+            auto tree_leaves_ptr = data_layout.GetBlockPtr<RTreeLeaf>(
+                memory_block, storage::DataLayout::R_SEARCH_TREE_LEAVES);
+            m_static_rtree.reset(
+                new SharedRTree(tree_nodes_ptr,
+                                data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE],
+                                tree_level_sizes_ptr,
+                                data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE_LEVELS],
+                                tree_leaves_ptr,
+                                number_of_leaves,
+                                m_coordinate_list));
+        }
+        else
+        {
+            if (!boost::filesystem::exists(file_index_path))
+            {
+                util::Log(logDEBUG) << "Leaf file name " << file_index_path.string();
+                throw util::exception("Could not load " + file_index_path.string() +
+                                      "Is any data loaded into shared memory?" + SOURCE_REF);
+            }
+
+            m_static_rtree.reset(
+                new SharedRTree(tree_nodes_ptr,
+                                data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE],
+                                tree_level_sizes_ptr,
+                                data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE_LEVELS],
+                                file_index_path,
+                                m_coordinate_list,
+                                rtree_leaf_advice));
+        }
+
+        // The grid is optional and only present if osrm-extract was asked to build it
+        if (data_layout.num_entries[storage::DataLayout::SPATIAL_GRID_HEADER] > 0)
+        {
+            const auto grid_header_ptr = data_layout.GetBlockPtr<SharedGrid::Header>(
+                memory_block, storage::DataLayout::SPATIAL_GRID_HEADER);
+            util::vector_view<std::uint32_t> grid_cell_offsets(
+                data_layout.GetBlockPtr<std::uint32_t>(
+                    memory_block, storage::DataLayout::SPATIAL_GRID_CELL_OFFSETS),
+                data_layout.num_entries[storage::DataLayout::SPATIAL_GRID_CELL_OFFSETS]);
+            util::vector_view<SharedGrid::Entry> grid_entries(
+                data_layout.GetBlockPtr<SharedGrid::Entry>(
+                    memory_block, storage::DataLayout::SPATIAL_GRID_ENTRIES),
+                data_layout.num_entries[storage::DataLayout::SPATIAL_GRID_ENTRIES]);
+            m_spatial_grid = SharedGrid{
+                *grid_header_ptr, std::move(grid_cell_offsets), std::move(grid_entries)};
+        }
+
+        m_geospatial_query.reset(new SharedGeospatialQuery(
+            *m_static_rtree, m_coordinate_list, *this, &m_spatial_grid));
     }
 
     void InitializeNodeInformationPointers(storage::DataLayout &layout, char *memory_ptr)
@@ -521,8 +574,9 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     // allows switching between process_memory/shared_memory datafacade, based on the type of
     // allocator
     ContiguousInternalMemoryDataFacadeBase(std::shared_ptr<ContiguousBlockAllocator> allocator_,
-                                           const std::size_t exclude_index)
-        : allocator(std::move(allocator_))
+                                           const std::size_t exclude_index,
+                                           const util::MMapAdvice &rtree_leaf_advice_ = {})
+        : rtree_leaf_advice(rtree_leaf_advice_), allocator(std::move(allocator_))
     {
         InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory(), exclude_index);
     }
@@ -635,6 +689,17 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
             input_coordinate, max_distance, approach);
     }
 
+    std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodesInRange(const std::vector<util::Coordinate> &input_coordinates,
+                               const std::vector<double> &max_distances,
+                               const std::vector<Approach> &approaches) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+
+        return m_geospatial_query->NearestPhantomNodesInRange(
+            input_coordinates, max_distances, approaches);
+    }
+
     std::vector<PhantomNodeWithDistance>
     NearestPhantomNodesInRange(const util::Coordinate input_coordinate,
                                const float max_distance,
@@ -818,6 +883,11 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
 
     std::string GetTimestamp() const override final { return m_timestamp; }
 
+    unsigned GetDatasetGeneration() const override final
+    {
+        return allocator->GetDatasetGeneration();
+    }
+
     bool GetContinueStraightDefault() const override final
     {
         return m_profile_properties->continue_straight_at_waypoint;
@@ -896,8 +966,9 @@ class ContiguousInternalMemoryDataFacade<CH>
 {
   public:
     ContiguousInternalMemoryDataFacade(std::shared_ptr<ContiguousBlockAllocator> allocator,
-                                       const std::size_t exclude_index)
-        : ContiguousInternalMemoryDataFacadeBase(allocator, exclude_index),
+                                       const std::size_t exclude_index,
+                                       const util::MMapAdvice &rtree_leaf_advice = {})
+        : ContiguousInternalMemoryDataFacadeBase(allocator, exclude_index, rtree_leaf_advice),
           ContiguousInternalMemoryAlgorithmDataFacade<CH>(allocator, exclude_index)
 
     {
@@ -1096,8 +1167,9 @@ class ContiguousInternalMemoryDataFacade<MLD> final
   private:
   public:
     ContiguousInternalMemoryDataFacade(std::shared_ptr<ContiguousBlockAllocator> allocator,
-                                       const std::size_t exclude_index)
-        : ContiguousInternalMemoryDataFacadeBase(allocator, exclude_index),
+                                       const std::size_t exclude_index,
+                                       const util::MMapAdvice &rtree_leaf_advice = {})
+        : ContiguousInternalMemoryDataFacadeBase(allocator, exclude_index, rtree_leaf_advice),
           ContiguousInternalMemoryAlgorithmDataFacade<MLD>(allocator, exclude_index)
 
     {
@@ -111,6 +111,11 @@ class BaseDataFacade
     NearestPhantomNodesInRange(const util::Coordinate input_coordinate,
                                const float max_distance,
                                const Approach approach) const = 0;
+    // Candidates for all points of a trace, one list per coordinate
+    virtual std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodesInRange(const std::vector<util::Coordinate> &input_coordinates,
+                               const std::vector<double> &max_distances,
+                               const std::vector<Approach> &approaches) const = 0;
 
     virtual std::vector<PhantomNodeWithDistance>
     NearestPhantomNodes(const util::Coordinate input_coordinate,
@@ -173,6 +178,9 @@ class BaseDataFacade
 
     virtual std::string GetTimestamp() const = 0;
 
+    // Identifies the loaded data including its weights, unlike the timestamp of the OSM data
+    virtual unsigned GetDatasetGeneration() const = 0;
+
     virtual bool GetContinueStraightDefault() const = 0;
 
     virtual double GetMapMatchingMaxSpeed() const = 0;
@@ -23,12 +23,16 @@ namespace datafacade
 class ProcessMemoryAllocator : public ContiguousBlockAllocator
 {
   public:
-    explicit ProcessMemoryAllocator(const storage::StorageConfig &config);
+    // see storage::Storage for embed_rtree_leaves
+    explicit ProcessMemoryAllocator(const storage::StorageConfig &config,
+                                    const bool embed_rtree_leaves = false);
     ~ProcessMemoryAllocator() override final;
 
     // interface to give access to the datafacades
     storage::DataLayout &GetLayout() override final;
     char *GetMemory() override final;
+    // the data is loaded once and never replaced
+    unsigned GetDatasetGeneration() const override final;
 
   private:
     std::unique_ptr<char[]> internal_memory;
@@ -23,15 +23,18 @@ namespace datafacade
 class SharedMemoryAllocator : public ContiguousBlockAllocator
 {
   public:
-    explicit SharedMemoryAllocator(storage::SharedDataType data_region);
+    // generation is the timestamp osrm-datastore gave the region when it was loaded
+    SharedMemoryAllocator(storage::SharedDataType data_region, unsigned generation);
     ~SharedMemoryAllocator() override final;
 
     // interface to give access to the datafacades
     storage::DataLayout &GetLayout() override final;
     char *GetMemory() override final;
+    unsigned GetDatasetGeneration() const override final;
 
   private:
     std::unique_ptr<storage::SharedMemory> m_large_memory;
+    unsigned m_generation;
 };
 
 } // namespace datafacade
@@ -31,8 +31,10 @@ class ImmutableProvider final : public DataFacadeProvider<AlgorithmT, FacadeT>
   public:
     using Facade = typename DataFacadeProvider<AlgorithmT, FacadeT>::Facade;
 
-    ImmutableProvider(const storage::StorageConfig &config)
-        : facade_factory(std::make_shared<datafacade::ProcessMemoryAllocator>(config))
+    ImmutableProvider(const storage::StorageConfig &config,
+                      const util::MMapAdvice &rtree_leaf_advice = {})
+        : facade_factory(std::make_shared<datafacade::ProcessMemoryAllocator>(config),
+                         rtree_leaf_advice)
     {
     }
 
@@ -57,6 +59,10 @@ class WatchingProvider : public DataFacadeProvider<AlgorithmT, FacadeT>
   public:
     using Facade = typename DataFacadeProvider<AlgorithmT, FacadeT>::Facade;
 
+    WatchingProvider(const util::MMapAdvice &rtree_leaf_advice = {}) : watchdog(rtree_leaf_advice)
+    {
+    }
+
     std::shared_ptr<const Facade> Get(const api::TileParameters &params) const override final
     {
         return watchdog.Get(params);
@@ -28,8 +28,16 @@
 #include "util/fingerprint.hpp"
 #include "util/json_container.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace osrm
 {
@@ -54,7 +62,13 @@ class EngineInterface
                         util::json::Object &result) const = 0;
     virtual Status Match(const api::MatchParameters &parameters,
                          util::json::Object &result) const = 0;
+    // Called with the index of a trace, its status and its result
+    using MatchResultHandler = std::function<void(std::size_t, Status, util::json::Object &)>;
+    virtual void Match(const std::vector<api::MatchParameters> &parameters,
+                       const MatchResultHandler &on_result) const = 0;
     virtual Status Tile(const api::TileParameters &parameters, std::string &result) const = 0;
+    // Generation of the dataset that new requests run on, see BaseDataFacade
+    virtual unsigned GetDatasetGeneration() const = 0;
 };
 
 template <typename Algorithm> class Engine final : public EngineInterface
@@ -65,23 +79,27 @@ template <typename Algorithm> class Engine final : public EngineInterface
           table_plugin(config.max_locations_distance_table),                    //
           matrix_plugin(config.max_locations_distance_table), //
           journey_plugin(config.max_locations_distance_table), //
-          nearest_plugin(config.max_results_nearest),                           //
-          trip_plugin(config.max_locations_trip),                               //
+          nearest_plugin(config.max_results_nearest, config.max_locations_nearest), //
+          trip_plugin(config.max_locations_trip, config.max_trip_search_time),    //
           match_plugin(config.max_locations_map_matching),                      //
-          tile_plugin()                                                         //
+          tile_plugin(static_cast<std::size_t>(config.max_tile_cache_size) * 1024 * 1024,
+                      config.tile_archive,
+                      config.storage_config) //
 
     {
         if (config.use_shared_memory)
         {
             util::Log(logDEBUG) << "Using shared memory with algorithm "
                                 << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<WatchingProvider<Algorithm>>();
+            facade_provider =
+                std::make_unique<WatchingProvider<Algorithm>>(config.rtree_leaf_advice);
         }
         else
         {
             util::Log(logDEBUG) << "Using internal memory with algorithm "
                                 << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(config.storage_config);
+            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(
+                config.storage_config, config.rtree_leaf_advice);
         }
     }
 
@@ -133,11 +151,59 @@ template <typename Algorithm> class Engine final : public EngineInterface
         return match_plugin.HandleRequest(GetAlgorithms(params), params, result);
     }
 
+    // Traces are matched on the TBB work-stealing scheduler. The query heaps in
+    // SearchEngineData are thread-local, so every worker searches on its own heaps.
+    // Live traces of the same vehicle are matched by one task in the order they were given,
+    // otherwise their points would be appended in whatever order the tasks happen to run.
+    void Match(const std::vector<api::MatchParameters> &params,
+               const MatchResultHandler &on_result) const override final
+    {
+        std::vector<std::vector<std::size_t>> tasks;
+        std::unordered_map<std::string, std::size_t> vehicle_tasks;
+        for (std::size_t index = 0; index < params.size(); ++index)
+        {
+            const auto &vehicle = params[index].vehicle;
+            if (vehicle.empty())
+            {
+                tasks.push_back({index});
+                continue;
+            }
+
+            const auto task = vehicle_tasks.emplace(vehicle, tasks.size());
+            if (task.second)
+            {
+                tasks.emplace_back();
+            }
+            tasks[task.first->second].push_back(index);
+        }
+
+        std::mutex on_result_mutex;
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, tasks.size(), 1),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              for (auto task = range.begin(); task != range.end(); ++task)
+                              {
+                                  for (const auto index : tasks[task])
+                                  {
+                                      util::json::Object result;
+                                      const auto status = Match(params[index], result);
+
+                                      std::lock_guard<std::mutex> lock(on_result_mutex);
+                                      on_result(index, status, result);
+                                  }
+                              }
+                          });
+    }
+
     Status Tile(const api::TileParameters &params, std::string &result) const override final
     {
         return tile_plugin.HandleRequest(GetAlgorithms(params), params, result);
     }
 
+    unsigned GetDatasetGeneration() const override final
+    {
+        return facade_provider->Get(api::BaseParameters{})->GetDatasetGeneration();
+    }
+
     static bool CheckCompatibility(const EngineConfig &config);
 
   private:
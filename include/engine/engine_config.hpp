@@ -29,6 +29,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define ENGINE_CONFIG_HPP
 
 #include "storage/storage_config.hpp"
+#include "util/mmap_advice.hpp"
 
 #include <boost/filesystem/path.hpp>
 
@@ -51,10 +52,15 @@ namespace engine
  *  - Route
  *  - Table
  *  - Match
- *  - Nearest
+ *  - Nearest (results per coordinate and coordinates per batch request)
  *
  * In addition, shared memory can be used for datasets loaded with osrm-datastore.
  *
+ * The r-tree leaves (.fileIndex) are memory mapped from disk. By default their pages are loaded
+ * lazily, rtree_leaf_advice can be used to load them eagerly on startup, back them by huge pages
+ * or read ahead sibling leaves during nearest neighbour queries. The advice is ignored if
+ * osrm-datastore --embed-rtree-leaves loaded the leaves into shared memory.
+ *
  * You can chose between three algorithms:
  *  - Algorithm::CH
  *      Contraction Hierarchies, extremely fast queries but slow pre-processing. The default right
@@ -85,8 +91,13 @@ struct EngineConfig final
     int max_locations_distance_table = -1;
     int max_locations_map_matching = -1;
     int max_results_nearest = -1;
-    int max_alternatives = 3; // set an arbitrary upper bound; can be adjusted by user
+    int max_locations_nearest = -1;
+    int max_alternatives = 3;             // set an arbitrary upper bound; can be adjusted by user
+    int max_trip_search_time = 100;       // milliseconds spent improving a trip, 0 disables
+    int max_tile_cache_size = 32;         // megabytes of encoded tiles, 0 disables the cache
+    boost::filesystem::path tile_archive; // tiles pre-rendered by osrm-tiles
     bool use_shared_memory = true;
+    util::MMapAdvice rtree_leaf_advice;
     Algorithm algorithm = Algorithm::CH;
     std::string verbosity;
 };
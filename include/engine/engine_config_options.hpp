@@ -0,0 +1,38 @@
+#ifndef OSRM_ENGINE_ENGINE_CONFIG_OPTIONS_HPP
+#define OSRM_ENGINE_ENGINE_CONFIG_OPTIONS_HPP
+
+#include "engine/engine_config.hpp"
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+
+#include "osrm/error_codes.hpp"
+
+#include <boost/algorithm/string/case_conv.hpp>
+
+#include <istream>
+#include <string>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Reads the algorithm of the --algorithm option of osrm-routed and osrm-tiles
+inline std::istream &operator>>(std::istream &in, EngineConfig::Algorithm &algorithm)
+{
+    std::string token;
+    in >> token;
+    boost::to_lower(token);
+
+    if (token == "ch" || token == "corech")
+        algorithm = EngineConfig::Algorithm::CH;
+    else if (token == "mld")
+        algorithm = EngineConfig::Algorithm::MLD;
+    else
+        throw util::RuntimeError(token, ErrorCode::UnknownAlgorithm, SOURCE_REF);
+    return in;
+}
+}
+}
+
+#endif // OSRM_ENGINE_ENGINE_CONFIG_OPTIONS_HPP
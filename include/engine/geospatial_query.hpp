@@ -5,7 +5,9 @@
 #include "engine/phantom_node.hpp"
 #include "util/bearing.hpp"
 #include "util/coordinate_calculation.hpp"
+#include "util/integer_range.hpp"
 #include "util/rectangle.hpp"
+#include "util/static_grid.hpp"
 #include "util/typedefs.hpp"
 #include "util/web_mercator.hpp"
 
@@ -13,7 +15,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -28,17 +34,24 @@ inline std::pair<bool, bool> boolPairAnd(const std::pair<bool, bool> &A,
 }
 
 // Implements complex queries on top of an RTree and builds PhantomNodes from it.
+// If a spatial grid is given, nearest neighbour queries try it before the RTree.
 //
-// Only holds a weak reference on the RTree and coordinates!
-template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
+// Only holds a weak reference on the RTree, grid and coordinates!
+template <typename RTreeT,
+          typename DataFacadeT,
+          typename GridT = util::StaticGridView<typename RTreeT::EdgeData>>
+class GeospatialQuery
 {
     using EdgeData = typename RTreeT::EdgeData;
     using CoordinateList = typename RTreeT::CoordinateList;
     using CandidateSegment = typename RTreeT::CandidateSegment;
 
   public:
-    GeospatialQuery(RTreeT &rtree_, const CoordinateList &coordinates_, DataFacadeT &datafacade_)
-        : rtree(rtree_), coordinates(coordinates_), datafacade(datafacade_)
+    GeospatialQuery(RTreeT &rtree_,
+                    const CoordinateList &coordinates_,
+                    DataFacadeT &datafacade_,
+                    const GridT *grid_ = nullptr)
+        : rtree(rtree_), coordinates(coordinates_), datafacade(datafacade_), grid(grid_)
     {
     }
 
@@ -54,7 +67,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                                const double max_distance,
                                const Approach approach) const
     {
-        auto results = rtree.Nearest(
+        auto results = Nearest(
             input_coordinate,
             [this, approach, &input_coordinate](const CandidateSegment &segment) {
                 return boolPairAnd(boolPairAnd(HasValidEdge(segment), CheckSegmentExclude(segment)),
@@ -68,6 +81,76 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         return MakePhantomNodes(input_coordinate, results);
     }
 
+    // Returns the PhantomNodes within max_distances[i] of every coordinate of a trace, same
+    // as calling NearestPhantomNodesInRange for each of them.
+    // Consecutive points of a trace are close to each other. Instead of descending the RTree
+    // for each point, it is searched once for the bounding box of a run of points and the
+    // candidates of each point are picked from the segments found.
+    // Does not filter by small/big component!
+    std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodesInRange(const std::vector<util::Coordinate> &input_coordinates,
+                               const std::vector<double> &max_distances,
+                               const std::vector<Approach> &approaches) const
+    {
+        BOOST_ASSERT(input_coordinates.size() == max_distances.size());
+        BOOST_ASSERT(input_coordinates.size() == approaches.size());
+
+        std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(
+            input_coordinates.size());
+
+        std::size_t run_begin = 0;
+        while (run_begin < input_coordinates.size())
+        {
+            auto bbox = GetSearchBox(input_coordinates[run_begin], max_distances[run_begin]);
+            auto run_end = run_begin + 1;
+            for (; run_end < input_coordinates.size() && run_end - run_begin < MAX_TRACE_RUN_SIZE;
+                 ++run_end)
+            {
+                auto run_bbox = bbox;
+                run_bbox.MergeBoundingBoxes(
+                    GetSearchBox(input_coordinates[run_end], max_distances[run_end]));
+                // a run should not collect many segments that are far from all of its points
+                if (util::coordinate_calculation::haversineDistance(
+                        util::Coordinate{run_bbox.min_lon, run_bbox.min_lat},
+                        util::Coordinate{run_bbox.max_lon, run_bbox.max_lat}) >
+                    MAX_TRACE_RUN_DIAMETER)
+                {
+                    break;
+                }
+                bbox = run_bbox;
+            }
+
+            // every point of the run checks the same segments, they are projected only once
+            const auto segments = rtree.SearchInBox(bbox);
+            std::vector<ProjectedSegment> projected_segments;
+            projected_segments.reserve(segments.size());
+            for (const auto &data : segments)
+            {
+                const auto &u = coordinates[data.u];
+                const auto &v = coordinates[data.v];
+                projected_segments.push_back(
+                    {util::web_mercator::fromWGS84(u),
+                     util::web_mercator::fromWGS84(v),
+                     util::RectangleInt2D{std::min(u.lon, v.lon),
+                                          std::max(u.lon, v.lon),
+                                          std::min(u.lat, v.lat),
+                                          std::max(u.lat, v.lat)},
+                     data});
+            }
+
+            for (const auto index : util::irange<std::size_t>(run_begin, run_end))
+            {
+                phantom_nodes[index] = NearestPhantomNodesInRange(input_coordinates[index],
+                                                                  max_distances[index],
+                                                                  approaches[index],
+                                                                  projected_segments);
+            }
+            run_begin = run_end;
+        }
+
+        return phantom_nodes;
+    }
+
     // Returns nearest PhantomNodes in the given bearing range within max_distance.
     // Does not filter by small/big component!
     std::vector<PhantomNodeWithDistance>
@@ -77,7 +160,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                                const int bearing_range,
                                const Approach approach) const
     {
-        auto results = rtree.Nearest(
+        auto results = Nearest(
             input_coordinate,
             [this, approach, &input_coordinate, bearing, bearing_range, max_distance](
                 const CandidateSegment &segment) {
@@ -105,7 +188,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                         const int bearing_range,
                         const Approach approach) const
     {
-        auto results = rtree.Nearest(
+        auto results = Nearest(
             input_coordinate,
             [this, approach, &input_coordinate, bearing, bearing_range](
                 const CandidateSegment &segment) {
@@ -133,7 +216,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                         const int bearing_range,
                         const Approach approach) const
     {
-        auto results = rtree.Nearest(
+        auto results = Nearest(
             input_coordinate,
             [this, approach, &input_coordinate, bearing, bearing_range](
                 const CandidateSegment &segment) {
@@ -159,7 +242,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                         const unsigned max_results,
                         const Approach approach) const
     {
-        auto results = rtree.Nearest(
+        auto results = Nearest(
             input_coordinate,
             [this, approach, &input_coordinate](const CandidateSegment &segment) {
                 return boolPairAnd(boolPairAnd(HasValidEdge(segment), CheckSegmentExclude(segment)),
@@ -180,7 +263,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                         const double max_distance,
                         const Approach approach) const
     {
-        auto results = rtree.Nearest(
+        auto results = Nearest(
             input_coordinate,
             [this, approach, &input_coordinate](const CandidateSegment &segment) {
                 return boolPairAnd(boolPairAnd(HasValidEdge(segment), CheckSegmentExclude(segment)),
@@ -204,7 +287,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         bool has_small_component = false;
         bool has_big_component = false;
-        auto results = rtree.Nearest(
+        auto results = Nearest(
             input_coordinate,
             [this, approach, &input_coordinate, &has_big_component, &has_small_component](
                 const CandidateSegment &segment) {
@@ -230,7 +313,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                 const std::size_t num_results, const CandidateSegment &segment) {
                 return (num_results > 0 && has_big_component) ||
                        CheckSegmentDistance(input_coordinate, segment, max_distance);
-            });
+            },
+            [&has_small_component] { return has_small_component; });
 
         if (results.size() == 0)
         {
@@ -250,7 +334,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         bool has_small_component = false;
         bool has_big_component = false;
-        auto results = rtree.Nearest(
+        auto results = Nearest(
             input_coordinate,
             [this, approach, &input_coordinate, &has_big_component, &has_small_component](
                 const CandidateSegment &segment) {
@@ -275,7 +359,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
             },
             [&has_big_component](const std::size_t num_results, const CandidateSegment &) {
                 return num_results > 0 && has_big_component;
-            });
+            },
+            [&has_small_component] { return has_small_component; });
 
         if (results.size() == 0)
         {
@@ -297,7 +382,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         bool has_small_component = false;
         bool has_big_component = false;
-        auto results = rtree.Nearest(
+        auto results = Nearest(
             input_coordinate,
             [this,
              approach,
@@ -332,7 +417,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
             },
             [&has_big_component](const std::size_t num_results, const CandidateSegment &) {
                 return num_results > 0 && has_big_component;
-            });
+            },
+            [&has_small_component] { return has_small_component; });
 
         if (results.size() == 0)
         {
@@ -355,7 +441,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         bool has_small_component = false;
         bool has_big_component = false;
-        auto results = rtree.Nearest(
+        auto results = Nearest(
             input_coordinate,
             [this,
              approach,
@@ -392,7 +478,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                 const std::size_t num_results, const CandidateSegment &segment) {
                 return (num_results > 0 && has_big_component) ||
                        CheckSegmentDistance(input_coordinate, segment, max_distance);
-            });
+            },
+            [&has_small_component] { return has_small_component; });
 
         if (results.size() == 0)
         {
@@ -405,6 +492,190 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     }
 
   private:
+    // Upper bounds for the runs of trace points that share one RTree search
+    static constexpr std::size_t MAX_TRACE_RUN_SIZE = 32;
+    static constexpr double MAX_TRACE_RUN_DIAMETER = 500.;
+
+    // Box around the coordinate that contains everything within max_distance
+    util::RectangleInt2D GetSearchBox(const util::Coordinate input_coordinate,
+                                      const double max_distance) const
+    {
+        using namespace util::coordinate_calculation::detail;
+
+        // leave some slack for the difference between haversine and spherical distances
+        const double lat_delta = 1.1 * max_distance / EARTH_RADIUS * RAD_TO_DEGREE;
+        const double lat = static_cast<double>(util::toFloating(input_coordinate.lat));
+        const double lon = static_cast<double>(util::toFloating(input_coordinate.lon));
+        const double lon_delta = lat_delta / std::max(0.01, std::cos(degToRad(lat)));
+
+        return util::RectangleInt2D{util::FloatLongitude{std::max(-180., lon - lon_delta)},
+                                    util::FloatLongitude{std::min(180., lon + lon_delta)},
+                                    util::FloatLatitude{std::max(-90., lat - lat_delta)},
+                                    util::FloatLatitude{std::min(90., lat + lat_delta)}};
+    }
+
+    // A segment of a trace run with its projected end points and its bounding box
+    struct ProjectedSegment
+    {
+        util::FloatCoordinate projected_u;
+        util::FloatCoordinate projected_v;
+        util::RectangleInt2D bbox;
+        EdgeData data;
+    };
+
+    // Same as NearestPhantomNodesInRange, but only considers the given segments
+    std::vector<PhantomNodeWithDistance>
+    NearestPhantomNodesInRange(const util::Coordinate input_coordinate,
+                               const double max_distance,
+                               const Approach approach,
+                               const std::vector<ProjectedSegment> &segments) const
+    {
+        const auto projected_coordinate = util::web_mercator::fromWGS84(input_coordinate);
+        const util::Coordinate fixed_projected_coordinate{projected_coordinate};
+        // segments outside of it are too far away, as for the r-tree search of the run
+        const auto search_box = GetSearchBox(input_coordinate, max_distance);
+
+        std::vector<std::pair<std::uint64_t, EdgeData>> candidates;
+        for (const auto &projected_segment : segments)
+        {
+            if (!search_box.Intersects(projected_segment.bbox))
+            {
+                continue;
+            }
+            const auto &data = projected_segment.data;
+
+            util::FloatCoordinate projected_nearest;
+            std::tie(std::ignore, projected_nearest) =
+                util::coordinate_calculation::projectPointOnSegment(projected_segment.projected_u,
+                                                                    projected_segment.projected_v,
+                                                                    projected_coordinate);
+
+            const CandidateSegment segment{util::Coordinate{projected_nearest}, data};
+            if (CheckSegmentDistance(input_coordinate, segment, max_distance))
+            {
+                continue;
+            }
+
+            const auto use_segment =
+                boolPairAnd(boolPairAnd(HasValidEdge(segment), CheckSegmentExclude(segment)),
+                            CheckApproach(input_coordinate, segment, approach));
+            if (!use_segment.first && !use_segment.second)
+            {
+                continue;
+            }
+
+            auto edge_data = data;
+            edge_data.forward_segment_id.enabled &= use_segment.first;
+            edge_data.reverse_segment_id.enabled &= use_segment.second;
+            candidates.emplace_back(util::coordinate_calculation::squaredEuclideanDistance(
+                                        fixed_projected_coordinate, projected_nearest),
+                                    std::move(edge_data));
+        }
+
+        // same order as the RTree returns them
+        std::stable_sort(candidates.begin(),
+                         candidates.end(),
+                         [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+
+        std::vector<EdgeData> results(candidates.size());
+        std::transform(candidates.begin(),
+                       candidates.end(),
+                       results.begin(),
+                       [](const auto &candidate) { return candidate.second; });
+
+        return MakePhantomNodes(input_coordinate, results);
+    }
+
+    // Same contract as RTreeT::Nearest. Candidates from the grid cell that are closer than
+    // the cell border are processed first, as no segment outside of the cell can be closer.
+    // If that does not terminate the search the r-tree continues it, skipping everything
+    // already seen.
+    template <typename FilterT, typename TerminationT>
+    std::vector<EdgeData> Nearest(const util::Coordinate input_coordinate,
+                                  const FilterT filter,
+                                  const TerminationT terminate) const
+    {
+        return Nearest(input_coordinate, filter, terminate, [] { return false; });
+    }
+
+    template <typename FilterT, typename TerminationT, typename BigComponentsOnlyT>
+    std::vector<EdgeData> Nearest(const util::Coordinate input_coordinate,
+                                  const FilterT filter,
+                                  const TerminationT terminate,
+                                  const BigComponentsOnlyT only_big_components) const
+    {
+        if (grid == nullptr || grid->Empty())
+        {
+            return rtree.Nearest(input_coordinate, filter, terminate, only_big_components);
+        }
+
+        const auto projected_coordinate = util::web_mercator::fromWGS84(input_coordinate);
+        const util::Coordinate fixed_projected_coordinate{projected_coordinate};
+        const auto cell = grid->GetCell(fixed_projected_coordinate);
+
+        std::vector<std::pair<std::uint64_t, CandidateSegment>> candidates;
+        for (const auto &entry : cell.entries)
+        {
+            const auto projected_u = util::web_mercator::fromWGS84(entry.u);
+            const auto projected_v = util::web_mercator::fromWGS84(entry.v);
+
+            util::FloatCoordinate projected_nearest;
+            std::tie(std::ignore, projected_nearest) =
+                util::coordinate_calculation::projectPointOnSegment(
+                    projected_u, projected_v, projected_coordinate);
+
+            const auto squared_distance = util::coordinate_calculation::squaredEuclideanDistance(
+                fixed_projected_coordinate, projected_nearest);
+            if (squared_distance < cell.squared_radius)
+            {
+                candidates.push_back(std::make_pair(
+                    squared_distance,
+                    CandidateSegment{util::Coordinate{projected_nearest}, entry.data}));
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.first < rhs.first;
+        });
+
+        std::vector<EdgeData> results;
+        for (const auto &candidate : candidates)
+        {
+            if (terminate(results.size(), candidate.second))
+            {
+                return results;
+            }
+
+            const auto use_segment = filter(candidate.second);
+            if (!use_segment.first && !use_segment.second)
+            {
+                continue;
+            }
+            auto edge_data = candidate.second.data;
+            edge_data.forward_segment_id.enabled &= use_segment.first;
+            edge_data.reverse_segment_id.enabled &= use_segment.second;
+            results.push_back(std::move(edge_data));
+        }
+
+        const auto is_seen = [&](const CandidateSegment &segment) {
+            return util::coordinate_calculation::squaredEuclideanDistance(
+                       fixed_projected_coordinate, segment.fixed_projected_coordinate) <
+                   cell.squared_radius;
+        };
+        const auto num_seen_results = results.size();
+        auto remaining_results = rtree.Nearest(
+            input_coordinate,
+            [&](const CandidateSegment &segment) {
+                return is_seen(segment) ? std::make_pair(false, false) : filter(segment);
+            },
+            [&](const std::size_t num_results, const CandidateSegment &segment) {
+                return !is_seen(segment) && terminate(num_seen_results + num_results, segment);
+            },
+            only_big_components);
+        results.insert(results.end(), remaining_results.begin(), remaining_results.end());
+
+        return results;
+    }
+
     std::vector<PhantomNodeWithDistance>
     MakePhantomNodes(const util::Coordinate input_coordinate,
                      const std::vector<EdgeData> &results) const
@@ -661,6 +932,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     const RTreeT &rtree;
     const CoordinateList &coordinates;
     DataFacadeT &datafacade;
+    const GridT *grid;
 };
 }
 }
@@ -39,6 +39,10 @@ inline LegGeometry assembleGeometry(const datafacade::BaseDataFacade &facade,
                                     const bool reversed_target)
 {
     LegGeometry geometry;
+    // every path point adds at most one location, plus source and target
+    geometry.locations.reserve(leg_data.size() + 2);
+    geometry.osm_node_ids.reserve(leg_data.size() + 2);
+    geometry.annotations.reserve(leg_data.size() + 1);
 
     // segment 0 first and last
     geometry.segment_offsets.push_back(0);
@@ -142,6 +146,67 @@ inline LegGeometry assembleGeometry(const datafacade::BaseDataFacade &facade,
 
     return geometry;
 }
+
+// Only the OSM node ids of the leg, same as assembleGeometry(...).osm_node_ids but without
+// computing locations and annotations
+inline std::vector<OSMNodeID> assembleNodeIds(const datafacade::BaseDataFacade &facade,
+                                              const std::vector<PathData> &leg_data,
+                                              const PhantomNode &source_node,
+                                              const PhantomNode &target_node,
+                                              const bool reversed_source,
+                                              const bool reversed_target)
+{
+    std::vector<OSMNodeID> osm_node_ids;
+    osm_node_ids.reserve(leg_data.size() + 2);
+
+    const auto source_segment_start_coordinate =
+        source_node.fwd_segment_position + (reversed_source ? 1 : 0);
+    const auto source_node_id =
+        reversed_source ? source_node.reverse_segment_id.id : source_node.forward_segment_id.id;
+    const auto source_geometry_id = facade.GetGeometryIndex(source_node_id).id;
+    const auto source_geometry = facade.GetUncompressedForwardGeometry(source_geometry_id);
+    osm_node_ids.push_back(
+        facade.GetOSMNodeIDOfNode(source_geometry[source_segment_start_coordinate]));
+
+    for (const auto &path_point : leg_data)
+    {
+        const auto osm_node_id = facade.GetOSMNodeIDOfNode(path_point.turn_via_node);
+        if (osm_node_id != osm_node_ids.back())
+        {
+            osm_node_ids.push_back(osm_node_id);
+        }
+    }
+
+    const auto target_segment_end_coordinate =
+        target_node.fwd_segment_position + (reversed_target ? 0 : 1);
+    const auto target_node_id =
+        reversed_target ? target_node.reverse_segment_id.id : target_node.forward_segment_id.id;
+    const auto target_geometry_id = facade.GetGeometryIndex(target_node_id).id;
+    const auto target_geometry = facade.GetUncompressedForwardGeometry(target_geometry_id);
+    osm_node_ids.push_back(
+        facade.GetOSMNodeIDOfNode(target_geometry[target_segment_end_coordinate]));
+
+    return osm_node_ids;
+}
+
+// Appends the node ids of a leg to the ones of the previous legs. Consecutive legs meet at the
+// phantom node of their waypoint and both list the two nodes of its segment. If the leg leaves
+// in the direction the previous leg arrived in, it repeats both of them. After a U-turn at the
+// waypoint it only repeats the node the previous leg ended at.
+inline void appendLegNodeIds(std::vector<OSMNodeID> &osm_node_ids,
+                             const std::vector<OSMNodeID> &leg_osm_node_ids,
+                             const bool reversed_previous_target,
+                             const bool reversed_source)
+{
+    const std::size_t overlap =
+        osm_node_ids.empty() ? 0 : (reversed_previous_target == reversed_source ? 2 : 1);
+    BOOST_ASSERT(overlap <= osm_node_ids.size() && overlap <= leg_osm_node_ids.size());
+    BOOST_ASSERT(
+        std::equal(osm_node_ids.end() - overlap, osm_node_ids.end(), leg_osm_node_ids.begin()));
+
+    osm_node_ids.insert(
+        osm_node_ids.end(), leg_osm_node_ids.begin() + overlap, leg_osm_node_ids.end());
+}
 }
 }
 }
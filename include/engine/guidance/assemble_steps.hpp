@@ -70,8 +70,9 @@ inline std::vector<RouteStep> assembleSteps(const datafacade::BaseDataFacade &fa
 
     const auto number_of_segments = leg_geometry.GetNumberOfSegments();
 
+    // a step per segment and the arrive step
     std::vector<RouteStep> steps;
-    steps.reserve(number_of_segments);
+    steps.reserve(number_of_segments + 1);
 
     std::size_t segment_index = 0;
     BOOST_ASSERT(leg_geometry.locations.size() >= 2);
@@ -127,11 +128,11 @@ inline std::vector<RouteStep> assembleSteps(const datafacade::BaseDataFacade &fa
                 intersection.classes = facade.GetClasses(path_point.classes);
 
                 steps.push_back(RouteStep{step_name_id,
-                                          name.to_string(),
-                                          ref.to_string(),
-                                          pronunciation.to_string(),
-                                          destinations.to_string(),
-                                          exits.to_string(),
+                                          name,
+                                          ref,
+                                          pronunciation,
+                                          destinations,
+                                          exits,
                                           NO_ROTARY_NAME,
                                           NO_ROTARY_NAME,
                                           segment_duration / 10.,
@@ -182,6 +183,7 @@ inline std::vector<RouteStep> assembleSteps(const datafacade::BaseDataFacade &fa
                           bearing_data.end(),
                           std::back_inserter(intersection.bearings));
                 intersection.entry.clear();
+                intersection.entry.reserve(intersection.bearings.size());
                 for (auto idx : util::irange<std::size_t>(0, intersection.bearings.size()))
                 {
                     intersection.entry.push_back(path_point.entry_class.allowsEntry(idx));
@@ -206,11 +208,11 @@ inline std::vector<RouteStep> assembleSteps(const datafacade::BaseDataFacade &fa
         intersection.classes = facade.GetClasses(facade.GetClassData(target_node_id));
         BOOST_ASSERT(duration >= 0);
         steps.push_back(RouteStep{step_name_id,
-                                  facade.GetNameForID(step_name_id).to_string(),
-                                  facade.GetRefForID(step_name_id).to_string(),
-                                  facade.GetPronunciationForID(step_name_id).to_string(),
-                                  facade.GetDestinationsForID(step_name_id).to_string(),
-                                  facade.GetExitsForID(step_name_id).to_string(),
+                                  facade.GetNameForID(step_name_id),
+                                  facade.GetRefForID(step_name_id),
+                                  facade.GetPronunciationForID(step_name_id),
+                                  facade.GetDestinationsForID(step_name_id),
+                                  facade.GetExitsForID(step_name_id),
                                   NO_ROTARY_NAME,
                                   NO_ROTARY_NAME,
                                   duration / 10.,
@@ -249,11 +251,11 @@ inline std::vector<RouteStep> assembleSteps(const datafacade::BaseDataFacade &fa
         const EdgeWeight duration = std::max(0, target_duration - source_duration);
 
         steps.push_back(RouteStep{source_name_id,
-                                  facade.GetNameForID(source_name_id).to_string(),
-                                  facade.GetRefForID(source_name_id).to_string(),
-                                  facade.GetPronunciationForID(source_name_id).to_string(),
-                                  facade.GetDestinationsForID(source_name_id).to_string(),
-                                  facade.GetExitsForID(source_name_id).to_string(),
+                                  facade.GetNameForID(source_name_id),
+                                  facade.GetRefForID(source_name_id),
+                                  facade.GetPronunciationForID(source_name_id),
+                                  facade.GetDestinationsForID(source_name_id),
+                                  facade.GetExitsForID(source_name_id),
                                   NO_ROTARY_NAME,
                                   NO_ROTARY_NAME,
                                   duration / 10.,
@@ -290,11 +292,11 @@ inline std::vector<RouteStep> assembleSteps(const datafacade::BaseDataFacade &fa
 
     BOOST_ASSERT(!leg_geometry.locations.empty());
     steps.push_back(RouteStep{target_name_id,
-                              facade.GetNameForID(target_name_id).to_string(),
-                              facade.GetRefForID(target_name_id).to_string(),
-                              facade.GetPronunciationForID(target_name_id).to_string(),
-                              facade.GetDestinationsForID(target_name_id).to_string(),
-                              facade.GetExitsForID(target_name_id).to_string(),
+                              facade.GetNameForID(target_name_id),
+                              facade.GetRefForID(target_name_id),
+                              facade.GetPronunciationForID(target_name_id),
+                              facade.GetDestinationsForID(target_name_id),
+                              facade.GetExitsForID(target_name_id),
                               NO_ROTARY_NAME,
                               NO_ROTARY_NAME,
                               ZERO_DURATION,
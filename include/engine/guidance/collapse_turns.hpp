@@ -4,6 +4,7 @@
 #include "util/attributes.hpp"
 
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -133,7 +134,7 @@ void combineRouteSteps(RouteStep &step_at_turn_location,
     lane_strategy(step_at_turn_location, step_after_turn_location);
 
     // further stuff should happen here as well
-    step_at_turn_location.ElongateBy(step_after_turn_location);
+    step_at_turn_location.ElongateBy(std::move(step_after_turn_location));
     step_after_turn_location.Invalidate();
 }
 
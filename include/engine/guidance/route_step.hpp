@@ -6,11 +6,13 @@
 #include "util/coordinate.hpp"
 #include "util/guidance/bearing_class.hpp"
 #include "util/guidance/entry_class.hpp"
+#include "util/string_view.hpp"
 
 #include "extractor/guidance/turn_lane_types.hpp"
 #include "util/guidance/turn_lanes.hpp"
 
 #include <cstddef>
+#include <iterator>
 #include <string>
 #include <vector>
 
@@ -60,13 +62,14 @@ inline IntermediateIntersection getInvalidIntersection()
 struct RouteStep
 {
     unsigned name_id;
-    std::string name;
-    std::string ref;
-    std::string pronunciation;
-    std::string destinations;
-    std::string exits;
-    std::string rotary_name;
-    std::string rotary_pronunciation;
+    // views into the name table of the facade, only copied when the step is rendered
+    util::StringView name;
+    util::StringView ref;
+    util::StringView pronunciation;
+    util::StringView destinations;
+    util::StringView exits;
+    util::StringView rotary_name;
+    util::StringView rotary_pronunciation;
     double duration; // duration in seconds
     double distance; // distance in meters
     double weight;   // weight value
@@ -88,6 +91,9 @@ struct RouteStep
     // Elongate by another step in back
     RouteStep &ElongateBy(const RouteStep &following_step);
 
+    // Elongate by another step in back that is invalidated afterwards, moves its intersections
+    RouteStep &ElongateBy(RouteStep &&following_step);
+
     /* Elongate without prior knowledge of in front, or in back, convenience function if you
      * don't know if step is augmented in front or at the back */
     RouteStep &MergeWith(const RouteStep &by_step);
@@ -167,6 +173,23 @@ inline RouteStep &RouteStep::ElongateBy(const RouteStep &following_step)
     return *this;
 }
 
+// Elongate by another step in back, taking over its intersections
+inline RouteStep &RouteStep::ElongateBy(RouteStep &&following_step)
+{
+    BOOST_ASSERT(geometry_end == following_step.geometry_begin + 1);
+    BOOST_ASSERT(mode == following_step.mode);
+    duration += following_step.duration;
+    distance += following_step.distance;
+    weight += following_step.weight;
+
+    geometry_end = following_step.geometry_end;
+    intersections.insert(intersections.end(),
+                         std::make_move_iterator(following_step.intersections.begin()),
+                         std::make_move_iterator(following_step.intersections.end()));
+
+    return *this;
+}
+
 // Elongate without prior knowledge of in front, or in back.
 inline RouteStep &RouteStep::MergeWith(const RouteStep &by_step)
 {
@@ -18,6 +18,9 @@ struct SubMatching
     std::vector<unsigned> indices;
     std::vector<unsigned> alternatives_count;
     double confidence;
+    // Number of leading nodes that are matched the same way no matter
+    // which points are appended to the trace
+    unsigned converged_nodes;
 };
 }
 }
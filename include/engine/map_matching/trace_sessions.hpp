@@ -0,0 +1,154 @@
+#ifndef OSRM_ENGINE_MAP_MATCHING_TRACE_SESSIONS_HPP
+#define OSRM_ENGINE_MAP_MATCHING_TRACE_SESSIONS_HPP
+
+#include "engine/phantom_node.hpp"
+#include "util/coordinate.hpp"
+
+#include <boost/optional.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace map_matching
+{
+
+// Tail of a live trace that is not finally matched yet
+struct TraceSession
+{
+    std::vector<util::Coordinate> coordinates;
+    std::vector<unsigned> timestamps;
+    std::vector<boost::optional<double>> radiuses;
+    // Candidate the first point was finally matched to by an earlier request
+    boost::optional<PhantomNodeWithDistance> anchor;
+    // Checksum of the dataset the anchor was snapped on
+    unsigned checksum = 0;
+};
+
+// Thread-safe store of live trace sessions by vehicle id. Once there are more than
+// max_sessions the least recently used session is dropped.
+class TraceSessions
+{
+  public:
+    // Exclusive access to the session of one vehicle. The session goes back into the store
+    // when the handle is destroyed, also if the request fails on the way.
+    class Handle
+    {
+      public:
+        Handle(Handle &&other)
+            : store(other.store), id(std::move(other.id)), session(std::move(other.session))
+        {
+            other.store = nullptr;
+        }
+        Handle(const Handle &) = delete;
+        Handle &operator=(const Handle &) = delete;
+        Handle &operator=(Handle &&) = delete;
+
+        ~Handle()
+        {
+            if (store)
+            {
+                store->Put(id, std::move(session));
+            }
+        }
+
+        TraceSession &operator*() { return session; }
+        TraceSession *operator->() { return &session; }
+
+      private:
+        friend class TraceSessions;
+
+        Handle(TraceSessions &store, std::string id, TraceSession session)
+            : store(&store), id(std::move(id)), session(std::move(session))
+        {
+        }
+
+        TraceSessions *store;
+        std::string id;
+        TraceSession session;
+    };
+
+    explicit TraceSessions(const std::size_t max_sessions) : max_sessions(max_sessions) {}
+
+    // Removes the session from the store while it is updated, unknown ids get an empty
+    // session. Requests for the same id are serialised: Take waits until the handle of the
+    // previous request is gone, so no points are lost to a concurrent update.
+    Handle Take(const std::string &id)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        returned.wait(lock, [&] { return taken.count(id) == 0; });
+        taken.insert(id);
+
+        TraceSession session;
+        const auto iter = index.find(id);
+        if (iter != index.end())
+        {
+            session = std::move(iter->second->second);
+            sessions.erase(iter->second);
+            index.erase(iter);
+        }
+        return Handle{*this, id, std::move(session)};
+    }
+
+    std::size_t Size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return sessions.size();
+    }
+
+  private:
+    void Put(const std::string &id, TraceSession session)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        taken.erase(id);
+        returned.notify_all();
+
+        const auto iter = index.find(id);
+        if (iter != index.end())
+        {
+            sessions.erase(iter->second);
+            index.erase(iter);
+        }
+
+        // nothing pending, an unknown id gets the same empty session
+        if (session.coordinates.empty() && !session.anchor)
+        {
+            return;
+        }
+
+        sessions.emplace_front(id, std::move(session));
+        index.emplace(id, sessions.begin());
+
+        while (sessions.size() > max_sessions)
+        {
+            index.erase(sessions.back().first);
+            sessions.pop_back();
+        }
+    }
+
+    using SessionList = std::list<std::pair<std::string, TraceSession>>;
+
+    const std::size_t max_sessions;
+    mutable std::mutex mutex;
+    // most recently used session first
+    SessionList sessions;
+    std::unordered_map<std::string, SessionList::iterator> index;
+    // ids with a live handle, Take waits on returned until they are put back
+    std::unordered_set<std::string> taken;
+    std::condition_variable returned;
+};
+}
+}
+}
+
+#endif // OSRM_ENGINE_MAP_MATCHING_TRACE_SESSIONS_HPP
@@ -0,0 +1,192 @@
+#ifndef OSRM_ENGINE_MAP_MATCHING_TRANSITION_CACHE_HPP
+#define OSRM_ENGINE_MAP_MATCHING_TRANSITION_CACHE_HPP
+
+#include "engine/datafacade.hpp"
+#include "engine/phantom_node.hpp"
+#include "engine/search_engine_data.hpp"
+#include "util/coordinate.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/functional/hash.hpp>
+#include <boost/optional.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace map_matching
+{
+
+// Network distances of the transitions computed so far in a request. Traces of standing
+// vehicles repeat the same candidates for many timestamps, so the same transitions are asked
+// for again, usually with a different weight upper bound.
+class TransitionCache
+{
+  public:
+    // Returns the cached distance if it was computed between the same snapped locations and
+    // with an upper bound that gives the same answer as weight_upper_bound
+    boost::optional<double>
+    Find(const PhantomNode &source, const PhantomNode &target, const EdgeWeight weight_upper_bound)
+    {
+        ++lookups;
+
+        const auto entry = entries.find(MakeKey(source, target));
+        if (entry == entries.end() || entry->second.source_location != source.location ||
+            entry->second.target_location != target.location)
+        {
+            return boost::none;
+        }
+
+        // A path found below a bound stays the shortest one for every larger bound, a target
+        // that was out of reach stays out of reach for every smaller bound.
+        const bool found = entry->second.distance != std::numeric_limits<double>::max();
+        if (found ? weight_upper_bound < entry->second.weight_upper_bound
+                  : weight_upper_bound > entry->second.weight_upper_bound)
+        {
+            return boost::none;
+        }
+
+        ++hits;
+        return entry->second.distance;
+    }
+
+    void Insert(const PhantomNode &source,
+                const PhantomNode &target,
+                const EdgeWeight weight_upper_bound,
+                const double distance)
+    {
+        entries[MakeKey(source, target)] =
+            Entry{source.location, target.location, weight_upper_bound, distance};
+    }
+
+    // Network distances from every source to every target in row-major order, like
+    // getNetworkDistances. Sources with a transition missing from the cache are searched
+    // together and their distances are stored.
+    template <typename Algorithm>
+    std::vector<double>
+    GetNetworkDistances(SearchEngineData<Algorithm> &engine_working_data,
+                        const DataFacade<Algorithm> &facade,
+                        typename SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                        typename SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                        const std::vector<PhantomNode> &source_phantoms,
+                        const std::vector<PhantomNode> &target_phantoms,
+                        const EdgeWeight weight_upper_bound)
+    {
+        const auto number_of_targets = target_phantoms.size();
+        std::vector<double> distances(source_phantoms.size() * number_of_targets);
+
+        std::vector<std::size_t> missing_rows;
+        std::vector<PhantomNode> missing_sources;
+        for (std::size_t row = 0; row < source_phantoms.size(); ++row)
+        {
+            bool complete = true;
+            for (std::size_t column = 0; column < number_of_targets; ++column)
+            {
+                const auto cached =
+                    Find(source_phantoms[row], target_phantoms[column], weight_upper_bound);
+                complete = complete && cached;
+                distances[row * number_of_targets + column] = cached.value_or(0);
+            }
+
+            if (!complete)
+            {
+                missing_rows.push_back(row);
+                missing_sources.push_back(source_phantoms[row]);
+            }
+        }
+
+        if (missing_sources.empty())
+        {
+            return distances;
+        }
+
+        const auto computed_distances = getNetworkDistances(engine_working_data,
+                                                            facade,
+                                                            forward_heap,
+                                                            reverse_heap,
+                                                            missing_sources,
+                                                            target_phantoms,
+                                                            weight_upper_bound);
+        for (std::size_t index = 0; index < missing_rows.size(); ++index)
+        {
+            const auto row = missing_rows[index];
+            for (std::size_t column = 0; column < number_of_targets; ++column)
+            {
+                const auto distance = computed_distances[index * number_of_targets + column];
+                distances[row * number_of_targets + column] = distance;
+                Insert(source_phantoms[row], target_phantoms[column], weight_upper_bound, distance);
+            }
+        }
+
+        return distances;
+    }
+
+    std::size_t GetHits() const { return hits; }
+    std::size_t GetLookups() const { return lookups; }
+
+  private:
+    // Candidates are told apart by the directed segments they can be left or reached on
+    struct Key
+    {
+        NodeID source_forward;
+        NodeID source_reverse;
+        NodeID target_forward;
+        NodeID target_reverse;
+
+        bool operator==(const Key &other) const
+        {
+            return source_forward == other.source_forward &&
+                   source_reverse == other.source_reverse &&
+                   target_forward == other.target_forward && target_reverse == other.target_reverse;
+        }
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key &key) const
+        {
+            std::size_t seed = 0;
+            boost::hash_combine(seed, key.source_forward);
+            boost::hash_combine(seed, key.source_reverse);
+            boost::hash_combine(seed, key.target_forward);
+            boost::hash_combine(seed, key.target_reverse);
+            return seed;
+        }
+    };
+
+    // The distance runs between the snapped locations, so it is only valid for them
+    struct Entry
+    {
+        util::Coordinate source_location;
+        util::Coordinate target_location;
+        EdgeWeight weight_upper_bound;
+        double distance;
+    };
+
+    static NodeID GetSegment(const SegmentID segment)
+    {
+        return segment.enabled ? segment.id : SPECIAL_SEGMENTID;
+    }
+
+    static Key MakeKey(const PhantomNode &source, const PhantomNode &target)
+    {
+        return {GetSegment(source.forward_segment_id),
+                GetSegment(source.reverse_segment_id),
+                GetSegment(target.forward_segment_id),
+                GetSegment(target.reverse_segment_id)};
+    }
+
+    std::unordered_map<Key, Entry, KeyHash> entries;
+    std::size_t hits = 0;
+    std::size_t lookups = 0;
+};
+}
+}
+}
+
+#endif // OSRM_ENGINE_MAP_MATCHING_TRANSITION_CACHE_HPP
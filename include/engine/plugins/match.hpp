@@ -2,11 +2,13 @@
 #define MATCH_HPP
 
 #include "engine/api/match_parameters.hpp"
+#include "engine/map_matching/trace_sessions.hpp"
 #include "engine/plugins/plugin_base.hpp"
 #include "engine/routing_algorithms.hpp"
 
 #include "util/json_util.hpp"
 
+#include <cstddef>
 #include <vector>
 
 namespace osrm
@@ -23,9 +25,13 @@ class MatchPlugin : public BasePlugin
     using SubMatchingList = routing_algorithms::SubMatchingList;
     using CandidateLists = routing_algorithms::CandidateLists;
     static const constexpr double RADIUS_MULTIPLIER = 3;
+    // Bounds the state kept for live traces: the number of vehicles and the number of
+    // points of a vehicle that are not finally matched yet
+    static const constexpr std::size_t MAX_LIVE_TRACES = 100000;
+    static const constexpr std::size_t MAX_LIVE_TRACE_POINTS = 100;
 
     MatchPlugin(const int max_locations_map_matching)
-        : max_locations_map_matching(max_locations_map_matching)
+        : max_locations_map_matching(max_locations_map_matching), live_traces(MAX_LIVE_TRACES)
     {
     }
 
@@ -34,7 +40,12 @@ class MatchPlugin : public BasePlugin
                          util::json::Object &json_result) const;
 
   private:
+    Status HandleLiveTraceRequest(const RoutingAlgorithmsInterface &algorithms,
+                                  const api::MatchParameters &parameters,
+                                  util::json::Object &json_result) const;
+
     const int max_locations_map_matching;
+    mutable map_matching::TraceSessions live_traces;
 };
 }
 }
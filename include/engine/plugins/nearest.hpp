@@ -17,14 +17,19 @@ namespace plugins
 class NearestPlugin final : public BasePlugin
 {
   public:
-    explicit NearestPlugin(const int max_results);
+    NearestPlugin(const int max_results, const int max_locations = -1);
 
     Status HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                          const api::NearestParameters &params,
                          util::json::Object &result) const;
 
   private:
+    Status HandleBatchRequest(const datafacade::BaseDataFacade &facade,
+                              const api::NearestParameters &params,
+                              util::json::Object &result) const;
+
     const int max_results;
+    const int max_locations;
 };
 }
 }
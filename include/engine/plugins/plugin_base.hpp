@@ -148,6 +148,19 @@ class BasePlugin
         const bool use_bearings = !parameters.bearings.empty();
         const bool use_approaches = !parameters.approaches.empty();
 
+        // without per-point hints and bearings the whole trace is snapped in one go
+        if (!use_hints && !use_bearings)
+        {
+            std::vector<Approach> approaches(parameters.coordinates.size(),
+                                             engine::Approach::UNRESTRICTED);
+            for (const auto i : util::irange<std::size_t>(0UL, parameters.approaches.size()))
+            {
+                if (parameters.approaches[i])
+                    approaches[i] = parameters.approaches[i].get();
+            }
+            return facade.NearestPhantomNodesInRange(parameters.coordinates, radiuses, approaches);
+        }
+
         for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
         {
             Approach approach = engine::Approach::UNRESTRICTED;
@@ -183,72 +196,82 @@ class BasePlugin
         return phantom_nodes;
     }
 
-    std::vector<std::vector<PhantomNodeWithDistance>>
-    GetPhantomNodes(const datafacade::BaseDataFacade &facade,
-                    const api::BaseParameters &parameters,
-                    unsigned number_of_results) const
+    // Snaps the coordinate at index, taking its hint, bearing, radius and approach into account
+    std::vector<PhantomNodeWithDistance>
+    GetPhantomNodesForCoordinate(const datafacade::BaseDataFacade &facade,
+                                 const api::BaseParameters &parameters,
+                                 const std::size_t index,
+                                 unsigned number_of_results) const
     {
-        std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(
-            parameters.coordinates.size());
-
         const bool use_hints = !parameters.hints.empty();
         const bool use_bearings = !parameters.bearings.empty();
         const bool use_radiuses = !parameters.radiuses.empty();
         const bool use_approaches = !parameters.approaches.empty();
 
-        BOOST_ASSERT(parameters.IsValid());
-        for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
+        Approach approach = engine::Approach::UNRESTRICTED;
+        if (use_approaches && parameters.approaches[index])
+            approach = parameters.approaches[index].get();
+
+        if (use_hints && parameters.hints[index] &&
+            parameters.hints[index]->IsValid(parameters.coordinates[index], facade))
         {
-            Approach approach = engine::Approach::UNRESTRICTED;
-            if (use_approaches && parameters.approaches[i])
-                approach = parameters.approaches[i].get();
+            return {PhantomNodeWithDistance{
+                parameters.hints[index]->phantom,
+                util::coordinate_calculation::haversineDistance(
+                    parameters.coordinates[index], parameters.hints[index]->phantom.location),
+            }};
+        }
 
-            if (use_hints && parameters.hints[i] &&
-                parameters.hints[i]->IsValid(parameters.coordinates[i], facade))
+        if (use_bearings && parameters.bearings[index])
+        {
+            if (use_radiuses && parameters.radiuses[index])
             {
-                phantom_nodes[i].push_back(PhantomNodeWithDistance{
-                    parameters.hints[i]->phantom,
-                    util::coordinate_calculation::haversineDistance(
-                        parameters.coordinates[i], parameters.hints[i]->phantom.location),
-                });
-                continue;
+                return facade.NearestPhantomNodes(parameters.coordinates[index],
+                                                  number_of_results,
+                                                  *parameters.radiuses[index],
+                                                  parameters.bearings[index]->bearing,
+                                                  parameters.bearings[index]->range,
+                                                  approach);
             }
-
-            if (use_bearings && parameters.bearings[i])
+            else
             {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_nodes[i] = facade.NearestPhantomNodes(parameters.coordinates[i],
-                                                                  number_of_results,
-                                                                  *parameters.radiuses[i],
-                                                                  parameters.bearings[i]->bearing,
-                                                                  parameters.bearings[i]->range,
-                                                                  approach);
-                }
-                else
-                {
-                    phantom_nodes[i] = facade.NearestPhantomNodes(parameters.coordinates[i],
-                                                                  number_of_results,
-                                                                  parameters.bearings[i]->bearing,
-                                                                  parameters.bearings[i]->range,
-                                                                  approach);
-                }
+                return facade.NearestPhantomNodes(parameters.coordinates[index],
+                                                  number_of_results,
+                                                  parameters.bearings[index]->bearing,
+                                                  parameters.bearings[index]->range,
+                                                  approach);
+            }
+        }
+        else
+        {
+            if (use_radiuses && parameters.radiuses[index])
+            {
+                return facade.NearestPhantomNodes(parameters.coordinates[index],
+                                                  number_of_results,
+                                                  *parameters.radiuses[index],
+                                                  approach);
             }
             else
             {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_nodes[i] = facade.NearestPhantomNodes(parameters.coordinates[i],
-                                                                  number_of_results,
-                                                                  *parameters.radiuses[i],
-                                                                  approach);
-                }
-                else
-                {
-                    phantom_nodes[i] = facade.NearestPhantomNodes(
-                        parameters.coordinates[i], number_of_results, approach);
-                }
+                return facade.NearestPhantomNodes(
+                    parameters.coordinates[index], number_of_results, approach);
             }
+        }
+    }
+
+    std::vector<std::vector<PhantomNodeWithDistance>>
+    GetPhantomNodes(const datafacade::BaseDataFacade &facade,
+                    const api::BaseParameters &parameters,
+                    unsigned number_of_results) const
+    {
+        std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(
+            parameters.coordinates.size());
+
+        BOOST_ASSERT(parameters.IsValid());
+        for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
+        {
+            phantom_nodes[i] =
+                GetPhantomNodesForCoordinate(facade, parameters, i, number_of_results);
 
             // we didn't find a fitting node, return error
             if (phantom_nodes[i].empty())
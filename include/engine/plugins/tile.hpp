@@ -4,7 +4,16 @@
 #include "engine/api/tile_parameters.hpp"
 #include "engine/plugins/plugin_base.hpp"
 #include "engine/routing_algorithms.hpp"
+#include "engine/tile_archive.hpp"
+#include "engine/tile_cache.hpp"
 
+#include "extractor/road_overview.hpp"
+#include "storage/storage_config.hpp"
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -15,6 +24,14 @@
  * to display maps that show the exact road network that
  * OSRM is routing.  This is very useful for debugging routing
  * errors
+ *
+ * Encoded tiles are kept in a cache that is flushed whenever a different
+ * dataset is loaded. Tiles pre-rendered by osrm-tiles are served from their
+ * archive if it was made for the dataset and weights that are currently
+ * loaded.
+ *
+ * Tiles of low zoom levels only show the speeds on the road overview
+ * built by osrm-extract --road-overview.
  */
 namespace osrm
 {
@@ -25,7 +42,17 @@ namespace plugins
 
 class TilePlugin final : public BasePlugin
 {
+  private:
+    mutable TileCache cache;
+    TileArchive archive;
+    std::uint64_t weights_fingerprint;
+    extractor::RoadOverview overview;
+
   public:
+    TilePlugin(const std::size_t max_cache_bytes,
+               const boost::filesystem::path &archive_path,
+               const storage::StorageConfig &storage_config);
+
     Status HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                          const api::TileParameters &parameters,
                          std::string &pbf_buffer) const;
@@ -11,6 +11,7 @@
 #include <boost/assert.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <iterator>
 #include <memory>
@@ -29,6 +30,7 @@ class TripPlugin final : public BasePlugin
 {
   private:
     const int max_locations_trip;
+    const std::chrono::milliseconds max_search_time;
 
     InternalRouteResult ComputeRoute(const RoutingAlgorithmsInterface &algorithms,
                                      const std::vector<PhantomNode> &phantom_node_list,
@@ -36,7 +38,10 @@ class TripPlugin final : public BasePlugin
                                      const bool roundtrip) const;
 
   public:
-    explicit TripPlugin(const int max_locations_trip_) : max_locations_trip(max_locations_trip_) {}
+    TripPlugin(const int max_locations_trip_, const int max_search_time_ms)
+        : max_locations_trip(max_locations_trip_), max_search_time(max_search_time_ms)
+    {
+    }
 
     Status HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                          const api::TripParameters &parameters,
@@ -14,9 +14,11 @@ namespace engine
 {
 namespace detail
 {
+// zig-zag encodes the deltas in place and writes them into a string of the exact size
 std::string encode(std::vector<int> &numbers);
-std::int32_t decode_polyline_integer(std::string::const_iterator &first,
-                                     std::string::const_iterator last);
+// upper bound of the number of integers in an encoded polyline
+std::size_t count_polyline_integers(const char *first, const char *last);
+std::int32_t decode_polyline_integer(const char *&first, const char *last);
 }
 using CoordVectorForwardIter = std::vector<util::Coordinate>::const_iterator;
 // Encodes geometry into polyline format.
@@ -32,25 +34,20 @@ std::string encodePolyline(CoordVectorForwardIter begin, CoordVectorForwardIter
         return {};
     }
 
-    std::vector<int> delta_numbers;
     BOOST_ASSERT(size > 0);
-    delta_numbers.reserve((size - 1) * 2);
+    std::vector<int> delta_numbers(size * 2);
+    auto delta = delta_numbers.begin();
     int current_lat = 0;
     int current_lon = 0;
-    std::for_each(
-        begin,
-        end,
-        [&delta_numbers, &current_lat, &current_lon, coordinate_to_polyline](
-            const util::Coordinate loc) {
-            const int lat_diff =
-                std::round(static_cast<int>(loc.lat) * coordinate_to_polyline) - current_lat;
-            const int lon_diff =
-                std::round(static_cast<int>(loc.lon) * coordinate_to_polyline) - current_lon;
-            delta_numbers.emplace_back(lat_diff);
-            delta_numbers.emplace_back(lon_diff);
-            current_lat += lat_diff;
-            current_lon += lon_diff;
-        });
+    for (auto iter = begin; iter != end; ++iter)
+    {
+        const int lat = std::round(static_cast<int>(iter->lat) * coordinate_to_polyline);
+        const int lon = std::round(static_cast<int>(iter->lon) * coordinate_to_polyline);
+        *delta++ = lat - current_lat;
+        *delta++ = lon - current_lon;
+        current_lat = lat;
+        current_lon = lon;
+    }
     return detail::encode(delta_numbers);
 }
 
@@ -64,8 +61,9 @@ std::vector<util::Coordinate> decodePolyline(const std::string &polyline)
     std::vector<util::Coordinate> coordinates;
     std::int32_t latitude = 0, longitude = 0;
 
-    std::string::const_iterator first = polyline.begin();
-    const std::string::const_iterator last = polyline.end();
+    const char *first = polyline.data();
+    const char *const last = polyline.data() + polyline.size();
+    coordinates.reserve((detail::count_polyline_integers(first, last) + 1) / 2);
     while (first != last)
     {
         const auto dlat = detail::decode_polyline_integer(first, last);
@@ -374,6 +374,18 @@ double getNetworkDistance(SearchEngineData<Algorithm> &engine_working_data,
                           const PhantomNode &target_phantom,
                           int duration_upper_bound = INVALID_EDGE_WEIGHT);
 
+// Network distances from every source to every target in row-major order. Runs one backward
+// search per target and one forward search per source, all pruned at weight_upper_bound,
+// instead of a bidirectional search per pair. Unreachable targets have a distance of
+// std::numeric_limits<double>::max().
+std::vector<double> getNetworkDistances(SearchEngineData<Algorithm> &engine_working_data,
+                                        const DataFacade<ch::Algorithm> &facade,
+                                        SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                                        SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                                        const std::vector<PhantomNode> &source_phantoms,
+                                        const std::vector<PhantomNode> &target_phantoms,
+                                        EdgeWeight weight_upper_bound = INVALID_EDGE_WEIGHT);
+
 } // namespace ch
 } // namespace routing_algorithms
 } // namespace engine
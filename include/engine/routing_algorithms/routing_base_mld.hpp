@@ -65,6 +65,40 @@ inline bool checkParentCellRestriction(CellID cell, LevelID, CellID parent)
 {
     return cell == parent;
 }
+
+// One-to-many search (Args is OneToManyPhantomNodes):
+//   * use the lowest query level of the node with respect to the source and any target
+//   * allow to traverse all cells
+struct OneToManyPhantomNodes
+{
+    const PhantomNode &source_phantom;
+    const std::vector<PhantomNode> &target_phantoms;
+};
+
+template <typename MultiLevelPartition>
+inline LevelID getNodeQueryLevel(const MultiLevelPartition &partition,
+                                 NodeID node,
+                                 const OneToManyPhantomNodes &phantom_nodes)
+{
+    auto level = [&partition, node](const PhantomNode &phantom_node) {
+        auto highest_different_level = [&partition, node](const SegmentID &segment) {
+            if (segment.enabled)
+                return partition.GetHighestDifferentLevel(segment.id, node);
+            return INVALID_LEVEL_ID;
+        };
+        return std::min(highest_different_level(phantom_node.forward_segment_id),
+                        highest_different_level(phantom_node.reverse_segment_id));
+    };
+
+    auto result = level(phantom_nodes.source_phantom);
+    for (const auto &target_phantom : phantom_nodes.target_phantoms)
+    {
+        result = std::min(result, level(target_phantom));
+    }
+    return result;
+}
+
+inline bool checkParentCellRestriction(CellID, const OneToManyPhantomNodes &) { return true; }
 }
 
 // Heaps only record for each node its predecessor ("parent") on the shortest path.
@@ -279,6 +313,19 @@ using UnpackedNodes = std::vector<NodeID>;
 using UnpackedEdges = std::vector<EdgeID>;
 using UnpackedPath = std::tuple<EdgeWeight, UnpackedNodes, UnpackedEdges>;
 
+template <typename Algorithm, typename... Args>
+void unpackPackedPath(SearchEngineData<Algorithm> &engine_working_data,
+                      const DataFacade<Algorithm> &facade,
+                      typename SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                      typename SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                      const bool force_loop_forward,
+                      const bool force_loop_reverse,
+                      const PackedPath &packed_path,
+                      const NodeID middle,
+                      UnpackedNodes &unpacked_nodes,
+                      UnpackedEdges &unpacked_edges,
+                      Args... args);
+
 template <typename Algorithm, typename... Args>
 UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
                     const DataFacade<Algorithm> &facade,
@@ -294,8 +341,6 @@ UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
         return std::make_tuple(INVALID_EDGE_WEIGHT, std::vector<NodeID>(), std::vector<EdgeID>());
     }
 
-    const auto &partition = facade.GetMultiLevelPartition();
-
     BOOST_ASSERT(!forward_heap.Empty() && forward_heap.MinKey() < INVALID_EDGE_WEIGHT);
     BOOST_ASSERT(!reverse_heap.Empty() && reverse_heap.MinKey() < INVALID_EDGE_WEIGHT);
 
@@ -344,13 +389,45 @@ UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
     // Get packed path as edges {from node ID, to node ID, from_clique_arc}
     auto packed_path = retrievePackedPathFromHeap(forward_heap, reverse_heap, middle);
 
+    std::vector<NodeID> unpacked_nodes;
+    std::vector<EdgeID> unpacked_edges;
+    unpackPackedPath(engine_working_data,
+                     facade,
+                     forward_heap,
+                     reverse_heap,
+                     force_loop_forward,
+                     force_loop_reverse,
+                     packed_path,
+                     middle,
+                     unpacked_nodes,
+                     unpacked_edges,
+                     args...);
+
+    return std::make_tuple(weight, std::move(unpacked_nodes), std::move(unpacked_edges));
+}
+
+// Unpacks the overlay clique edges of a packed path down to the base graph.
+// The heaps are reused for the searches on the lower levels.
+template <typename Algorithm, typename... Args>
+void unpackPackedPath(SearchEngineData<Algorithm> &engine_working_data,
+                      const DataFacade<Algorithm> &facade,
+                      typename SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                      typename SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                      const bool force_loop_forward,
+                      const bool force_loop_reverse,
+                      const PackedPath &packed_path,
+                      const NodeID middle,
+                      UnpackedNodes &unpacked_nodes,
+                      UnpackedEdges &unpacked_edges,
+                      Args... args)
+{
+    const auto &partition = facade.GetMultiLevelPartition();
+
     // Beware the edge case when start, middle, end are all the same.
     // In this case we return a single node, no edges. We also don't unpack.
     const NodeID source_node = !packed_path.empty() ? std::get<0>(packed_path.front()) : middle;
 
     // Unpack path
-    std::vector<NodeID> unpacked_nodes;
-    std::vector<EdgeID> unpacked_edges;
     unpacked_nodes.reserve(packed_path.size());
     unpacked_edges.reserve(packed_path.size());
 
@@ -403,8 +480,6 @@ UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
             unpacked_edges.insert(unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
         }
     }
-
-    return std::make_tuple(weight, std::move(unpacked_nodes), std::move(unpacked_edges));
 }
 
 // Alias to be compatible with the CH-based search
@@ -501,6 +576,160 @@ double getNetworkDistance(SearchEngineData<Algorithm> &engine_working_data,
     return getPathDistance(facade, unpacked_path, source_phantom, target_phantom);
 }
 
+// Network distances from every source to every target in row-major order. Runs one forward
+// search per source that is pruned at weight_upper_bound, instead of a bidirectional search
+// per pair. Unreachable targets have a distance of std::numeric_limits<double>::max().
+template <typename Algorithm>
+std::vector<double>
+getNetworkDistances(SearchEngineData<Algorithm> &engine_working_data,
+                    const DataFacade<Algorithm> &facade,
+                    typename SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                    typename SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                    const std::vector<PhantomNode> &source_phantoms,
+                    const std::vector<PhantomNode> &target_phantoms,
+                    EdgeWeight weight_upper_bound = INVALID_EDGE_WEIGHT)
+{
+    const auto number_of_targets = target_phantoms.size();
+    std::vector<double> distances(source_phantoms.size() * number_of_targets,
+                                  std::numeric_limits<double>::max());
+
+    // Target nodes sorted by node id, with the column and the weight to the target phantom
+    std::vector<std::tuple<NodeID, std::size_t, EdgeWeight>> target_nodes;
+    for (std::size_t column = 0; column < number_of_targets; ++column)
+    {
+        const auto &target = target_phantoms[column];
+        if (target.IsValidForwardTarget())
+            target_nodes.emplace_back(
+                target.forward_segment_id.id, column, target.GetForwardWeightPlusOffset());
+        if (target.IsValidReverseTarget())
+            target_nodes.emplace_back(
+                target.reverse_segment_id.id, column, target.GetReverseWeightPlusOffset());
+    }
+    std::sort(target_nodes.begin(), target_nodes.end());
+
+    for (std::size_t row = 0; row < source_phantoms.size(); ++row)
+    {
+        const auto &source = source_phantoms[row];
+
+        forward_heap.Clear();
+        if (source.IsValidForwardSource())
+            forward_heap.Insert(source.forward_segment_id.id,
+                                -source.GetForwardWeightPlusOffset(),
+                                source.forward_segment_id.id);
+        if (source.IsValidReverseSource())
+            forward_heap.Insert(source.reverse_segment_id.id,
+                                -source.GetReverseWeightPlusOffset(),
+                                source.reverse_segment_id.id);
+
+        std::vector<EdgeWeight> weights(number_of_targets, weight_upper_bound);
+        std::vector<NodeID> middles(number_of_targets, SPECIAL_NODEID);
+        // A target behind the source on the same node is only reachable by a loop back
+        // to the already settled source node, these pairs use a bidirectional search.
+        std::vector<bool> needs_loop(number_of_targets, false);
+
+        // The search is done once the heap passes the weights of all open targets
+        const auto search_bound = [&] {
+            auto bound = std::numeric_limits<EdgeWeight>::min();
+            for (std::size_t column = 0; column < number_of_targets; ++column)
+            {
+                if (!needs_loop[column])
+                    bound = std::max(bound, weights[column]);
+            }
+            return bound;
+        };
+
+        const OneToManyPhantomNodes phantom_nodes{source, target_phantoms};
+        auto bound = search_bound();
+        while (!forward_heap.Empty() && forward_heap.MinKey() < bound)
+        {
+            const auto node = forward_heap.DeleteMin();
+            const auto weight = forward_heap.GetKey(node);
+
+            auto target = std::lower_bound(target_nodes.begin(),
+                                           target_nodes.end(),
+                                           std::make_tuple(node, std::size_t{0}, EdgeWeight{0}),
+                                           [](const auto &lhs, const auto &rhs) {
+                                               return std::get<0>(lhs) < std::get<0>(rhs);
+                                           });
+            for (; target != target_nodes.end() && std::get<0>(*target) == node; ++target)
+            {
+                const auto column = std::get<1>(*target);
+                const auto path_weight = weight + std::get<2>(*target);
+                if (path_weight < 0)
+                {
+                    needs_loop[column] = true;
+                }
+                else if (path_weight < weights[column])
+                {
+                    weights[column] = path_weight;
+                    middles[column] = node;
+                }
+                bound = search_bound();
+            }
+
+            relaxOutgoingEdges<FORWARD_DIRECTION>(
+                facade, forward_heap, node, weight, phantom_nodes);
+        }
+
+        // Retrieve all paths before the heaps are reused to unpack them
+        std::vector<PackedPath> packed_paths(number_of_targets);
+        for (std::size_t column = 0; column < number_of_targets; ++column)
+        {
+            if (!needs_loop[column] && middles[column] != SPECIAL_NODEID)
+            {
+                packed_paths[column] =
+                    retrievePackedPathFromSingleHeap<FORWARD_DIRECTION>(forward_heap,
+                                                                        middles[column]);
+                std::reverse(packed_paths[column].begin(), packed_paths[column].end());
+            }
+        }
+
+        for (std::size_t column = 0; column < number_of_targets; ++column)
+        {
+            const auto &target = target_phantoms[column];
+            auto &distance = distances[row * number_of_targets + column];
+
+            if (needs_loop[column])
+            {
+                distance = getNetworkDistance(engine_working_data,
+                                              facade,
+                                              forward_heap,
+                                              reverse_heap,
+                                              source,
+                                              target,
+                                              weight_upper_bound);
+                continue;
+            }
+
+            if (middles[column] == SPECIAL_NODEID)
+            {
+                continue;
+            }
+
+            std::vector<NodeID> unpacked_nodes;
+            std::vector<EdgeID> unpacked_edges;
+            unpackPackedPath(engine_working_data,
+                             facade,
+                             forward_heap,
+                             reverse_heap,
+                             DO_NOT_FORCE_LOOPS,
+                             DO_NOT_FORCE_LOOPS,
+                             packed_paths[column],
+                             middles[column],
+                             unpacked_nodes,
+                             unpacked_edges,
+                             phantom_nodes);
+
+            std::vector<PathData> unpacked_path;
+            annotatePath(facade, {source, target}, unpacked_nodes, unpacked_edges, unpacked_path);
+
+            distance = getPathDistance(facade, unpacked_path, source, target);
+        }
+    }
+
+    return distances;
+}
+
 } // namespace mld
 } // namespace routing_algorithms
 } // namespace engine
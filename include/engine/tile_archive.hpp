@@ -0,0 +1,212 @@
+#ifndef OSRM_ENGINE_TILE_ARCHIVE_HPP
+#define OSRM_ENGINE_TILE_ARCHIVE_HPP
+
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+#include "storage/storage_config.hpp"
+#include "util/mmap_file.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Identifies the weight files of a dataset by their sizes and modification times.
+// osrm-contract and osrm-customize rewrite them without changing the timestamp of the OSM data.
+inline std::uint64_t getWeightsFingerprint(const storage::StorageConfig &config)
+{
+    std::size_t fingerprint = 0;
+    for (const auto extension : {".osrm.geometry",
+                                 ".osrm.datasource_names",
+                                 ".osrm.turn_weight_penalties",
+                                 ".osrm.turn_duration_penalties",
+                                 ".osrm.hsgr",
+                                 ".osrm.cell_metrics"})
+    {
+        const auto path = config.GetPath(extension);
+        boost::system::error_code error;
+        const auto size = boost::filesystem::file_size(path, error);
+        const auto time = boost::filesystem::last_write_time(path, error);
+        if (!error)
+        {
+            boost::hash_combine(fingerprint, size);
+            boost::hash_combine(fingerprint, time);
+        }
+    }
+    return fingerprint;
+}
+
+// Pre-rendered tiles as written by osrm-tiles. The archive belongs to the dataset with the
+// given timestamp of its OSM data and generation of its weights, see
+// BaseDataFacade::GetDatasetGeneration. Archives rendered from the dataset files have the
+// generation 0, they also keep the weights fingerprint of the files. The index is sorted by zoom
+// level, x and y and points into the encoded tiles at the end of the file, which are mapped into
+// memory when reading.
+class TileArchive
+{
+  public:
+    struct Entry
+    {
+        std::uint32_t z;
+        std::uint32_t x;
+        std::uint32_t y;
+        std::uint32_t size;
+        std::uint64_t offset;
+
+        bool operator<(const Entry &other) const
+        {
+            return std::tie(z, x, y) < std::tie(other.z, other.x, other.y);
+        }
+    };
+
+    const std::string &GetTimestamp() const { return timestamp; }
+    unsigned GetDatasetGeneration() const { return generation; }
+    std::uint64_t GetWeightsFingerprint() const { return weights_fingerprint; }
+    std::size_t Size() const { return index.size(); }
+
+    boost::optional<std::string> Find(const unsigned z, const unsigned x, const unsigned y) const
+    {
+        const Entry key{z, x, y, 0, 0};
+        const auto iter = std::lower_bound(index.begin(), index.end(), key);
+        if (iter == index.end() || key < *iter)
+        {
+            return boost::none;
+        }
+        BOOST_ASSERT(iter->offset + iter->size <= data.size());
+        return std::string(data.data() + iter->offset, iter->size);
+    }
+
+    friend void readTileArchive(const boost::filesystem::path &path, TileArchive &archive);
+
+  private:
+    std::string timestamp;
+    std::uint32_t generation = 0;
+    std::uint64_t weights_fingerprint = 0;
+    std::vector<Entry> index;
+    boost::iostreams::mapped_file_source region;
+    util::vector_view<const char> data;
+};
+
+// Writes a tile archive without keeping the encoded tiles in memory. Tiles can be added in any
+// order and from several threads, they are appended to a temporary file next to the archive
+// which is copied behind the sorted index by Finish.
+class TileArchiveWriter
+{
+  public:
+    TileArchiveWriter(boost::filesystem::path path_,
+                      std::string timestamp_,
+                      const std::uint32_t generation_,
+                      const std::uint64_t weights_fingerprint_)
+        : path(std::move(path_)), data_path(path.string() + ".data"),
+          timestamp(std::move(timestamp_)), generation(generation_),
+          weights_fingerprint(weights_fingerprint_), data_size(0),
+          data_writer(std::make_unique<storage::io::FileWriter>(
+              data_path, storage::io::FileWriter::HasNoFingerprint))
+    {
+    }
+
+    ~TileArchiveWriter()
+    {
+        data_writer.reset();
+        boost::filesystem::remove(data_path);
+    }
+
+    void Add(const unsigned z, const unsigned x, const unsigned y, const std::string &tile)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        BOOST_ASSERT(data_writer);
+        index.push_back(Entry{z, x, y, static_cast<std::uint32_t>(tile.size()), data_size});
+        data_writer->WriteFrom(tile.data(), tile.size());
+        data_size += tile.size();
+    }
+
+    // writes the archive and returns the number of tiles in it
+    std::size_t Finish()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // flushes the encoded tiles
+        data_writer.reset();
+
+        std::sort(index.begin(), index.end());
+
+        storage::io::FileWriter writer{path, storage::io::FileWriter::GenerateFingerprint};
+        storage::serialization::write(writer,
+                                      std::vector<char>(timestamp.begin(), timestamp.end()));
+        writer.WriteOne(generation);
+        writer.WriteOne(weights_fingerprint);
+        storage::serialization::write(writer, index);
+
+        writer.WriteElementCount64(data_size);
+        storage::io::FileReader reader{data_path, storage::io::FileReader::HasNoFingerprint};
+        std::vector<char> buffer(1024 * 1024);
+        for (std::uint64_t copied = 0; copied < data_size; copied += buffer.size())
+        {
+            const auto count = std::min<std::uint64_t>(buffer.size(), data_size - copied);
+            reader.ReadInto(buffer.data(), count);
+            writer.WriteFrom(buffer.data(), count);
+        }
+
+        return index.size();
+    }
+
+  private:
+    using Entry = TileArchive::Entry;
+
+    const boost::filesystem::path path;
+    const boost::filesystem::path data_path;
+    const std::string timestamp;
+    const std::uint32_t generation;
+    const std::uint64_t weights_fingerprint;
+
+    std::mutex mutex;
+    std::vector<Entry> index;
+    std::uint64_t data_size;
+    std::unique_ptr<storage::io::FileWriter> data_writer;
+};
+
+// reads the header and index of a tile archive written by osrm-tiles and maps its tiles
+inline void readTileArchive(const boost::filesystem::path &path, TileArchive &archive)
+{
+    std::uint64_t data_size = 0;
+    {
+        const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+        storage::io::FileReader reader{path, fingerprint};
+
+        std::vector<char> timestamp;
+        storage::serialization::read(reader, timestamp);
+        archive.timestamp.assign(timestamp.begin(), timestamp.end());
+        archive.generation = reader.ReadOne<std::uint32_t>();
+        archive.weights_fingerprint = reader.ReadOne<std::uint64_t>();
+        storage::serialization::read(reader, archive.index);
+        data_size = reader.ReadElementCount64();
+    }
+
+    // the encoded tiles make up the rest of the file
+    const auto file = util::mmapFile<char>(path, archive.region);
+    if (data_size > file.size())
+    {
+        throw util::exception("Tile archive " + path.string() + " is truncated" + SOURCE_REF);
+    }
+    archive.data = util::vector_view<const char>(file.data() + file.size() - data_size,
+                                                 data_size);
+}
+}
+}
+
+#endif // OSRM_ENGINE_TILE_ARCHIVE_HPP
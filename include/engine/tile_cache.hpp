@@ -0,0 +1,138 @@
+#ifndef OSRM_ENGINE_TILE_CACHE_HPP
+#define OSRM_ENGINE_TILE_CACHE_HPP
+
+#include <boost/functional/hash.hpp>
+#include <boost/optional.hpp>
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+
+struct TileKey
+{
+    unsigned z;
+    unsigned x;
+    unsigned y;
+
+    bool operator==(const TileKey &other) const
+    {
+        return std::tie(z, x, y) == std::tie(other.z, other.x, other.y);
+    }
+};
+
+struct TileKeyHash
+{
+    std::size_t operator()(const TileKey &key) const
+    {
+        std::size_t seed = 0;
+        boost::hash_combine(seed, key.z);
+        boost::hash_combine(seed, key.x);
+        boost::hash_combine(seed, key.y);
+        return seed;
+    }
+};
+
+// Thread-safe cache of the encoded tiles of one dataset. Once the tiles take more than max_bytes
+// the least recently used ones are dropped, a cache of zero bytes stores nothing.
+//
+// Tiles are looked up with the generation of the dataset the request runs on. The cache is
+// flushed as soon as a different generation shows up, e.g. after osrm-datastore loaded new
+// weights, and tiles rendered from an older generation are not stored anymore.
+class TileCache
+{
+  public:
+    explicit TileCache(const std::size_t max_bytes)
+        : max_bytes(max_bytes), bytes(0), generation(0)
+    {
+    }
+
+    boost::optional<std::string> Get(const TileKey &key, const unsigned current_generation)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        SwitchGeneration(current_generation);
+
+        const auto iter = index.find(key);
+        if (iter == index.end())
+        {
+            return boost::none;
+        }
+
+        tiles.splice(tiles.begin(), tiles, iter->second);
+        return iter->second->second;
+    }
+
+    void Put(const TileKey &key, const unsigned tile_generation, const std::string &tile)
+    {
+        if (tile.size() > max_bytes)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tile_generation != generation)
+        {
+            return;
+        }
+
+        const auto iter = index.find(key);
+        if (iter != index.end())
+        {
+            bytes -= iter->second->second.size();
+            tiles.erase(iter->second);
+            index.erase(iter);
+        }
+
+        tiles.emplace_front(key, tile);
+        index.emplace(key, tiles.begin());
+        bytes += tile.size();
+
+        while (bytes > max_bytes)
+        {
+            bytes -= tiles.back().second.size();
+            index.erase(tiles.back().first);
+            tiles.pop_back();
+        }
+    }
+
+    std::size_t Size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return tiles.size();
+    }
+
+  private:
+    using TileList = std::list<std::pair<TileKey, std::string>>;
+
+    // needs the mutex to be held
+    void SwitchGeneration(const unsigned current_generation)
+    {
+        if (current_generation != generation)
+        {
+            tiles.clear();
+            index.clear();
+            bytes = 0;
+            generation = current_generation;
+        }
+    }
+
+    const std::size_t max_bytes;
+    mutable std::mutex mutex;
+    std::size_t bytes;
+    unsigned generation;
+    // most recently used tile first
+    TileList tiles;
+    std::unordered_map<TileKey, TileList::iterator, TileKeyHash> index;
+};
+}
+}
+
+#endif // OSRM_ENGINE_TILE_CACHE_HPP
@@ -0,0 +1,329 @@
+#ifndef TRIP_CONSTRAINED_HPP
+#define TRIP_CONSTRAINED_HPP
+
+#include "util/dist_table_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace trip
+{
+
+// pickup location that has to be visited before the delivery location
+using Precedence = std::pair<std::size_t, std::size_t>;
+
+namespace detail
+{
+// Trip that starts at a fixed location, optionally ends at a fixed location and either returns to
+// its start or not. Keeps the positions of all locations to check precedences without scanning.
+class ConstrainedRoute
+{
+  public:
+    ConstrainedRoute(const util::DistTableWrapper<EdgeWeight> &dist_table,
+                     const bool roundtrip,
+                     const bool fixed_end)
+        : dist_table(dist_table), roundtrip(roundtrip), fixed_end(fixed_end)
+    {
+    }
+
+    void Assign(std::vector<NodeID> route_)
+    {
+        route = std::move(route_);
+        positions.resize(route.size());
+        forward.resize(route.size());
+        backward.resize(route.size());
+        for (std::size_t position = 0; position < route.size(); ++position)
+        {
+            positions[route[position]] = position;
+            forward[position] =
+                position == 0 ? 0 : forward[position - 1] + Cost(route[position - 1],
+                                                                   route[position]);
+            backward[position] =
+                position == 0 ? 0 : backward[position - 1] + Cost(route[position],
+                                                                    route[position - 1]);
+        }
+    }
+
+    const std::vector<NodeID> &Nodes() const { return route; }
+
+    std::size_t Position(const NodeID node) const { return positions[node]; }
+
+    // last position whose location may be moved
+    std::size_t LastMovable() const { return route.size() - (fixed_end ? 2 : 1); }
+
+    // location that follows the given position, SPECIAL_NODEID at the end of a one-way trip
+    NodeID After(const std::size_t position) const
+    {
+        if (position + 1 < route.size())
+            return route[position + 1];
+        return roundtrip ? route.front() : SPECIAL_NODEID;
+    }
+
+    std::int64_t Cost(const NodeID from, const NodeID to) const
+    {
+        if (from == SPECIAL_NODEID || to == SPECIAL_NODEID)
+            return 0;
+        return dist_table(from, to);
+    }
+
+    std::int64_t Duration() const
+    {
+        return forward.back() + Cost(route.back(), After(route.size() - 1));
+    }
+
+    // change of the duration if the locations at positions first..last are visited in reverse
+    std::int64_t ReverseDelta(const std::size_t first, const std::size_t last) const
+    {
+        const auto before = route[first - 1];
+        const auto after = After(last);
+        return Cost(before, route[last]) + (backward[last] - backward[first]) +
+               Cost(route[first], after) - Cost(before, route[first]) -
+               (forward[last] - forward[first]) - Cost(route[last], after);
+    }
+
+    // change of the duration if the locations at positions first..last are moved behind the
+    // location at position target
+    std::int64_t MoveDelta(const std::size_t first,
+                           const std::size_t last,
+                           const std::size_t target) const
+    {
+        const auto before = route[first - 1];
+        const auto after = After(last);
+        return Cost(before, after) - Cost(before, route[first]) - Cost(route[last], after) +
+               Cost(route[target], route[first]) + Cost(route[last], After(target)) -
+               Cost(route[target], After(target));
+    }
+
+    std::vector<NodeID> Reversed(const std::size_t first, const std::size_t last) const
+    {
+        auto reversed = route;
+        std::reverse(reversed.begin() + first, reversed.begin() + last + 1);
+        return reversed;
+    }
+
+    std::vector<NodeID>
+    Moved(const std::size_t first, const std::size_t last, const std::size_t target) const
+    {
+        std::vector<NodeID> moved;
+        moved.reserve(route.size());
+        for (std::size_t position = 0; position < route.size(); ++position)
+        {
+            if (position < first || position > last)
+                moved.push_back(route[position]);
+            if (position == target)
+                moved.insert(moved.end(), route.begin() + first, route.begin() + last + 1);
+        }
+        return moved;
+    }
+
+  private:
+    const util::DistTableWrapper<EdgeWeight> &dist_table;
+    const bool roundtrip;
+    const bool fixed_end;
+    std::vector<NodeID> route;
+    std::vector<std::size_t> positions;
+    std::vector<std::int64_t> forward;
+    std::vector<std::int64_t> backward;
+};
+
+// Visits the nearest location whose pickups are all visited next. Returns an empty route if the
+// precedences contain a cycle.
+inline std::vector<NodeID> AvailableNearestNeighbourRoute(
+    const std::size_t number_of_locations,
+    const util::DistTableWrapper<EdgeWeight> &dist_table,
+    const NodeID start,
+    const NodeID end,
+    const std::vector<Precedence> &precedences)
+{
+    std::vector<std::vector<NodeID>> deliveries(number_of_locations);
+    std::vector<std::size_t> open_pickups(number_of_locations, 0);
+    for (const auto &precedence : precedences)
+    {
+        deliveries[precedence.first].push_back(precedence.second);
+        ++open_pickups[precedence.second];
+    }
+
+    std::vector<bool> visited(number_of_locations, false);
+    std::vector<NodeID> route;
+    route.reserve(number_of_locations);
+
+    auto visit = [&](const NodeID node) {
+        visited[node] = true;
+        route.push_back(node);
+        for (const auto delivery : deliveries[node])
+            --open_pickups[delivery];
+    };
+
+    visit(start);
+    const auto number_of_stops = number_of_locations - (end == SPECIAL_NODEID ? 0 : 1);
+    while (route.size() < number_of_stops)
+    {
+        NodeID next = SPECIAL_NODEID;
+        for (NodeID node = 0; node < number_of_locations; ++node)
+        {
+            if (visited[node] || node == end || open_pickups[node] > 0)
+                continue;
+            if (next == SPECIAL_NODEID ||
+                dist_table(route.back(), node) < dist_table(route.back(), next))
+                next = node;
+        }
+
+        if (next == SPECIAL_NODEID)
+            return {};
+        visit(next);
+    }
+
+    if (end != SPECIAL_NODEID)
+    {
+        if (open_pickups[end] > 0)
+            return {};
+        visit(end);
+    }
+
+    return route;
+}
+}
+
+// Finds a trip from start (to end, if given) that visits every pickup before its delivery and
+// takes at most max_duration. Builds the trip greedily and improves it with 2-opt and Or-opt
+// moves that keep the precedences for at most max_search_time. Returns an empty trip if no trip
+// fits the constraints; cyclic precedences and budgets below a lower bound fail before any search.
+inline std::vector<NodeID> ConstrainedTrip(const std::size_t number_of_locations,
+                                           const util::DistTableWrapper<EdgeWeight> &dist_table,
+                                           const NodeID start,
+                                           const NodeID end,
+                                           const bool roundtrip,
+                                           const std::vector<Precedence> &precedences,
+                                           const EdgeWeight max_duration,
+                                           const std::chrono::milliseconds max_search_time)
+{
+    BOOST_ASSERT(number_of_locations * number_of_locations == dist_table.size());
+    BOOST_ASSERT(start < number_of_locations);
+    BOOST_ASSERT(end == SPECIAL_NODEID || end < number_of_locations);
+
+    for (const auto &precedence : precedences)
+    {
+        if (precedence.second == start || precedence.first == end)
+            return {};
+    }
+
+    // every location but the start of a one-way trip is entered by at least its cheapest edge
+    std::int64_t lower_bound = 0;
+    for (NodeID to = 0; to < number_of_locations; ++to)
+    {
+        if (to == start && !roundtrip)
+            continue;
+        auto cheapest = std::numeric_limits<EdgeWeight>::max();
+        for (NodeID from = 0; from < number_of_locations; ++from)
+        {
+            if (from != to)
+                cheapest = std::min(cheapest, dist_table(from, to));
+        }
+        lower_bound += cheapest;
+    }
+    if (lower_bound > max_duration)
+    {
+        return {};
+    }
+
+    auto initial = detail::AvailableNearestNeighbourRoute(
+        number_of_locations, dist_table, start, end, precedences);
+    if (initial.empty())
+    {
+        return {};
+    }
+
+    detail::ConstrainedRoute route(dist_table, roundtrip, end != SPECIAL_NODEID);
+    route.Assign(std::move(initial));
+
+    // a reversed chain swaps the order of pairs inside of it
+    const auto reverse_keeps_precedences = [&](const std::size_t first, const std::size_t last) {
+        return std::none_of(
+            precedences.begin(), precedences.end(), [&](const Precedence &precedence) {
+                return route.Position(precedence.first) >= first &&
+                       route.Position(precedence.second) <= last;
+            });
+    };
+
+    // a chain moved forward passes the locations up to its target, a chain moved backward the
+    // locations behind its target
+    const auto move_keeps_precedences =
+        [&](const std::size_t first, const std::size_t last, const std::size_t target) {
+            return std::none_of(
+                precedences.begin(), precedences.end(), [&](const Precedence &precedence) {
+                    const auto pickup = route.Position(precedence.first);
+                    const auto delivery = route.Position(precedence.second);
+                    if (target > last)
+                        return pickup >= first && pickup <= last && delivery > last &&
+                               delivery <= target;
+                    return delivery >= first && delivery <= last && pickup > target &&
+                           pickup < first;
+                });
+        };
+
+    const std::size_t MAX_CHAIN_LENGTH = 3;
+    const auto deadline = std::chrono::steady_clock::now() + max_search_time;
+    bool improved = true;
+    while (improved && std::chrono::steady_clock::now() < deadline)
+    {
+        improved = false;
+        const auto last_movable = route.LastMovable();
+
+        for (std::size_t first = 1; !improved && first < last_movable; ++first)
+        {
+            for (std::size_t last = first + 1; !improved && last <= last_movable; ++last)
+            {
+                if (route.ReverseDelta(first, last) < 0 &&
+                    reverse_keeps_precedences(first, last))
+                {
+                    route.Assign(route.Reversed(first, last));
+                    improved = true;
+                }
+            }
+        }
+
+        for (std::size_t length = 1; !improved && length <= MAX_CHAIN_LENGTH; ++length)
+        {
+            for (std::size_t first = 1; !improved && first + length - 1 <= last_movable; ++first)
+            {
+                const auto last = first + length - 1;
+                for (std::size_t target = 0; !improved && target <= last_movable; ++target)
+                {
+                    if (target + 1 >= first && target <= last)
+                        continue;
+                    if (route.MoveDelta(first, last, target) < 0 &&
+                        move_keeps_precedences(first, last, target))
+                    {
+                        route.Assign(route.Moved(first, last, target));
+                        improved = true;
+                    }
+                }
+            }
+        }
+    }
+
+    if (route.Duration() > max_duration)
+    {
+        return {};
+    }
+
+    return route.Nodes();
+}
+
+} // namespace trip
+} // namespace engine
+} // namespace osrm
+
+#endif // TRIP_CONSTRAINED_HPP
@@ -7,6 +7,9 @@
 #include "osrm/json_container.hpp"
 #include <boost/assert.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_reduce.h>
+
 #include <algorithm>
 #include <cstdlib>
 #include <limits>
@@ -75,6 +78,24 @@ GetShortestRoundTrip(const NodeID new_loc,
     return std::make_pair(min_trip_distance, next_insert_point_candidate);
 }
 
+// unvisited locations whose insertion is evaluated by one task
+const constexpr std::size_t INSERTION_GRAIN_SIZE = 16;
+
+// unvisited location whose best insertion makes the trip the longest
+struct InsertionCandidate
+{
+    EdgeWeight distance;
+    NodeID node;
+    NodeIDIter insert_point;
+
+    // the smallest id wins ties so the trip does not depend on how the work was split
+    bool IsFartherThan(const InsertionCandidate &other) const
+    {
+        return other.node == SPECIAL_NODEID || distance > other.distance ||
+               (distance == other.distance && node < other.node);
+    }
+};
+
 // given two initial start nodes, find a roundtrip route using the farthest insertion algorithm
 inline std::vector<NodeID> FindRoute(const std::size_t &number_of_locations,
                                      const util::DistTableWrapper<EdgeWeight> &dist_table,
@@ -98,38 +119,47 @@ inline std::vector<NodeID> FindRoute(const std::size_t &number_of_locations,
     // two nodes are already in the initial start trip, so we need to add all other nodes
     for (std::size_t added_nodes = 2; added_nodes < number_of_locations; ++added_nodes)
     {
-        auto farthest_distance = std::numeric_limits<int>::min();
-        auto next_node = -1;
-        NodeIDIter next_insert_point;
-
-        // find unvisited node that is the farthest away from all other visited locs
-        for (std::size_t id = 0; id < number_of_locations; ++id)
-        {
-            // find the shortest distance from i to all visited nodes
-            if (!visited[id])
-            {
-                const auto insert_candidate =
-                    GetShortestRoundTrip(id, dist_table, number_of_locations, route);
-
-                BOOST_ASSERT_MSG(insert_candidate.first != INVALID_EDGE_WEIGHT,
-                                 "shortest round trip is invalid");
-
-                // add the location to the current trip such that it results in the shortest total
-                // tour
-                if (insert_candidate.first > farthest_distance)
+        const InsertionCandidate none{std::numeric_limits<EdgeWeight>::min(), SPECIAL_NODEID, {}};
+
+        // find unvisited node that is the farthest away from all other visited locs, the
+        // candidates are evaluated concurrently as this is quadratic in the number of locations
+        const auto farthest = tbb::parallel_reduce(
+            tbb::blocked_range<std::size_t>(0, number_of_locations, INSERTION_GRAIN_SIZE),
+            none,
+            [&](const tbb::blocked_range<std::size_t> &range, InsertionCandidate farthest) {
+                for (auto id = range.begin(); id != range.end(); ++id)
                 {
-                    farthest_distance = insert_candidate.first;
-                    next_node = id;
-                    next_insert_point = insert_candidate.second;
+                    // find the shortest distance from i to all visited nodes
+                    if (visited[id])
+                        continue;
+
+                    const auto insert_candidate =
+                        GetShortestRoundTrip(id, dist_table, number_of_locations, route);
+
+                    BOOST_ASSERT_MSG(insert_candidate.first != INVALID_EDGE_WEIGHT,
+                                     "shortest round trip is invalid");
+
+                    // add the location to the current trip such that it results in the shortest
+                    // total tour
+                    const InsertionCandidate candidate{insert_candidate.first,
+                                                       static_cast<NodeID>(id),
+                                                       insert_candidate.second};
+                    if (candidate.IsFartherThan(farthest))
+                    {
+                        farthest = candidate;
+                    }
                 }
-            }
-        }
+                return farthest;
+            },
+            [](const InsertionCandidate &lhs, const InsertionCandidate &rhs) {
+                return rhs.IsFartherThan(lhs) ? rhs : lhs;
+            });
 
-        BOOST_ASSERT_MSG(next_node >= 0, "next node to visit is invalid");
+        BOOST_ASSERT_MSG(farthest.node != SPECIAL_NODEID, "next node to visit is invalid");
 
         // mark as visited and insert node
-        visited[next_node] = true;
-        route.insert(next_insert_point, next_node);
+        visited[farthest.node] = true;
+        route.insert(farthest.insert_point, farthest.node);
     }
     return route;
 }
@@ -0,0 +1,170 @@
+#ifndef TRIP_LOCAL_SEARCH_HPP
+#define TRIP_LOCAL_SEARCH_HPP
+
+#include "util/dist_table_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace trip
+{
+
+namespace detail
+{
+// Costs of the path along the route positions 0..n-1 in forward and in backward direction, used
+// to price the reversal of a sub path in O(1) on an asymmetric table.
+struct RoutePrefixSums
+{
+    std::vector<std::int64_t> forward;
+    std::vector<std::int64_t> backward;
+
+    void Update(const std::vector<NodeID> &route,
+                const util::DistTableWrapper<EdgeWeight> &dist_table)
+    {
+        forward.resize(route.size());
+        backward.resize(route.size());
+        forward[0] = backward[0] = 0;
+        for (std::size_t position = 1; position < route.size(); ++position)
+        {
+            forward[position] =
+                forward[position - 1] + dist_table(route[position - 1], route[position]);
+            backward[position] =
+                backward[position - 1] + dist_table(route[position], route[position - 1]);
+        }
+    }
+};
+
+// Reverses the first improving sub path it finds, returns false if there is none
+inline bool TwoOptMove(std::vector<NodeID> &route,
+                       const util::DistTableWrapper<EdgeWeight> &dist_table,
+                       const RoutePrefixSums &sums)
+{
+    const auto size = route.size();
+    for (std::size_t first = 0; first + 2 < size; ++first)
+    {
+        const auto before = route[first];
+        const auto head = route[first + 1];
+        for (std::size_t last = first + 2; last < size; ++last)
+        {
+            const auto tail = route[last];
+            const auto after = route[(last + 1) % size];
+
+            const std::int64_t old_cost = static_cast<std::int64_t>(dist_table(before, head)) +
+                                          (sums.forward[last] - sums.forward[first + 1]) +
+                                          dist_table(tail, after);
+            const std::int64_t new_cost = static_cast<std::int64_t>(dist_table(before, tail)) +
+                                          (sums.backward[last] - sums.backward[first + 1]) +
+                                          dist_table(head, after);
+            if (new_cost < old_cost)
+            {
+                std::reverse(route.begin() + first + 1, route.begin() + last + 1);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Moves the first chain of up to three locations it finds that is cheaper to visit between two
+// other locations, returns false if there is none
+inline bool OrOptMove(std::vector<NodeID> &route,
+                      const util::DistTableWrapper<EdgeWeight> &dist_table)
+{
+    const std::size_t MAX_CHAIN_LENGTH = 3;
+
+    const auto size = route.size();
+    for (std::size_t length = 1; length <= MAX_CHAIN_LENGTH && length + 2 < size; ++length)
+    {
+        for (std::size_t start = 0; start < size; ++start)
+        {
+            const auto end = (start + length - 1) % size;
+            const auto head = route[start];
+            const auto tail = route[end];
+            const auto before = route[(start + size - 1) % size];
+            const auto after = route[(end + 1) % size];
+
+            const std::int64_t removal_gain = static_cast<std::int64_t>(dist_table(before, head)) +
+                                              dist_table(tail, after) -
+                                              dist_table(before, after);
+
+            // try every edge outside of the chain that does not touch its old position
+            for (std::size_t offset = 1; offset + length < size; ++offset)
+            {
+                const auto from = (end + offset) % size;
+                const auto to = (from + 1) % size;
+
+                const std::int64_t insertion_cost =
+                    static_cast<std::int64_t>(dist_table(route[from], head)) +
+                    dist_table(tail, route[to]) - dist_table(route[from], route[to]);
+                if (insertion_cost < removal_gain)
+                {
+                    // rebuild the route starting right behind the chain
+                    std::vector<NodeID> moved;
+                    moved.reserve(size);
+                    for (std::size_t position = 1; position + length <= size; ++position)
+                    {
+                        const auto node = route[(end + position) % size];
+                        moved.push_back(node);
+                        if (position == offset)
+                        {
+                            for (std::size_t chain = 0; chain < length; ++chain)
+                            {
+                                moved.push_back(route[(start + chain) % size]);
+                            }
+                        }
+                    }
+                    BOOST_ASSERT(moved.size() == size);
+                    route = std::move(moved);
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+}
+
+// Improves a roundtrip with 2-opt and Or-opt moves until no move shortens it any more or the
+// search time is used up. The table may be asymmetric; moves are only taken if they strictly
+// shorten the trip, so a trip without INVALID_EDGE_WEIGHT edges never gets one.
+inline std::vector<NodeID> LocalSearchTrip(std::vector<NodeID> route,
+                                           const util::DistTableWrapper<EdgeWeight> &dist_table,
+                                           const std::chrono::milliseconds max_search_time)
+{
+    if (route.size() < 4 || max_search_time.count() <= 0)
+    {
+        return route;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + max_search_time;
+
+    detail::RoutePrefixSums sums;
+    sums.Update(route, dist_table);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        if (!detail::TwoOptMove(route, dist_table, sums) &&
+            !detail::OrOptMove(route, dist_table))
+        {
+            break;
+        }
+        sums.Update(route, dist_table);
+    }
+
+    return route;
+}
+
+} // namespace trip
+} // namespace engine
+} // namespace osrm
+
+#endif // TRIP_LOCAL_SEARCH_HPP
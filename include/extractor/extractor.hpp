@@ -89,7 +89,13 @@ class Extractor
                         EdgeBasedNodeDataContainer &nodes_container) const;
     void BuildRTree(std::vector<EdgeBasedNodeSegment> edge_based_node_segments,
                     std::vector<bool> node_is_startpoint,
-                    const std::vector<util::Coordinate> &coordinates);
+                    const std::vector<util::Coordinate> &coordinates,
+                    const EdgeBasedNodeDataContainer &nodes_container);
+    void BuildSpatialGrid(const std::vector<EdgeBasedNodeSegment> &edge_based_node_segments,
+                          const std::vector<util::Coordinate> &coordinates);
+    void BuildRoadOverview(const util::NodeBasedDynamicGraph &node_based_graph,
+                           const CompressedEdgeContainer &compressed_edges,
+                           const std::vector<util::Coordinate> &coordinates);
     std::shared_ptr<RestrictionMap> LoadRestrictionMap();
 
     // Writes compressed node based graph and its embedding into a file for osrm-partition to use.
@@ -60,6 +60,8 @@ struct ExtractorConfig final : storage::IOConfig
                                       ".osrm.ebg",
                                       ".osrm.ramIndex",
                                       ".osrm.fileIndex",
+                                      ".osrm.grid",
+                                      ".osrm.overview",
                                       ".osrm.turn_duration_penalties",
                                       ".osrm.turn_weight_penalties",
                                       ".osrm.turn_penalties_index",
@@ -69,6 +71,8 @@ struct ExtractorConfig final : storage::IOConfig
                                       ".osrm.cnbg",
                                       ".osrm.cnbg_to_ebg"}),
                                  requested_num_threads(0),
+                                 spatial_grid_cell_size(0),
+                                 generate_road_overview(false),
                                  use_locations_cache(true)
     {
     }
@@ -84,6 +88,10 @@ struct ExtractorConfig final : storage::IOConfig
 
     unsigned requested_num_threads;
     unsigned small_component_size;
+    // cell size in meters of the snapping grid, 0 disables it
+    unsigned spatial_grid_cell_size;
+    // generalised network of major roads for low zoom tiles
+    bool generate_road_overview;
 
     bool generate_edge_lookup;
 
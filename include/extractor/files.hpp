@@ -2,9 +2,11 @@
 #define OSRM_EXTRACTOR_FILES_HPP
 
 #include "extractor/edge_based_edge.hpp"
+#include "extractor/edge_based_node_segment.hpp"
 #include "extractor/guidance/turn_lane_types.hpp"
 #include "extractor/node_data_container.hpp"
 #include "extractor/profile_properties.hpp"
+#include "extractor/road_overview.hpp"
 #include "extractor/serialization.hpp"
 #include "extractor/turn_data_container.hpp"
 
@@ -14,6 +16,7 @@
 #include "util/packed_vector.hpp"
 #include "util/range_table.hpp"
 #include "util/serialization.hpp"
+#include "util/static_grid.hpp"
 
 #include <boost/assert.hpp>
 
@@ -56,6 +59,50 @@ inline void readIntersections(const boost::filesystem::path &path,
     storage::serialization::read(reader, entry_classes);
 }
 
+// reads .osrm.grid
+template <typename SpatialGridT>
+inline void readSpatialGrid(const boost::filesystem::path &path, SpatialGridT &grid)
+{
+    static_assert(std::is_same<util::StaticGrid<EdgeBasedNodeSegment>, SpatialGridT>::value ||
+                      std::is_same<util::StaticGridView<EdgeBasedNodeSegment>, SpatialGridT>::value,
+                  "");
+
+    storage::io::FileReader reader(path, storage::io::FileReader::VerifyFingerprint);
+
+    util::serialization::read(reader, grid);
+}
+
+// writes .osrm.grid
+template <typename SpatialGridT>
+inline void writeSpatialGrid(const boost::filesystem::path &path, const SpatialGridT &grid)
+{
+    static_assert(std::is_same<util::StaticGrid<EdgeBasedNodeSegment>, SpatialGridT>::value ||
+                      std::is_same<util::StaticGridView<EdgeBasedNodeSegment>, SpatialGridT>::value,
+                  "");
+
+    storage::io::FileWriter writer(path, storage::io::FileWriter::GenerateFingerprint);
+
+    util::serialization::write(writer, grid);
+}
+
+// reads .osrm.overview
+inline void readRoadOverview(const boost::filesystem::path &path, RoadOverview &overview)
+{
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    serialization::read(reader, overview);
+}
+
+// writes .osrm.overview
+inline void writeRoadOverview(const boost::filesystem::path &path, const RoadOverview &overview)
+{
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    serialization::write(writer, overview);
+}
+
 // reads .osrm.properties
 inline void readProfileProperties(const boost::filesystem::path &path,
                                   ProfileProperties &properties)
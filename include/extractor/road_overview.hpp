@@ -0,0 +1,234 @@
+#ifndef OSRM_EXTRACTOR_ROAD_OVERVIEW_HPP
+#define OSRM_EXTRACTOR_ROAD_OVERVIEW_HPP
+
+#include "extractor/guidance/road_classification.hpp"
+
+#include "storage/io_fwd.hpp"
+
+#include "util/coordinate.hpp"
+#include "util/integer_range.hpp"
+#include "util/web_mercator.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+class RoadOverview;
+
+namespace serialization
+{
+inline void read(storage::io::FileReader &reader, RoadOverview &overview);
+inline void write(storage::io::FileWriter &writer, const RoadOverview &overview);
+}
+
+// Roads that are shown on the overview: motorways, trunks, primary and secondary roads
+inline bool isOverviewRoad(const guidance::RoadClassification classification)
+{
+    return !classification.IsLinkClass() && !classification.IsLowPriorityRoadClass() &&
+           classification.GetPriority() <= guidance::RoadPriorityClass::SECONDARY;
+}
+
+/***
+ * Generalised network of the major roads that low zoom tiles are rendered from.
+ *
+ * Every line is a packed geometry simplified with Douglas-Peucker. Its points remember
+ * the lowest zoom level they are needed at and their position in the packed geometry,
+ * so speeds can be summed up from the live segment data. Lines are indexed by the tiles
+ * of INDEX_ZOOM they overlap.
+ */
+class RoadOverview
+{
+  public:
+    // zoom levels that are rendered from the overview instead of the r-tree
+    static constexpr unsigned MIN_ZOOM = 8;
+    static constexpr unsigned MAX_ZOOM = 11;
+    static constexpr unsigned INDEX_ZOOM = 10;
+
+    struct Line
+    {
+        std::uint32_t geometry_id;
+        std::uint32_t first_point;
+        std::uint8_t forward_enabled;
+        std::uint8_t reverse_enabled;
+    };
+
+    struct Point
+    {
+        util::Coordinate coordinate;
+        // distance in meters from the start of the packed geometry
+        float distance;
+        // index of the node in the packed geometry
+        std::uint32_t position;
+        // lowest zoom level the point is kept at
+        std::uint8_t min_zoom;
+    };
+
+    RoadOverview() = default;
+    explicit RoadOverview(std::string timestamp) : timestamp(std::move(timestamp)) {}
+
+    const std::string &GetTimestamp() const { return timestamp; }
+    std::size_t GetNumberOfLines() const { return lines.size(); }
+
+    const Line &GetLine(const std::uint32_t line) const { return lines[line]; }
+
+    boost::iterator_range<const Point *> GetPoints(const std::uint32_t line) const
+    {
+        BOOST_ASSERT(line < lines.size());
+        const auto end = line + 1 < lines.size() ? lines[line + 1].first_point : points.size();
+        return boost::make_iterator_range(points.data() + lines[line].first_point,
+                                          points.data() + end);
+    }
+
+    // The first and the last point of a line have to be kept at all zoom levels
+    void AddLine(const std::uint32_t geometry_id,
+                 const bool forward_enabled,
+                 const bool reverse_enabled,
+                 const std::vector<Point> &line_points)
+    {
+        BOOST_ASSERT(line_points.size() >= 2);
+        BOOST_ASSERT(line_points.front().min_zoom <= MIN_ZOOM);
+        BOOST_ASSERT(line_points.back().min_zoom <= MIN_ZOOM);
+        lines.push_back(Line{geometry_id,
+                             static_cast<std::uint32_t>(points.size()),
+                             forward_enabled,
+                             reverse_enabled});
+        points.insert(points.end(), line_points.begin(), line_points.end());
+    }
+
+    // Indexes all lines added so far by the cells of INDEX_ZOOM their bounding box overlaps
+    void BuildIndex()
+    {
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> cell_line_pairs;
+        for (const auto line : util::irange<std::uint32_t>(0, lines.size()))
+        {
+            const auto line_points = GetPoints(line);
+            const auto minmax_lon = std::minmax_element(
+                line_points.begin(), line_points.end(), [](const Point &lhs, const Point &rhs) {
+                    return lhs.coordinate.lon < rhs.coordinate.lon;
+                });
+            const auto minmax_lat = std::minmax_element(
+                line_points.begin(), line_points.end(), [](const Point &lhs, const Point &rhs) {
+                    return lhs.coordinate.lat < rhs.coordinate.lat;
+                });
+
+            const auto min_x = GetCellIndex(util::web_mercator::degreeToPixel(
+                util::web_mercator::clamp(util::toFloating(minmax_lon.first->coordinate.lon)),
+                INDEX_ZOOM));
+            const auto max_x = GetCellIndex(util::web_mercator::degreeToPixel(
+                util::web_mercator::clamp(util::toFloating(minmax_lon.second->coordinate.lon)),
+                INDEX_ZOOM));
+            // the y axis of tiles points south
+            const auto min_y = GetCellIndex(util::web_mercator::degreeToPixel(
+                util::web_mercator::clamp(util::toFloating(minmax_lat.second->coordinate.lat)),
+                INDEX_ZOOM));
+            const auto max_y = GetCellIndex(util::web_mercator::degreeToPixel(
+                util::web_mercator::clamp(util::toFloating(minmax_lat.first->coordinate.lat)),
+                INDEX_ZOOM));
+
+            for (const auto x : util::irange(min_x, max_x + 1))
+            {
+                for (const auto y : util::irange(min_y, max_y + 1))
+                {
+                    cell_line_pairs.emplace_back(GetCellKey(x, y), line);
+                }
+            }
+        }
+        std::sort(cell_line_pairs.begin(), cell_line_pairs.end());
+
+        cell_keys.clear();
+        cell_offsets.clear();
+        cell_lines.clear();
+        cell_lines.reserve(cell_line_pairs.size());
+        for (const auto &cell_line : cell_line_pairs)
+        {
+            if (cell_keys.empty() || cell_keys.back() != cell_line.first)
+            {
+                cell_keys.push_back(cell_line.first);
+                cell_offsets.push_back(cell_lines.size());
+            }
+            cell_lines.push_back(cell_line.second);
+        }
+        cell_offsets.push_back(cell_lines.size());
+    }
+
+    // Lines that might cross the tile x, y at zoom level z, in ascending order
+    std::vector<std::uint32_t> GetLines(const unsigned x, const unsigned y, const unsigned z) const
+    {
+        BOOST_ASSERT(z >= MIN_ZOOM && z <= MAX_ZOOM);
+
+        unsigned min_x, max_x, min_y, max_y;
+        if (z <= INDEX_ZOOM)
+        {
+            const auto shift = INDEX_ZOOM - z;
+            min_x = x << shift;
+            max_x = ((x + 1) << shift) - 1;
+            min_y = y << shift;
+            max_y = ((y + 1) << shift) - 1;
+        }
+        else
+        {
+            min_x = max_x = x >> (z - INDEX_ZOOM);
+            min_y = max_y = y >> (z - INDEX_ZOOM);
+        }
+
+        std::vector<std::uint32_t> result;
+        for (const auto cell_x : util::irange(min_x, max_x + 1))
+        {
+            for (const auto cell_y : util::irange(min_y, max_y + 1))
+            {
+                const auto key = GetCellKey(cell_x, cell_y);
+                const auto iter = std::lower_bound(cell_keys.begin(), cell_keys.end(), key);
+                if (iter == cell_keys.end() || *iter != key)
+                {
+                    continue;
+                }
+                const auto cell = std::distance(cell_keys.begin(), iter);
+                result.insert(result.end(),
+                              cell_lines.begin() + cell_offsets[cell],
+                              cell_lines.begin() + cell_offsets[cell + 1]);
+            }
+        }
+        // lines spanning several cells are listed in all of them
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+    friend void serialization::read(storage::io::FileReader &reader, RoadOverview &overview);
+    friend void serialization::write(storage::io::FileWriter &writer,
+                                     const RoadOverview &overview);
+
+  private:
+    static unsigned GetCellIndex(const double pixel)
+    {
+        const auto index = std::max(0., pixel / util::web_mercator::TILE_SIZE);
+        return std::min<unsigned>((1u << INDEX_ZOOM) - 1, static_cast<unsigned>(index));
+    }
+
+    static std::uint64_t GetCellKey(const unsigned x, const unsigned y)
+    {
+        return (static_cast<std::uint64_t>(x) << 32) | y;
+    }
+
+    std::string timestamp;
+    std::vector<Line> lines;
+    std::vector<Point> points;
+    // sorted keys of all cells that contain lines
+    std::vector<std::uint64_t> cell_keys;
+    std::vector<std::uint32_t> cell_offsets;
+    std::vector<std::uint32_t> cell_lines;
+};
+}
+}
+
+#endif // OSRM_EXTRACTOR_ROAD_OVERVIEW_HPP
@@ -8,6 +8,7 @@
 #include "extractor/node_data_container.hpp"
 #include "extractor/profile_properties.hpp"
 #include "extractor/restriction.hpp"
+#include "extractor/road_overview.hpp"
 #include "extractor/segment_data_container.hpp"
 #include "extractor/turn_data_container.hpp"
 
@@ -322,6 +323,30 @@ inline void read(storage::io::FileReader &reader,
     for (auto &penalty : conditional_penalties)
         read(reader, penalty);
 }
+
+// read/write for road overview file
+inline void read(storage::io::FileReader &reader, RoadOverview &overview)
+{
+    std::vector<char> timestamp;
+    storage::serialization::read(reader, timestamp);
+    overview.timestamp.assign(timestamp.begin(), timestamp.end());
+    storage::serialization::read(reader, overview.lines);
+    storage::serialization::read(reader, overview.points);
+    storage::serialization::read(reader, overview.cell_keys);
+    storage::serialization::read(reader, overview.cell_offsets);
+    storage::serialization::read(reader, overview.cell_lines);
+}
+
+inline void write(storage::io::FileWriter &writer, const RoadOverview &overview)
+{
+    storage::serialization::write(
+        writer, std::vector<char>(overview.timestamp.begin(), overview.timestamp.end()));
+    storage::serialization::write(writer, overview.lines);
+    storage::serialization::write(writer, overview.points);
+    storage::serialization::write(writer, overview.cell_keys);
+    storage::serialization::write(writer, overview.cell_offsets);
+    storage::serialization::write(writer, overview.cell_lines);
+}
 }
 }
 }
@@ -31,6 +31,7 @@
 
 #include <exception>
 #include <memory>
+#include <stdexcept>
 #include <utility>
 
 namespace node_osrm
@@ -80,7 +81,14 @@ inline void ParseResult(const osrm::Status &result_status, osrm::json::Object &r
     }
 }
 
-inline void ParseResult(const osrm::Status & /*result_status*/, const std::string & /*unused*/) {}
+// failed tiles hand back the reason instead of the tile
+inline void ParseResult(const osrm::Status &result_status, const std::string &result)
+{
+    if (result_status == osrm::Status::Error)
+    {
+        throw std::logic_error(result.c_str());
+    }
+}
 
 inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo<v8::Value> &args)
 {
@@ -189,7 +197,11 @@ inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo
     auto max_locations_map_matching =
         params->Get(Nan::New("max_locations_map_matching").ToLocalChecked());
     auto max_results_nearest = params->Get(Nan::New("max_results_nearest").ToLocalChecked());
+    auto max_locations_nearest =
+        params->Get(Nan::New("max_locations_nearest").ToLocalChecked());
     auto max_alternatives = params->Get(Nan::New("max_alternatives").ToLocalChecked());
+    auto max_trip_search_time =
+        params->Get(Nan::New("max_trip_search_time").ToLocalChecked());
 
     if (!max_locations_trip->IsUndefined() && !max_locations_trip->IsNumber())
     {
@@ -216,11 +228,21 @@ inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo
         Nan::ThrowError("max_results_nearest must be an integral number");
         return engine_config_ptr();
     }
+    if (!max_locations_nearest->IsUndefined() && !max_locations_nearest->IsNumber())
+    {
+        Nan::ThrowError("max_locations_nearest must be an integral number");
+        return engine_config_ptr();
+    }
     if (!max_alternatives->IsUndefined() && !max_alternatives->IsNumber())
     {
         Nan::ThrowError("max_alternatives must be an integral number");
         return engine_config_ptr();
     }
+    if (!max_trip_search_time->IsUndefined() && !max_trip_search_time->IsNumber())
+    {
+        Nan::ThrowError("max_trip_search_time must be an integral number");
+        return engine_config_ptr();
+    }
 
     if (max_locations_trip->IsNumber())
         engine_config->max_locations_trip = static_cast<int>(max_locations_trip->NumberValue());
@@ -235,8 +257,14 @@ inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo
             static_cast<int>(max_locations_map_matching->NumberValue());
     if (max_results_nearest->IsNumber())
         engine_config->max_results_nearest = static_cast<int>(max_results_nearest->NumberValue());
+    if (max_locations_nearest->IsNumber())
+        engine_config->max_locations_nearest =
+            static_cast<int>(max_locations_nearest->NumberValue());
     if (max_alternatives->IsNumber())
         engine_config->max_alternatives = static_cast<int>(max_alternatives->NumberValue());
+    if (max_trip_search_time->IsNumber())
+        engine_config->max_trip_search_time =
+            static_cast<int>(max_trip_search_time->NumberValue());
 
     return engine_config;
 }
@@ -716,7 +744,7 @@ inline bool parseCommonParameters(const v8::Local<v8::Object> &obj, ParamType &p
 
         if (!geometries->IsString())
         {
-            Nan::ThrowError("Geometries must be a string: [polyline, polyline6, geojson]");
+            Nan::ThrowError("Geometries must be a string: [polyline, polyline6, geojson, none]");
             return false;
         }
         const Nan::Utf8String geometries_utf8str(geometries);
@@ -735,9 +763,14 @@ inline bool parseCommonParameters(const v8::Local<v8::Object> &obj, ParamType &p
         {
             params->geometries = osrm::RouteParameters::GeometriesType::GeoJSON;
         }
+        else if (geometries_str == "none")
+        {
+            params->geometries = osrm::RouteParameters::GeometriesType::None;
+        }
         else
         {
-            Nan::ThrowError("'geometries' param must be one of [polyline, polyline6, geojson]");
+            Nan::ThrowError(
+                "'geometries' param must be one of [polyline, polyline6, geojson, none]");
             return false;
         }
     }
@@ -935,6 +968,19 @@ argumentsToNearestParameter(const Nan::FunctionCallbackInfo<v8::Value> &args,
         }
     }
 
+    if (obj->Has(Nan::New("batch").ToLocalChecked()))
+    {
+        v8::Local<v8::Value> batch = obj->Get(Nan::New("batch").ToLocalChecked());
+
+        if (!batch->IsBoolean())
+        {
+            Nan::ThrowError("batch must be of type Boolean");
+            return nearest_parameters_ptr();
+        }
+
+        params->batch = batch->BooleanValue();
+    }
+
     return params;
 }
 
@@ -1156,6 +1202,64 @@ argumentsToTripParameter(const Nan::FunctionCallbackInfo<v8::Value> &args,
         }
     }
 
+    if (obj->Has(Nan::New("precedences").ToLocalChecked()))
+    {
+        v8::Local<v8::Value> precedences = obj->Get(Nan::New("precedences").ToLocalChecked());
+        if (precedences.IsEmpty())
+            return trip_parameters_ptr();
+
+        if (!precedences->IsArray())
+        {
+            Nan::ThrowError("Precedences must be an array of [pickup, delivery] index pairs");
+            return trip_parameters_ptr();
+        }
+
+        v8::Local<v8::Array> precedences_array = v8::Local<v8::Array>::Cast(precedences);
+        for (uint32_t i = 0; i < precedences_array->Length(); ++i)
+        {
+            v8::Local<v8::Value> precedence = precedences_array->Get(i);
+            if (precedence.IsEmpty())
+                return trip_parameters_ptr();
+
+            if (!precedence->IsArray() || v8::Local<v8::Array>::Cast(precedence)->Length() != 2)
+            {
+                Nan::ThrowError("Precedences array items must be [pickup, delivery] pairs");
+                return trip_parameters_ptr();
+            }
+
+            v8::Local<v8::Array> pair = v8::Local<v8::Array>::Cast(precedence);
+            v8::Local<v8::Value> pickup = pair->Get(0);
+            v8::Local<v8::Value> delivery = pair->Get(1);
+            if (!pickup->IsUint32() || !delivery->IsUint32())
+            {
+                Nan::ThrowError("Precedence indices must be unsigned integers");
+                return trip_parameters_ptr();
+            }
+            if (pickup->Uint32Value() >= params->coordinates.size() ||
+                delivery->Uint32Value() >= params->coordinates.size() ||
+                pickup->Uint32Value() == delivery->Uint32Value())
+            {
+                Nan::ThrowError("Precedences must be pairs of two different coordinate indices");
+                return trip_parameters_ptr();
+            }
+            params->precedences.emplace_back(pickup->Uint32Value(), delivery->Uint32Value());
+        }
+    }
+
+    if (obj->Has(Nan::New("max_duration").ToLocalChecked()))
+    {
+        v8::Local<v8::Value> max_duration = obj->Get(Nan::New("max_duration").ToLocalChecked());
+        if (max_duration.IsEmpty())
+            return trip_parameters_ptr();
+
+        if (!max_duration->IsNumber() || max_duration->NumberValue() < 0)
+        {
+            Nan::ThrowError("'max_duration' param must be a non-negative number of seconds");
+            return trip_parameters_ptr();
+        }
+        params->max_duration = max_duration->NumberValue();
+    }
+
     return params;
 }
 
@@ -1164,6 +1268,24 @@ argumentsToMatchParameter(const Nan::FunctionCallbackInfo<v8::Value> &args,
                           bool requires_multiple_coordinates)
 {
     match_parameters_ptr params = std::make_unique<osrm::MatchParameters>();
+
+    // live traces of a vehicle can be extended by a single coordinate
+    if (args.Length() > 0 && args[0]->IsObject())
+    {
+        v8::Local<v8::Object> obj = Nan::To<v8::Object>(args[0]).ToLocalChecked();
+        if (obj->Has(Nan::New("vehicle").ToLocalChecked()) &&
+            obj->Has(Nan::New("coordinates").ToLocalChecked()))
+        {
+            v8::Local<v8::Value> coordinates =
+                obj->Get(Nan::New("coordinates").ToLocalChecked());
+            if (!coordinates.IsEmpty() && coordinates->IsArray() &&
+                v8::Local<v8::Array>::Cast(coordinates)->Length() == 1)
+            {
+                requires_multiple_coordinates = false;
+            }
+        }
+    }
+
     bool has_base_params = argumentsToParameter(args, params, requires_multiple_coordinates);
     if (!has_base_params)
         return match_parameters_ptr();
@@ -1251,6 +1373,28 @@ argumentsToMatchParameter(const Nan::FunctionCallbackInfo<v8::Value> &args,
         params->tidy = tidy->BooleanValue();
     }
 
+    if (obj->Has(Nan::New("vehicle").ToLocalChecked()))
+    {
+        v8::Local<v8::Value> vehicle = obj->Get(Nan::New("vehicle").ToLocalChecked());
+        if (vehicle.IsEmpty())
+            return match_parameters_ptr();
+
+        if (!vehicle->IsString())
+        {
+            Nan::ThrowError("vehicle must be a string");
+            return match_parameters_ptr();
+        }
+
+        const Nan::Utf8String vehicle_utf8str(vehicle);
+        params->vehicle =
+            std::string{*vehicle_utf8str, *vehicle_utf8str + vehicle_utf8str.length()};
+        if (params->vehicle.empty())
+        {
+            Nan::ThrowError("vehicle must not be empty");
+            return match_parameters_ptr();
+        }
+    }
+
     bool parsedSuccessfully = parseCommonParameters(obj, params);
     if (!parsedSuccessfully)
     {
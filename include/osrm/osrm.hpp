@@ -31,8 +31,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "osrm/osrm_fwd.hpp"
 #include "osrm/status.hpp"
 
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -141,15 +144,39 @@ class OSRM final
      */
     Status Match(const MatchParameters &parameters, json::Object &result) const;
 
+    /**
+     * Match: snaps many traces in parallel
+     *
+     * The traces are distributed over all cores. Results are handed to on_result as soon as
+     * a trace is done, so they do not arrive in input order. on_result is never called
+     * concurrently and the result object may be moved from. Live traces with the same vehicle
+     * id are matched one after another in input order.
+     *
+     * \param parameters match query specific parameters, one per trace
+     * \param on_result called with the index of the trace, its status and its result
+     * \see Status, MatchParameters and json::Object
+     */
+    void Match(const std::vector<MatchParameters> &parameters,
+               const std::function<void(std::size_t, Status, json::Object &)> &on_result) const;
+
     /**
      * Tile: vector tiles with internal graph representation
      *
      * \param parameters tile query specific parameters
+     * \param result the encoded tile, or the reason why it could not be rendered on failure
      * \return Status indicating success for the query or failure
      * \see Status, TileParameters and json::Object
      */
     Status Tile(const TileParameters &parameters, std::string &result) const;
 
+    /**
+     * GetDatasetGeneration: identifies the data that queries run on
+     *
+     * Changes whenever osrm-datastore loaded new data, e.g. after a weight update, and the
+     * engine switched to it. Always 0 when the data is not read from shared memory.
+     */
+    unsigned GetDatasetGeneration() const;
+
   private:
     std::unique_ptr<engine::EngineInterface> engine_;
 };
@@ -36,19 +36,26 @@ struct MatchParametersGrammar final : public RouteParametersGrammar<Iterator, Si
         gaps_type.add("split", engine::api::MatchParameters::GapsType::Split)(
             "ignore", engine::api::MatchParameters::GapsType::Ignore);
 
+        vehicle_rule =
+            qi::lit("vehicle=") >
+            qi::as_string[+(qi::alnum | qi::char_("_.:") | qi::char_('-'))]
+                         [ph::bind(&engine::api::MatchParameters::vehicle, qi::_r1) = qi::_1];
+
         root_rule =
             BaseGrammar::query_rule(qi::_r1) > -qi::lit(".json") >
             -('?' > (timestamps_rule(qi::_r1) | BaseGrammar::base_rule(qi::_r1) |
                      (qi::lit("gaps=") >
                       gaps_type[ph::bind(&engine::api::MatchParameters::gaps, qi::_r1) = qi::_1]) |
                      (qi::lit("tidy=") >
-                      qi::bool_[ph::bind(&engine::api::MatchParameters::tidy, qi::_r1) = qi::_1])) %
+                      qi::bool_[ph::bind(&engine::api::MatchParameters::tidy, qi::_r1) = qi::_1]) |
+                     vehicle_rule(qi::_r1)) %
                         '&');
     }
 
   private:
     qi::rule<Iterator, Signature> root_rule;
     qi::rule<Iterator, Signature> timestamps_rule;
+    qi::rule<Iterator, Signature> vehicle_rule;
 
     qi::symbols<char, engine::api::MatchParameters::GapsType> gaps_type;
 };
@@ -28,9 +28,12 @@ struct NearestParametersGrammar final : public BaseParametersGrammar<Iterator, S
 
     NearestParametersGrammar() : BaseGrammar(root_rule)
     {
-        nearest_rule = (qi::lit("number=") >
-                        qi::uint_)[ph::bind(&engine::api::NearestParameters::number_of_results,
-                                            qi::_r1) = qi::_1];
+        nearest_rule =
+            (qi::lit("number=") >
+             qi::uint_)[ph::bind(&engine::api::NearestParameters::number_of_results, qi::_r1) =
+                            qi::_1] |
+            (qi::lit("batch=") >
+             qi::bool_)[ph::bind(&engine::api::NearestParameters::batch, qi::_r1) = qi::_1];
 
         root_rule = BaseGrammar::query_rule(qi::_r1) > -qi::lit(".json") >
                     -('?' > (nearest_rule(qi::_r1) | BaseGrammar::base_rule(qi::_r1)) % '&');
@@ -59,7 +59,8 @@ struct RouteParametersGrammar : public BaseParametersGrammar<Iterator, Signature
 
         geometries_type.add("geojson", engine::api::RouteParameters::GeometriesType::GeoJSON)(
             "polyline", engine::api::RouteParameters::GeometriesType::Polyline)(
-            "polyline6", engine::api::RouteParameters::GeometriesType::Polyline6);
+            "polyline6", engine::api::RouteParameters::GeometriesType::Polyline6)(
+            "none", engine::api::RouteParameters::GeometriesType::None);
 
         overview_type.add("simplified", engine::api::RouteParameters::OverviewType::Simplified)(
             "full", engine::api::RouteParameters::OverviewType::Full)(
@@ -28,6 +28,15 @@ struct TripParametersGrammar final : public RouteParametersGrammar<Iterator, Sig
 
     TripParametersGrammar() : BaseGrammar(root_rule)
     {
+#ifdef BOOST_HAS_LONG_LONG
+        if (std::is_same<std::size_t, unsigned long long>::value)
+            size_t_ = qi::ulong_long;
+        else
+            size_t_ = qi::ulong_;
+#else
+        size_t_ = qi::ulong_;
+#endif
+
         roundtrip_rule =
             qi::lit("roundtrip=") >
             qi::bool_[ph::bind(&engine::api::TripParameters::roundtrip, qi::_r1) = qi::_1];
@@ -45,9 +54,25 @@ struct TripParametersGrammar final : public RouteParametersGrammar<Iterator, Sig
             qi::lit("destination=") >
             destination_type[ph::bind(&engine::api::TripParameters::destination, qi::_r1) = qi::_1];
 
+        const auto add_precedence = [](engine::api::TripParameters &trip_parameters,
+                                       const std::size_t pickup,
+                                       const std::size_t delivery) {
+            trip_parameters.precedences.emplace_back(pickup, delivery);
+        };
+
+        precedences_rule =
+            qi::lit("precedences=") >
+            (size_t_ > ',' > size_t_)[ph::bind(add_precedence, qi::_r1, qi::_1, qi::_2)] %
+                ';';
+
+        max_duration_rule =
+            qi::lit("max_duration=") >
+            qi::double_[ph::bind(&engine::api::TripParameters::max_duration, qi::_r1) = qi::_1];
+
         root_rule = BaseGrammar::query_rule(qi::_r1) > -qi::lit(".json") >
                     -('?' > (roundtrip_rule(qi::_r1) | source_rule(qi::_r1) |
-                             destination_rule(qi::_r1) | BaseGrammar::base_rule(qi::_r1)) %
+                             destination_rule(qi::_r1) | precedences_rule(qi::_r1) |
+                             max_duration_rule(qi::_r1) | BaseGrammar::base_rule(qi::_r1)) %
                                 '&');
     }
 
@@ -55,7 +80,10 @@ struct TripParametersGrammar final : public RouteParametersGrammar<Iterator, Sig
     qi::rule<Iterator, Signature> source_rule;
     qi::rule<Iterator, Signature> destination_rule;
     qi::rule<Iterator, Signature> roundtrip_rule;
+    qi::rule<Iterator, Signature> precedences_rule;
+    qi::rule<Iterator, Signature> max_duration_rule;
     qi::rule<Iterator, Signature> root_rule;
+    qi::rule<Iterator, std::size_t()> size_t_;
 
     qi::symbols<char, engine::api::TripParameters::SourceType> source_type;
     qi::symbols<char, engine::api::TripParameters::DestinationType> destination_type;
@@ -16,6 +16,8 @@ namespace api
 
 // Starts parsing and iter and modifies it until iter == end or parsing failed
 boost::optional<ParsedURL> parseURL(std::string::iterator &iter, const std::string::iterator end);
+boost::optional<ParsedURL> parseURL(std::string::const_iterator &iter,
+                                    const std::string::const_iterator end);
 
 inline boost::optional<ParsedURL> parseURL(std::string url_string)
 {
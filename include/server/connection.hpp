@@ -12,6 +12,7 @@
 #include <boost/version.hpp>
 
 #include <memory>
+#include <string>
 #include <vector>
 
 // workaround for incomplete std::shared_ptr compatibility in old boost versions
@@ -32,12 +33,20 @@ namespace server
 {
 
 class RequestHandler;
+class RequestScheduler;
 
 /// Represents a single connection from a client.
 class Connection : public std::enable_shared_from_this<Connection>
 {
   public:
-    explicit Connection(boost::asio::io_service &io_service, RequestHandler &handler);
+    // Connections are closed after keepalive_requests requests or keepalive_timeout seconds
+    // without a complete request, keepalive_timeout has to be positive. No requests are kept
+    // alive if keepalive_requests is 0.
+    explicit Connection(boost::asio::io_service &io_service,
+                        RequestHandler &handler,
+                        RequestScheduler &scheduler,
+                        const unsigned keepalive_requests,
+                        const int keepalive_timeout);
     Connection(const Connection &) = delete;
     Connection &operator=(const Connection &) = delete;
 
@@ -49,20 +58,49 @@ class Connection : public std::enable_shared_from_this<Connection>
   private:
     void handle_read(const boost::system::error_code &e, std::size_t bytes_transferred);
 
+    /// Parse and answer the requests in the input, pipelined requests are answered in order.
+    void handle_input(char *begin, char *end);
+
+    /// Compute, compress and cache the reply once the scheduler runs the request.
+    void handle_request(const http::compression_type compression_type, const unsigned dataset);
+
+    void write_reply();
+
     /// Handle completion of a write operation.
     void handle_write(const boost::system::error_code &e);
 
-    std::vector<char> compress_buffers(const std::vector<char> &uncompressed_data,
-                                       const http::compression_type compression_type);
+    /// Close the connection if no complete request arrived in time.
+    void handle_timeout(const boost::system::error_code &e);
+
+    void read_more();
+
+    void start_timer();
+
+    void close();
+
+    // returns false if the reply could not be compressed
+    bool compress_buffers(const std::vector<char> &uncompressed_data,
+                          const http::compression_type compression_type,
+                          std::vector<char> &compressed_data);
 
     boost::asio::io_service::strand strand;
     boost::asio::ip::tcp::socket TCP_socket;
+    boost::asio::deadline_timer timer;
     RequestHandler &request_handler;
+    RequestScheduler &request_scheduler;
     RequestParser request_parser;
     boost::array<char, 8192> incoming_data_buffer;
+    // input that was read but belongs to the next pipelined request
+    char *unparsed_begin;
+    char *unparsed_end;
+    const unsigned keepalive_requests;
+    const boost::posix_time::seconds keepalive_timeout;
+    unsigned processed_requests;
+    bool keep_alive;
     http::request current_request;
+    // the URI of current_request, decoded once for the cache and the request handler
+    std::string request_string;
     http::reply current_reply;
-    std::vector<char> compressed_output;
     // Header compression_header;
     std::vector<boost::asio::const_buffer> output_buffer;
 };
@@ -18,6 +18,8 @@ struct request
     std::string referrer;
     std::string agent;
     boost::asio::ip::address endpoint;
+    // the client wants to send further requests over the connection
+    bool keep_alive = false;
 };
 }
 }
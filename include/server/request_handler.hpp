@@ -1,8 +1,11 @@
 #ifndef REQUEST_HANDLER_HPP
 #define REQUEST_HANDLER_HPP
 
+#include "server/http/compression_type.hpp"
+#include "server/response_cache.hpp"
 #include "server/service_handler.hpp"
 
+#include <memory>
 #include <string>
 
 namespace osrm
@@ -26,10 +29,38 @@ class RequestHandler
 
     void RegisterServiceHandler(std::unique_ptr<ServiceHandlerInterface> service_handler);
 
-    void HandleRequest(const http::request &current_request, http::reply &current_reply);
+    // Replies are cached per generation of the dataset the service handler runs on
+    void RegisterResponseCache(std::unique_ptr<ResponseCache> response_cache);
+
+    // request_string is the decoded URI of the request
+    void HandleRequest(const http::request &current_request,
+                       const std::string &request_string,
+                       http::reply &current_reply);
+
+    unsigned GetDataset() const;
+
+    // Fills in the reply of an identical request if it is cached for the dataset
+    bool GetCachedReply(const http::request &current_request,
+                        const std::string &request_string,
+                        const http::compression_type compression_type,
+                        const unsigned dataset,
+                        http::reply &current_reply);
+
+    // Stores the reply with its content already compressed as requested, unless the dataset
+    // changed since it was read before handling the request
+    void CacheReply(const std::string &request_string,
+                    const http::compression_type compression_type,
+                    const unsigned dataset,
+                    const http::reply &current_reply);
 
   private:
+    void LogAccess(const http::request &current_request,
+                   const std::string &request_string,
+                   const http::reply &current_reply,
+                   const double milliseconds) const;
+
     std::unique_ptr<ServiceHandlerInterface> service_handler;
+    std::unique_ptr<ResponseCache> response_cache;
 };
 }
 }
@@ -28,8 +28,10 @@ class RequestParser
         indeterminate
     };
 
+    // Consumes input up to the end of the request, begin is advanced past the consumed input.
+    // Pipelined requests following a complete request are left unparsed.
     std::tuple<RequestStatus, http::compression_type>
-    parse(http::request &current_request, char *begin, char *end);
+    parse(http::request &current_request, char *&begin, char *end);
 
   private:
     RequestStatus consume(http::request &current_request, const char input);
@@ -75,6 +77,8 @@ class RequestParser
     http::compression_type selected_compression;
     bool is_post_header;
     int content_length;
+    unsigned http_version_major;
+    unsigned http_version_minor;
 };
 }
 }
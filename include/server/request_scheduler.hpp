@@ -0,0 +1,90 @@
+#ifndef REQUEST_SCHEDULER_HPP
+#define REQUEST_SCHEDULER_HPP
+
+#include <boost/asio.hpp>
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace osrm
+{
+namespace server
+{
+
+/**
+ * Limits how many requests of each service class are computed at the same time.
+ *
+ * Requests that find all slots of their class busy wait in a bounded queue and are posted to
+ * the io_service once a request of their class finishes. Requests that find the queue full
+ * are rejected, so expensive batch requests can neither starve cheap interactive ones nor
+ * pile up without bound.
+ */
+class RequestScheduler
+{
+  public:
+    enum class ServiceClass : unsigned char
+    {
+        // route, nearest and tile requests
+        Interactive,
+        // table, matrix, journey, match and trip requests
+        Batch
+    };
+    static constexpr std::size_t NUMBER_OF_CLASSES = 2;
+
+    struct Limits
+    {
+        // requests that are computed at the same time
+        unsigned concurrency;
+        // requests that wait for a free slot
+        std::size_t queue_size;
+    };
+
+    struct Statistics
+    {
+        unsigned running;
+        std::size_t queued;
+        // requests rejected since the scheduler was created
+        std::size_t rejected;
+    };
+
+    using Task = std::function<void()>;
+
+    RequestScheduler(boost::asio::io_service &io_service,
+                     const Limits interactive_limits,
+                     const Limits batch_limits);
+    RequestScheduler(const RequestScheduler &) = delete;
+    RequestScheduler &operator=(const RequestScheduler &) = delete;
+
+    static ServiceClass Classify(const std::string &uri);
+
+    // Runs the task right away if a slot is free or queues it, returns false if the queue is full
+    bool Submit(const ServiceClass service_class, Task task);
+
+    Statistics GetStatistics(const ServiceClass service_class) const;
+
+  private:
+    struct Queue
+    {
+        Limits limits;
+        unsigned running;
+        std::size_t rejected;
+        std::deque<Task> waiting;
+    };
+
+    void Run(const ServiceClass service_class, const Task &task);
+
+    // Frees the slot of a finished request or hands it to the next waiting one
+    void Release(const ServiceClass service_class);
+
+    boost::asio::io_service &io_service;
+    mutable std::mutex mutex;
+    std::array<Queue, NUMBER_OF_CLASSES> queues;
+};
+}
+}
+
+#endif // REQUEST_SCHEDULER_HPP
@@ -0,0 +1,176 @@
+#ifndef OSRM_SERVER_RESPONSE_CACHE_HPP
+#define OSRM_SERVER_RESPONSE_CACHE_HPP
+
+#include "server/http/compression_type.hpp"
+#include "server/http/reply.hpp"
+
+#include <boost/functional/hash.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+
+// Identifies a reply by the decoded request URL and the encoding of its body. Replies of
+// different datasets never share a cache, see ResponseCache.
+struct ResponseKey
+{
+    std::string url;
+    http::compression_type compression;
+
+    bool operator==(const ResponseKey &other) const
+    {
+        return std::tie(compression, url) == std::tie(other.compression, other.url);
+    }
+};
+
+struct ResponseKeyHash
+{
+    std::size_t operator()(const ResponseKey &key) const
+    {
+        std::size_t seed = 0;
+        boost::hash_combine(seed, key.url);
+        boost::hash_combine(seed, static_cast<int>(key.compression));
+        return seed;
+    }
+};
+
+// A reply with its body already compressed as requested
+struct CachedResponse
+{
+    http::reply::status_type status;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::vector<char> content;
+};
+
+// Thread-safe cache of complete replies. Replies older than the time to live are not returned
+// anymore, once the replies take more than max_bytes the least recently used ones are dropped.
+// All replies are flushed as soon as a request for another dataset comes in, e.g. after
+// osrm-datastore swapped the shared memory regions. Replies are stored for the dataset that
+// was current when they were looked up, so replies of replaced datasets are never stored.
+class ResponseCache
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    ResponseCache(const std::size_t max_bytes, const Clock::duration time_to_live)
+        : max_bytes(max_bytes), time_to_live(time_to_live), bytes(0), dataset(0)
+    {
+    }
+
+    std::shared_ptr<const CachedResponse>
+    Get(const ResponseKey &key, const unsigned current_dataset, const Clock::time_point now)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        SwitchDataset(current_dataset);
+
+        const auto iter = index.find(key);
+        if (iter == index.end())
+        {
+            return {};
+        }
+
+        if (now - iter->second->created > time_to_live)
+        {
+            Erase(iter->second);
+            return {};
+        }
+
+        responses.splice(responses.begin(), responses, iter->second);
+        return iter->second->response;
+    }
+
+    void Put(const ResponseKey &key,
+             const unsigned current_dataset,
+             const Clock::time_point now,
+             CachedResponse response)
+    {
+        const auto size = key.url.size() + response.content.size();
+        if (size > max_bytes)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        // the reply was computed for a dataset that has been replaced in the meantime
+        if (current_dataset != dataset)
+        {
+            return;
+        }
+
+        const auto iter = index.find(key);
+        if (iter != index.end())
+        {
+            Erase(iter->second);
+        }
+
+        responses.push_front(
+            Entry{key, std::make_shared<const CachedResponse>(std::move(response)), now, size});
+        index.emplace(key, responses.begin());
+        bytes += size;
+
+        while (bytes > max_bytes)
+        {
+            Erase(std::prev(responses.end()));
+        }
+    }
+
+    std::size_t Size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return responses.size();
+    }
+
+  private:
+    struct Entry
+    {
+        ResponseKey key;
+        std::shared_ptr<const CachedResponse> response;
+        Clock::time_point created;
+        std::size_t size;
+    };
+    using EntryList = std::list<Entry>;
+
+    void SwitchDataset(const unsigned current_dataset)
+    {
+        if (current_dataset != dataset)
+        {
+            responses.clear();
+            index.clear();
+            bytes = 0;
+            dataset = current_dataset;
+        }
+    }
+
+    void Erase(const EntryList::iterator entry)
+    {
+        bytes -= entry->size;
+        index.erase(entry->key);
+        responses.erase(entry);
+    }
+
+    const std::size_t max_bytes;
+    const Clock::duration time_to_live;
+    mutable std::mutex mutex;
+    std::size_t bytes;
+    // dataset of all cached replies
+    unsigned dataset;
+    // most recently used reply first
+    EntryList responses;
+    std::unordered_map<ResponseKey, EntryList::iterator, ResponseKeyHash> index;
+};
+}
+}
+
+#endif // OSRM_SERVER_RESPONSE_CACHE_HPP
@@ -3,6 +3,7 @@
 
 #include "server/connection.hpp"
 #include "server/request_handler.hpp"
+#include "server/request_scheduler.hpp"
 #include "server/service_handler.hpp"
 
 #include "util/integer_range.hpp"
@@ -11,13 +12,16 @@
 #include <boost/asio.hpp>
 #include <boost/bind.hpp>
 
+#ifndef USE_LIBDEFLATE
 #include <zlib.h>
+#endif
 
 #ifndef _WIN32
 #include <sys/socket.h>
 #include <sys/types.h>
 #endif
 
+#include <array>
 #include <functional>
 #include <memory>
 #include <string>
@@ -33,18 +37,46 @@ class Server
 {
   public:
     // Note: returns a shared instead of a unique ptr as it is captured in a lambda somewhere else
-    static std::shared_ptr<Server>
-    CreateServer(std::string &ip_address, int ip_port, unsigned requested_num_threads)
+    static std::shared_ptr<Server> CreateServer(std::string &ip_address,
+                                                int ip_port,
+                                                unsigned requested_num_threads,
+                                                unsigned keepalive_requests,
+                                                int keepalive_timeout,
+                                                RequestScheduler::Limits interactive_limits,
+                                                RequestScheduler::Limits batch_limits)
     {
+#ifdef USE_LIBDEFLATE
+        util::Log() << "http 1.1 compression handled by libdeflate";
+#else
         util::Log() << "http 1.1 compression handled by zlib version " << zlibVersion();
+#endif
         const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
         const unsigned real_num_threads = std::min(hardware_threads, requested_num_threads);
-        return std::make_shared<Server>(ip_address, ip_port, real_num_threads);
+        return std::make_shared<Server>(ip_address,
+                                        ip_port,
+                                        real_num_threads,
+                                        keepalive_requests,
+                                        keepalive_timeout,
+                                        interactive_limits,
+                                        batch_limits);
     }
 
-    explicit Server(const std::string &address, const int port, const unsigned thread_pool_size)
-        : thread_pool_size(thread_pool_size), acceptor(io_service),
-          new_connection(std::make_shared<Connection>(io_service, request_handler))
+    explicit Server(const std::string &address,
+                    const int port,
+                    const unsigned thread_pool_size,
+                    const unsigned keepalive_requests,
+                    const int keepalive_timeout,
+                    const RequestScheduler::Limits interactive_limits,
+                    const RequestScheduler::Limits batch_limits)
+        : thread_pool_size(thread_pool_size), keepalive_requests(keepalive_requests),
+          keepalive_timeout(keepalive_timeout), acceptor(io_service),
+          request_scheduler(io_service, interactive_limits, batch_limits),
+          statistics_timer(io_service), last_rejected{{0, 0}},
+          new_connection(std::make_shared<Connection>(io_service,
+                                                      request_handler,
+                                                      request_scheduler,
+                                                      keepalive_requests,
+                                                      keepalive_timeout))
     {
         const auto port_string = std::to_string(port);
 
@@ -66,6 +98,8 @@ class Server
         acceptor.async_accept(
             new_connection->socket(),
             boost::bind(&Server::HandleAccept, this, boost::asio::placeholders::error));
+
+        StartStatisticsTimer();
     }
 
     void Run()
@@ -90,22 +124,85 @@ class Server
         request_handler.RegisterServiceHandler(std::move(service_handler_));
     }
 
+    void RegisterResponseCache(std::unique_ptr<ResponseCache> response_cache)
+    {
+        request_handler.RegisterResponseCache(std::move(response_cache));
+    }
+
   private:
     void HandleAccept(const boost::system::error_code &e)
     {
         if (!e)
         {
             new_connection->start();
-            new_connection = std::make_shared<Connection>(io_service, request_handler);
+            new_connection = std::make_shared<Connection>(io_service,
+                                                          request_handler,
+                                                          request_scheduler,
+                                                          keepalive_requests,
+                                                          keepalive_timeout);
             acceptor.async_accept(
                 new_connection->socket(),
                 boost::bind(&Server::HandleAccept, this, boost::asio::placeholders::error));
         }
     }
 
+    void StartStatisticsTimer()
+    {
+        // queue depths are logged at most once per interval
+        const long statistics_interval = 60;
+        statistics_timer.expires_from_now(boost::posix_time::seconds(statistics_interval));
+        statistics_timer.async_wait(
+            boost::bind(&Server::LogStatistics, this, boost::asio::placeholders::error));
+    }
+
+    // Logs the queue depths if requests had to wait or were rejected
+    void LogStatistics(const boost::system::error_code &e)
+    {
+        if (e)
+        {
+            return;
+        }
+
+        const std::array<RequestScheduler::ServiceClass, RequestScheduler::NUMBER_OF_CLASSES>
+            service_classes{{RequestScheduler::ServiceClass::Interactive,
+                             RequestScheduler::ServiceClass::Batch}};
+        const std::array<const char *, RequestScheduler::NUMBER_OF_CLASSES> names{
+            {"interactive", "batch"}};
+
+        bool overloaded = false;
+        std::array<RequestScheduler::Statistics, RequestScheduler::NUMBER_OF_CLASSES> statistics;
+        for (const auto index : util::irange<std::size_t>(0, service_classes.size()))
+        {
+            statistics[index] = request_scheduler.GetStatistics(service_classes[index]);
+            overloaded |= statistics[index].queued > 0 ||
+                          statistics[index].rejected != last_rejected[index];
+        }
+
+        if (overloaded)
+        {
+            util::Log log;
+            log << "[scheduler]";
+            for (const auto index : util::irange<std::size_t>(0, service_classes.size()))
+            {
+                log << " " << names[index] << ": " << statistics[index].running << " running, "
+                    << statistics[index].queued << " queued, "
+                    << (statistics[index].rejected - last_rejected[index]) << " rejected;";
+                last_rejected[index] = statistics[index].rejected;
+            }
+        }
+
+        StartStatisticsTimer();
+    }
+
     unsigned thread_pool_size;
+    unsigned keepalive_requests;
+    int keepalive_timeout;
     boost::asio::io_service io_service;
     boost::asio::ip::tcp::acceptor acceptor;
+    RequestScheduler request_scheduler;
+    boost::asio::deadline_timer statistics_timer;
+    // rejected requests per service class at the last log
+    std::array<std::size_t, RequestScheduler::NUMBER_OF_CLASSES> last_rejected;
     std::shared_ptr<Connection> new_connection;
     RequestHandler request_handler;
 };
@@ -29,6 +29,7 @@ class ServiceHandlerInterface
     virtual ~ServiceHandlerInterface() {}
     virtual engine::Status RunQuery(api::ParsedURL parsed_url,
                                     service::BaseService::ResultT &result) = 0;
+    virtual unsigned GetDatasetGeneration() const = 0;
 };
 
 class ServiceHandler final : public ServiceHandlerInterface
@@ -38,6 +39,7 @@ class ServiceHandler final : public ServiceHandlerInterface
     using ResultT = service::BaseService::ResultT;
 
     virtual engine::Status RunQuery(api::ParsedURL parsed_url, ResultT &result) override;
+    virtual unsigned GetDatasetGeneration() const override;
 
   private:
     std::unordered_map<std::string, std::unique_ptr<service::BaseService>> service_map;
@@ -37,6 +37,10 @@ const constexpr char *block_id_to_name[] = {"NAME_CHAR_DATA",
                                             "ENTRY_CLASSID",
                                             "R_SEARCH_TREE",
                                             "R_SEARCH_TREE_LEVELS",
+                                            "R_SEARCH_TREE_LEAVES",
+                                            "SPATIAL_GRID_HEADER",
+                                            "SPATIAL_GRID_CELL_OFFSETS",
+                                            "SPATIAL_GRID_ENTRIES",
                                             "GEOMETRIES_INDEX",
                                             "GEOMETRIES_NODE_LIST",
                                             "GEOMETRIES_FWD_WEIGHT_LIST",
@@ -121,6 +125,10 @@ struct DataLayout
         ENTRY_CLASSID,
         R_SEARCH_TREE,
         R_SEARCH_TREE_LEVELS,
+        R_SEARCH_TREE_LEAVES,
+        SPATIAL_GRID_HEADER,
+        SPATIAL_GRID_CELL_OFFSETS,
+        SPATIAL_GRID_ENTRIES,
         GEOMETRIES_INDEX,
         GEOMETRIES_NODE_LIST,
         GEOMETRIES_FWD_WEIGHT_LIST,
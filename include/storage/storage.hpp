@@ -42,7 +42,9 @@ namespace storage
 class Storage
 {
   public:
-    Storage(StorageConfig config);
+    // If embed_rtree_leaves is set the .fileIndex is copied into the data block,
+    // otherwise only its path is stored and every user has to mmap it
+    Storage(StorageConfig config, const bool embed_rtree_leaves = false);
 
     int Run(int max_wait);
 
@@ -51,6 +53,7 @@ class Storage
 
   private:
     StorageConfig config;
+    bool embed_rtree_leaves;
 };
 }
 }
@@ -70,7 +70,9 @@ struct StorageConfig final : IOConfig
                     ".osrm.mldgr",
                     ".osrm.tld",
                     ".osrm.tls",
-                    ".osrm.partition"},
+                    ".osrm.partition",
+                    ".osrm.grid",
+                    ".osrm.overview"},
                    {})
     {
     }
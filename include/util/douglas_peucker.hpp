@@ -1,5 +1,5 @@
-#ifndef DOUGLAS_PEUCKER_HPP_
-#define DOUGLAS_PEUCKER_HPP_
+#ifndef OSRM_UTIL_DOUGLAS_PEUCKER_HPP_
+#define OSRM_UTIL_DOUGLAS_PEUCKER_HPP_
 
 #include "util/coordinate.hpp"
 
@@ -8,7 +8,7 @@
 
 namespace osrm
 {
-namespace engine
+namespace util
 {
 namespace detail
 {
@@ -65,17 +65,17 @@ const constexpr auto DOUGLAS_PEUCKER_THRESHOLDS_SIZE =
 // Input is vector of pairs. Each pair consists of the point information and a
 // bit indicating if the points is present in the generalization.
 // Note: points may also be pre-selected*/
-std::vector<util::Coordinate> douglasPeucker(std::vector<util::Coordinate>::const_iterator begin,
-                                             std::vector<util::Coordinate>::const_iterator end,
-                                             const unsigned zoom_level);
+std::vector<Coordinate> douglasPeucker(std::vector<Coordinate>::const_iterator begin,
+                                       std::vector<Coordinate>::const_iterator end,
+                                       const unsigned zoom_level);
 
 // Convenience range-based function
-inline std::vector<util::Coordinate> douglasPeucker(const std::vector<util::Coordinate> &geometry,
-                                                    const unsigned zoom_level)
+inline std::vector<Coordinate> douglasPeucker(const std::vector<Coordinate> &geometry,
+                                              const unsigned zoom_level)
 {
     return douglasPeucker(begin(geometry), end(geometry), zoom_level);
 }
 }
 }
 
-#endif /* DOUGLAS_PEUCKER_HPP_ */
+#endif /* OSRM_UTIL_DOUGLAS_PEUCKER_HPP_ */
@@ -6,9 +6,12 @@
 #include "extractor/suffix_table.hpp"
 #include "util/attributes.hpp"
 #include "util/name_table.hpp"
+#include "util/string_view.hpp"
 #include "util/typedefs.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -26,13 +29,24 @@ namespace guidance
 // Name Change Logic
 // Used both during Extraction as well as during Post-Processing
 
-inline std::string longest_common_substring(const std::string &lhs, const std::string &rhs)
+// Returns the longest common substring as a view into lhs
+inline StringView longest_common_substring(const StringView lhs, const StringView rhs)
 {
     if (lhs.empty() || rhs.empty())
-        return "";
-
-    // array for dynamic programming
-    std::vector<std::uint32_t> dp_previous(rhs.size(), 0), dp_current(rhs.size(), 0);
+        return StringView();
+
+    // rows of the dynamic programming table, names are short enough to keep them on the stack
+    const constexpr std::size_t MAX_STACK_SIZE = 64;
+    std::array<std::uint32_t, 2 * MAX_STACK_SIZE> stack_rows;
+    std::vector<std::uint32_t> heap_rows;
+    std::uint32_t *dp_previous = stack_rows.data();
+    if (rhs.size() > MAX_STACK_SIZE)
+    {
+        heap_rows.resize(2 * rhs.size());
+        dp_previous = heap_rows.data();
+    }
+    std::uint32_t *dp_current = dp_previous + rhs.size();
+    std::fill(dp_previous, dp_previous + 2 * rhs.size(), 0);
 
     // to remember the best location
     std::uint32_t best = 0;
@@ -58,30 +72,32 @@ inline std::string longest_common_substring(const std::string &lhs, const std::s
     return lhs.substr(best_pos - best, best);
 }
 
+inline std::string longest_common_substring(const std::string &lhs, const std::string &rhs)
+{
+    return longest_common_substring(StringView(lhs), StringView(rhs)).to_string();
+}
+
 // TODO US-ASCII support only, no UTF-8 support
 // While UTF-8 might work in some cases, we do not guarantee full functionality
-inline auto decompose(const std::string &lhs, const std::string &rhs)
+//
+// Returns the prefixes and suffixes around the longest common substring of both names as views
+// into them. Spaces are trimmed, the case is left as is.
+inline auto decompose(const StringView lhs, const StringView rhs)
 {
-    auto const lcs = longest_common_substring(lhs, rhs);
+    const auto trim = [](const StringView str) {
+        auto front = str.find_first_not_of(' ');
 
-    // trim spaces, transform to lower
-    const auto trim = [](auto str) {
-        // we compare suffixes based on this value, it might break UTF chars, but as long as we are
-        // consistent in handling, we do not create bad results
-        boost::to_lower(str);
-        auto front = str.find_first_not_of(" ");
-
-        if (front == std::string::npos)
+        if (front == StringView::npos)
             return str;
 
-        auto back = str.find_last_not_of(" ");
+        auto back = str.find_last_not_of(' ');
         return str.substr(front, back - front + 1);
     };
 
+    auto const lcs = longest_common_substring(lhs, rhs);
     if (lcs.empty())
     {
-        std::string empty = "";
-        return std::make_tuple(trim(lhs), trim(rhs), empty, empty);
+        return std::make_tuple(trim(lhs), trim(rhs), StringView(), StringView());
     }
 
     // find the common substring in both
@@ -91,33 +107,23 @@ inline auto decompose(const std::string &lhs, const std::string &rhs)
     BOOST_ASSERT(lhs_pos + lcs.size() <= lhs.size());
     BOOST_ASSERT(rhs_pos + lcs.size() <= rhs.size());
 
-    // prefixes
-    std::string lhs_prefix = (lhs_pos > 0) ? lhs.substr(0, lhs_pos) : "";
-    std::string rhs_prefix = (rhs_pos > 0) ? rhs.substr(0, rhs_pos) : "";
-
-    // suffices
-    std::string lhs_suffix = lhs.substr(lhs_pos + lcs.size());
-    std::string rhs_suffix = rhs.substr(rhs_pos + lcs.size());
-
-    lhs_prefix = trim(std::move(lhs_prefix));
-    lhs_suffix = trim(std::move(lhs_suffix));
-    rhs_prefix = trim(std::move(rhs_prefix));
-    rhs_suffix = trim(std::move(rhs_suffix));
-
-    return std::make_tuple(lhs_prefix, lhs_suffix, rhs_prefix, rhs_suffix);
+    return std::make_tuple(trim(lhs.substr(0, lhs_pos)),
+                           trim(lhs.substr(lhs_pos + lcs.size())),
+                           trim(rhs.substr(0, rhs_pos)),
+                           trim(rhs.substr(rhs_pos + lcs.size())));
 }
 
 // Note: there is an overload without suffix checking below.
 // (that's the reason we template the suffix table here)
 template <typename SuffixTable>
-inline bool requiresNameAnnounced(const std::string &from_name,
-                                  const std::string &from_ref,
-                                  const std::string &from_pronunciation,
-                                  const std::string &from_exits,
-                                  const std::string &to_name,
-                                  const std::string &to_ref,
-                                  const std::string &to_pronunciation,
-                                  const std::string &to_exits,
+inline bool requiresNameAnnounced(const StringView from_name,
+                                  const StringView from_ref,
+                                  const StringView from_pronunciation,
+                                  const StringView from_exits,
+                                  const StringView to_name,
+                                  const StringView to_ref,
+                                  const StringView to_pronunciation,
+                                  const StringView to_exits,
                                   const SuffixTable &suffix_table)
 {
     // first is empty and the second is not
@@ -130,17 +136,22 @@ inline bool requiresNameAnnounced(const std::string &from_name,
 
     // check similarity of names
     const auto names_are_empty = from_name.empty() && to_name.empty();
-    const auto name_is_contained =
-        boost::starts_with(from_name, to_name) || boost::starts_with(to_name, from_name);
+    const auto name_is_contained = from_name.starts_with(to_name) || to_name.starts_with(from_name);
 
     const auto checkForPrefixOrSuffixChange =
-        [](const std::string &first, const std::string &second, const SuffixTable &suffix_table) {
-            std::string first_prefix, first_suffix, second_prefix, second_suffix;
+        [](const StringView first, const StringView second, const SuffixTable &suffix_table) {
+            // equal names have neither prefixes nor suffixes around their common part
+            if (first == second)
+                return true;
+
+            StringView first_prefix, first_suffix, second_prefix, second_suffix;
             std::tie(first_prefix, first_suffix, second_prefix, second_suffix) =
                 decompose(first, second);
 
-            const auto checkTable = [&](const std::string &str) {
-                return str.empty() || suffix_table.isSuffix(str);
+            // the suffix table is lower case, short suffixes fit into the string without
+            // allocating
+            const auto checkTable = [&](const StringView str) {
+                return str.empty() || suffix_table.isSuffix(boost::to_lower_copy(str.to_string()));
             };
 
             return checkTable(first_prefix) && checkTable(first_suffix) &&
@@ -154,7 +165,7 @@ inline bool requiresNameAnnounced(const std::string &from_name,
     const auto refs_are_empty = from_ref.empty() && to_ref.empty();
     const auto ref_is_contained =
         from_ref.empty() || to_ref.empty() ||
-        (from_ref.find(to_ref) != std::string::npos || to_ref.find(from_ref) != std::string::npos);
+        (from_ref.find(to_ref) != StringView::npos || to_ref.find(from_ref) != StringView::npos);
     const auto ref_is_removed = !from_ref.empty() && to_ref.empty();
 
     const auto obvious_change =
@@ -188,15 +199,15 @@ inline bool requiresNameAnnounced(const std::string &from_name,
            (exits_change && !looses_exit);
 }
 
-// Overload without suffix checking
-inline bool requiresNameAnnounced(const std::string &from_name,
-                                  const std::string &from_ref,
-                                  const std::string &from_pronunciation,
-                                  const std::string &from_exits,
-                                  const std::string &to_name,
-                                  const std::string &to_ref,
-                                  const std::string &to_pronunciation,
-                                  const std::string &to_exits)
+// Overload without suffix checking, for views into the name table as kept by the route steps
+inline bool requiresNameAnnounced(const StringView from_name,
+                                  const StringView from_ref,
+                                  const StringView from_pronunciation,
+                                  const StringView from_exits,
+                                  const StringView to_name,
+                                  const StringView to_ref,
+                                  const StringView to_pronunciation,
+                                  const StringView to_exits)
 {
     // Dummy since we need to provide a SuffixTable but do not have the data for it.
     // (Guidance Post-Processing does not keep the suffix table around at the moment)
@@ -217,6 +228,25 @@ inline bool requiresNameAnnounced(const std::string &from_name,
                                  table);
 }
 
+inline bool requiresNameAnnounced(const std::string &from_name,
+                                  const std::string &from_ref,
+                                  const std::string &from_pronunciation,
+                                  const std::string &from_exits,
+                                  const std::string &to_name,
+                                  const std::string &to_ref,
+                                  const std::string &to_pronunciation,
+                                  const std::string &to_exits)
+{
+    return requiresNameAnnounced(StringView(from_name),
+                                 StringView(from_ref),
+                                 StringView(from_pronunciation),
+                                 StringView(from_exits),
+                                 StringView(to_name),
+                                 StringView(to_ref),
+                                 StringView(to_pronunciation),
+                                 StringView(to_exits));
+}
+
 inline bool requiresNameAnnounced(const NameID from_name_id,
                                   const NameID to_name_id,
                                   const util::NameTable &name_table,
@@ -225,18 +255,17 @@ inline bool requiresNameAnnounced(const NameID from_name_id,
     if (from_name_id == to_name_id)
         return false;
     else
-        return requiresNameAnnounced(name_table.GetNameForID(from_name_id).to_string(),
-                                     name_table.GetRefForID(from_name_id).to_string(),
-                                     name_table.GetPronunciationForID(from_name_id).to_string(),
-                                     name_table.GetExitsForID(from_name_id).to_string(),
+        return requiresNameAnnounced(name_table.GetNameForID(from_name_id),
+                                     name_table.GetRefForID(from_name_id),
+                                     name_table.GetPronunciationForID(from_name_id),
+                                     name_table.GetExitsForID(from_name_id),
                                      //
-                                     name_table.GetNameForID(to_name_id).to_string(),
-                                     name_table.GetRefForID(to_name_id).to_string(),
-                                     name_table.GetPronunciationForID(to_name_id).to_string(),
-                                     name_table.GetExitsForID(to_name_id).to_string(),
+                                     name_table.GetNameForID(to_name_id),
+                                     name_table.GetRefForID(to_name_id),
+                                     name_table.GetPronunciationForID(to_name_id),
+                                     name_table.GetExitsForID(to_name_id),
                                      //
                                      suffix_table);
-    // FIXME: converts StringViews to strings since the name change heuristics mutates in place
 }
 
 inline bool requiresNameAnnounced(const NameID from_name_id,
@@ -246,16 +275,15 @@ inline bool requiresNameAnnounced(const NameID from_name_id,
     if (from_name_id == to_name_id)
         return false;
     else
-        return requiresNameAnnounced(name_table.GetNameForID(from_name_id).to_string(),
-                                     name_table.GetRefForID(from_name_id).to_string(),
-                                     name_table.GetPronunciationForID(from_name_id).to_string(),
-                                     name_table.GetExitsForID(from_name_id).to_string(),
+        return requiresNameAnnounced(name_table.GetNameForID(from_name_id),
+                                     name_table.GetRefForID(from_name_id),
+                                     name_table.GetPronunciationForID(from_name_id),
+                                     name_table.GetExitsForID(from_name_id),
                                      //
-                                     name_table.GetNameForID(to_name_id).to_string(),
-                                     name_table.GetRefForID(to_name_id).to_string(),
-                                     name_table.GetExitsForID(to_name_id).to_string(),
-                                     name_table.GetPronunciationForID(to_name_id).to_string());
-    // FIXME: converts StringViews to strings since the name change heuristics mutates in place
+                                     name_table.GetNameForID(to_name_id),
+                                     name_table.GetRefForID(to_name_id),
+                                     name_table.GetExitsForID(to_name_id),
+                                     name_table.GetPronunciationForID(to_name_id));
 }
 
 } // namespace guidance
@@ -5,6 +5,7 @@
 #define JSON_RENDERER_HPP
 
 #include "util/cast.hpp"
+#include "util/json_writer.hpp"
 #include "util/string_util.hpp"
 
 #include "osrm/json_container.hpp"
@@ -79,87 +80,50 @@ struct Renderer
 
 struct ArrayRenderer
 {
-    explicit ArrayRenderer(std::vector<char> &_out) : out(_out) {}
+    explicit ArrayRenderer(Writer &_writer) : writer(_writer) {}
 
-    void operator()(const String &string) const
-    {
-        out.push_back('\"');
-        const auto string_to_insert = escape_JSON(string.value);
-        out.insert(std::end(out), std::begin(string_to_insert), std::end(string_to_insert));
-        out.push_back('\"');
-    }
+    void operator()(const String &string) const { writer.String(string.value); }
 
-    void operator()(const Number &number) const
-    {
-        const std::string number_string = cast::to_string_with_precision(number.value);
-        out.insert(out.end(), number_string.begin(), number_string.end());
-    }
+    void operator()(const Number &number) const { writer.Number(number.value); }
 
     void operator()(const Object &object) const
     {
-        out.push_back('{');
-        for (auto it = object.values.begin(), end = object.values.end(); it != end;)
+        writer.StartObject();
+        for (const auto &key_value : object.values)
         {
-            out.push_back('\"');
-            out.insert(out.end(), it->first.begin(), it->first.end());
-            out.push_back('\"');
-            out.push_back(':');
-
-            mapbox::util::apply_visitor(ArrayRenderer(out), it->second);
-            if (++it != end)
-            {
-                out.push_back(',');
-            }
+            writer.Key(key_value.first);
+            mapbox::util::apply_visitor(*this, key_value.second);
         }
-        out.push_back('}');
+        writer.EndObject();
     }
 
     void operator()(const Array &array) const
     {
-        out.push_back('[');
-        for (auto it = array.values.cbegin(), end = array.values.cend(); it != end;)
+        writer.StartArray();
+        for (const auto &value : array.values)
         {
-            mapbox::util::apply_visitor(ArrayRenderer(out), *it);
-            if (++it != end)
-            {
-                out.push_back(',');
-            }
+            mapbox::util::apply_visitor(*this, value);
         }
-        out.push_back(']');
+        writer.EndArray();
     }
 
-    void operator()(const True &) const
-    {
-        const std::string temp("true");
-        out.insert(out.end(), temp.begin(), temp.end());
-    }
+    void operator()(const True &) const { writer.Bool(true); }
 
-    void operator()(const False &) const
-    {
-        const std::string temp("false");
-        out.insert(out.end(), temp.begin(), temp.end());
-    }
+    void operator()(const False &) const { writer.Bool(false); }
 
-    void operator()(const Null &) const
-    {
-        const std::string temp("null");
-        out.insert(out.end(), temp.begin(), temp.end());
-    }
+    void operator()(const Null &) const { writer.Null(); }
 
   private:
-    std::vector<char> &out;
+    Writer &writer;
 };
 
-inline void render(std::ostream &out, const Object &object)
-{
-    Value value = object;
-    mapbox::util::apply_visitor(Renderer(out), value);
-}
+inline void render(std::ostream &out, const Object &object) { Renderer{out}(object); }
 
+// renders straight into the buffer, the object is not copied
 inline void render(std::vector<char> &out, const Object &object)
 {
-    Value value = object;
-    mapbox::util::apply_visitor(ArrayRenderer(out), value);
+    Writer writer(out);
+    ArrayRenderer{writer}(object);
 }
 
 } // namespace json
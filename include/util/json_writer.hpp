@@ -0,0 +1,226 @@
+#ifndef JSON_WRITER_HPP
+#define JSON_WRITER_HPP
+
+#include <boost/assert.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+namespace json
+{
+
+/**
+ * Streaming JSON writer that appends to a character buffer.
+ *
+ * Values are written in the order they are passed in, commas and colons are inserted as
+ * needed. Numbers are formatted like cast::to_string_with_precision but without going through
+ * a stringstream, strings are escaped like escape_JSON without a temporary copy.
+ */
+class Writer
+{
+  public:
+    explicit Writer(std::vector<char> &out_) : out(out_) {}
+
+    void StartObject()
+    {
+        Separate();
+        out.push_back('{');
+        needs_comma = false;
+    }
+
+    void EndObject()
+    {
+        out.push_back('}');
+        needs_comma = true;
+    }
+
+    void StartArray()
+    {
+        Separate();
+        out.push_back('[');
+        needs_comma = false;
+    }
+
+    void EndArray()
+    {
+        out.push_back(']');
+        needs_comma = true;
+    }
+
+    // Keys are written as they are, the length of literals is known at compile time
+    template <std::size_t N> void Key(const char (&key)[N]) { WriteKey(key, N - 1); }
+    void Key(const std::string &key) { WriteKey(key.data(), key.size()); }
+
+    void String(const std::string &value)
+    {
+        Separate();
+        out.push_back('"');
+        for (const char letter : value)
+        {
+            switch (letter)
+            {
+            case '\\':
+                Append("\\\\", 2);
+                break;
+            case '"':
+                Append("\\\"", 2);
+                break;
+            case '/':
+                Append("\\/", 2);
+                break;
+            case '\b':
+                Append("\\b", 2);
+                break;
+            case '\f':
+                Append("\\f", 2);
+                break;
+            case '\n':
+                Append("\\n", 2);
+                break;
+            case '\r':
+                Append("\\r", 2);
+                break;
+            case '\t':
+                Append("\\t", 2);
+                break;
+            default:
+                out.push_back(letter);
+                break;
+            }
+        }
+        out.push_back('"');
+        needs_comma = true;
+    }
+
+    // Fixed notation with six decimals and without trailing zeros
+    void Number(const double value)
+    {
+        Separate();
+        // integral values are the common case for ids, counts and rounded durations
+        if (value == std::floor(value) && std::abs(value) < MAX_EXACT_INTEGER &&
+            !(value == 0 && std::signbit(value)))
+        {
+            AppendInteger(static_cast<std::int64_t>(value));
+        }
+        else
+        {
+            // the default C locale uses '.' as separator, same as the stringstream did
+            char buffer[FORMAT_BUFFER_SIZE];
+            const auto length = std::snprintf(buffer, sizeof(buffer), "%.6f", value);
+            BOOST_ASSERT(length > 0);
+            if (length >= static_cast<int>(sizeof(buffer)))
+            {
+                std::vector<char> big_buffer(length + 1);
+                std::snprintf(big_buffer.data(), big_buffer.size(), "%.6f", value);
+                AppendTrimmed(big_buffer.data(), length);
+            }
+            else
+            {
+                AppendTrimmed(buffer, length);
+            }
+        }
+        needs_comma = true;
+    }
+
+    void Bool(const bool value)
+    {
+        Separate();
+        if (value)
+            Append("true", 4);
+        else
+            Append("false", 5);
+        needs_comma = true;
+    }
+
+    void Null()
+    {
+        Separate();
+        Append("null", 4);
+        needs_comma = true;
+    }
+
+  private:
+    static constexpr double MAX_EXACT_INTEGER = 9007199254740992.; // 2^53
+    static constexpr std::size_t FORMAT_BUFFER_SIZE = 64;
+
+    void Separate()
+    {
+        if (needs_comma)
+        {
+            out.push_back(',');
+        }
+    }
+
+    void Append(const char *data, const std::size_t size)
+    {
+        out.insert(out.end(), data, data + size);
+    }
+
+    void WriteKey(const char *key, const std::size_t size)
+    {
+        Separate();
+        out.push_back('"');
+        Append(key, size);
+        out.push_back('"');
+        out.push_back(':');
+        needs_comma = false;
+    }
+
+    void AppendInteger(std::int64_t value)
+    {
+        char buffer[24];
+        char *end = buffer + sizeof(buffer);
+        char *begin = end;
+        const bool negative = value < 0;
+        // work with negative values to avoid overflowing on the most negative value
+        if (!negative)
+        {
+            value = -value;
+        }
+        do
+        {
+            *--begin = '0' - static_cast<char>(value % 10);
+            value /= 10;
+        } while (value != 0);
+        if (negative)
+        {
+            *--begin = '-';
+        }
+        Append(begin, end - begin);
+    }
+
+    // X.Y000000 -> X.Y and X.000000 -> X, nan and inf are kept as they are
+    void AppendTrimmed(const char *buffer, std::size_t length)
+    {
+        if (std::memchr(buffer, '.', length) != nullptr)
+        {
+            while (length > 0 && buffer[length - 1] == '0')
+            {
+                --length;
+            }
+            if (length > 0 && buffer[length - 1] == '.')
+            {
+                --length;
+            }
+        }
+        Append(buffer, length);
+    }
+
+    std::vector<char> &out;
+    bool needs_comma = false;
+};
+
+} // namespace json
+} // namespace util
+} // namespace osrm
+
+#endif // JSON_WRITER_HPP
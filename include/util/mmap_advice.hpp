@@ -0,0 +1,27 @@
+#ifndef OSRM_UTIL_MMAP_ADVICE_HPP
+#define OSRM_UTIL_MMAP_ADVICE_HPP
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * Hints on how a memory mapped file is going to be accessed.
+ *
+ * By default pages are faulted in lazily on first access. This is cheap at startup
+ * but means that the first queries touching a page pay for the disk read.
+ */
+struct MMapAdvice
+{
+    // Fault in all pages of the mapping on load (same effect as MAP_POPULATE)
+    bool populate = false;
+    // Back the mapping with transparent huge pages if the kernel supports it
+    bool huge_pages = false;
+    // Issue read-ahead hints for ranges right before they are accessed
+    bool prefetch = false;
+};
+}
+}
+
+#endif
@@ -3,16 +3,103 @@
 
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
+#include "util/mmap_advice.hpp"
 #include "util/vector_view.hpp"
 
 #include <boost/filesystem/path.hpp>
 #include <boost/iostreams/device/mapped_file.hpp>
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+
 namespace osrm
 {
 namespace util
 {
 
+namespace detail
+{
+inline std::size_t pageSize()
+{
+#ifndef _WIN32
+    static const std::size_t page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return page_size;
+#else
+    return 4096;
+#endif
+}
+
+// madvise needs page aligned addresses, so we extend the range to the enclosing pages
+inline void adviseRange(const char *begin, const char *end, int advice)
+{
+#ifndef _WIN32
+    const auto page_mask = ~(static_cast<std::uintptr_t>(pageSize()) - 1);
+    const auto aligned_begin = reinterpret_cast<std::uintptr_t>(begin) & page_mask;
+    const auto aligned_end = reinterpret_cast<std::uintptr_t>(end);
+    if (aligned_end > aligned_begin)
+    {
+        // the advice is only a hint, failing to apply it is not an error
+        ::madvise(reinterpret_cast<void *>(aligned_begin), aligned_end - aligned_begin, advice);
+    }
+#else
+    (void)begin;
+    (void)end;
+    (void)advice;
+#endif
+}
+}
+
+/**
+ * Applies the advice to a freshly mapped region. Populating walks every page once,
+ * so the call blocks until the whole region is resident.
+ */
+inline void adviseMappedRegion(const char *data, const std::size_t size, const MMapAdvice &advice)
+{
+    if (data == nullptr || size == 0)
+        return;
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (advice.huge_pages)
+    {
+        detail::adviseRange(data, data + size, MADV_HUGEPAGE);
+    }
+#endif
+
+    if (advice.populate)
+    {
+#ifndef _WIN32
+        detail::adviseRange(data, data + size, MADV_WILLNEED);
+#endif
+        // MADV_WILLNEED only schedules the read-ahead, touching every page
+        // makes sure the page table entries are actually populated
+        volatile char sink = 0;
+        for (std::size_t offset = 0; offset < size; offset += detail::pageSize())
+        {
+            sink += data[offset];
+        }
+        (void)sink;
+    }
+}
+
+/**
+ * Tells the kernel that [data, data + size) is going to be read soon. This does not
+ * block, the pages are read in the background.
+ */
+inline void prefetchMappedRange(const char *data, const std::size_t size)
+{
+#ifndef _WIN32
+    detail::adviseRange(data, data + size, MADV_WILLNEED);
+#else
+    (void)data;
+    (void)size;
+#endif
+}
+
 namespace detail
 {
 template <typename T, typename RegionT>
@@ -5,6 +5,7 @@
 #include "util/packed_vector.hpp"
 #include "util/range_table.hpp"
 #include "util/static_graph.hpp"
+#include "util/static_grid.hpp"
 
 #include "storage/io.hpp"
 #include "storage/serialization.hpp"
@@ -62,6 +63,24 @@ inline void write(storage::io::FileWriter &writer, const StaticGraph<EdgeDataT,
     storage::serialization::write(writer, graph.edge_array);
 }
 
+template <typename EdgeDataT, storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader,
+                 detail::StaticGridImpl<EdgeDataT, Ownership> &grid)
+{
+    reader.ReadInto(grid.header);
+    storage::serialization::read(reader, grid.cell_offsets);
+    storage::serialization::read(reader, grid.entries);
+}
+
+template <typename EdgeDataT, storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::StaticGridImpl<EdgeDataT, Ownership> &grid)
+{
+    writer.WriteOne(grid.header);
+    storage::serialization::write(writer, grid.cell_offsets);
+    storage::serialization::write(writer, grid.entries);
+}
+
 template <typename EdgeDataT>
 inline void read(storage::io::FileReader &reader, DynamicGraph<EdgeDataT> &graph)
 {
@@ -0,0 +1,290 @@
+#ifndef OSRM_UTIL_STATIC_GRID_HPP
+#define OSRM_UTIL_STATIC_GRID_HPP
+
+#include "util/coordinate.hpp"
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+#include "util/web_mercator.hpp"
+
+#include "storage/io_fwd.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+namespace detail
+{
+template <typename EdgeDataT, storage::Ownership Ownership> class StaticGridImpl;
+}
+
+template <typename EdgeDataT>
+using StaticGrid = detail::StaticGridImpl<EdgeDataT, storage::Ownership::Container>;
+template <typename EdgeDataT>
+using StaticGridView = detail::StaticGridImpl<EdgeDataT, storage::Ownership::View>;
+
+namespace serialization
+{
+template <typename EdgeDataT, storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader,
+                 detail::StaticGridImpl<EdgeDataT, Ownership> &grid);
+template <typename EdgeDataT, storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::StaticGridImpl<EdgeDataT, Ownership> &grid);
+}
+
+namespace detail
+{
+
+/***
+ * Fixed-resolution grid over the segments stored in the StaticRTree.
+ *
+ * Every cell lists all segments passing through it, together with the coordinates
+ * of their end points. A query inside a dense area can then be answered from a
+ * single cell without walking the r-tree or looking up the coordinate list:
+ * every segment closer than the distance to the cell border is in that cell,
+ * so those candidates are known to be the nearest overall.
+ *
+ * Like the r-tree all computations are done in fixed-point web mercator coordinates.
+ */
+template <typename EdgeDataT, storage::Ownership Ownership> class StaticGridImpl
+{
+    template <typename T> using Vector = ViewOrVector<T, Ownership>;
+
+    // Slack in fixed-point units to account for rounding of projected coordinates
+    static constexpr std::int32_t MARGIN = 2;
+
+  public:
+    // A grid of 64M cells needs 256 MiB of offsets alone. Larger grids are most likely
+    // a misconfiguration of the cell size for the extract at hand.
+    static constexpr std::uint64_t MAX_NUMBER_OF_CELLS = 1ULL << 26;
+
+    struct Header
+    {
+        std::int32_t min_lon;
+        std::int32_t min_lat;
+        std::int32_t cell_size;
+        std::uint32_t num_columns;
+        std::uint32_t num_rows;
+    };
+
+    struct Entry
+    {
+        EdgeDataT data;
+        Coordinate u;
+        Coordinate v;
+    };
+
+    struct Cell
+    {
+        boost::iterator_range<const Entry *> entries;
+        // All segments closer than this to the query coordinate are part of the cell
+        std::uint64_t squared_radius;
+    };
+
+    StaticGridImpl() : header{0, 0, 0, 0, 0} {}
+
+    StaticGridImpl(Header header_, Vector<std::uint32_t> cell_offsets_, Vector<Entry> entries_)
+        : header(std::move(header_)), cell_offsets(std::move(cell_offsets_)),
+          entries(std::move(entries_))
+    {
+    }
+
+    // Builds a grid over all segments with cells of cell_size fixed-point units
+    template <typename = std::enable_if<Ownership == storage::Ownership::Container>>
+    StaticGridImpl(const std::vector<EdgeDataT> &segments,
+                   const std::vector<Coordinate> &coordinates,
+                   const std::int32_t cell_size)
+    {
+        BOOST_ASSERT(cell_size > 0);
+
+        std::vector<Coordinate> projected(coordinates.size());
+        std::transform(coordinates.begin(),
+                       coordinates.end(),
+                       projected.begin(),
+                       [](const Coordinate coordinate) {
+                           return Coordinate{web_mercator::fromWGS84(coordinate)};
+                       });
+
+        std::int64_t min_lon = std::numeric_limits<std::int32_t>::max();
+        std::int64_t min_lat = std::numeric_limits<std::int32_t>::max();
+        std::int64_t max_lon = std::numeric_limits<std::int32_t>::min();
+        std::int64_t max_lat = std::numeric_limits<std::int32_t>::min();
+        for (const auto &segment : segments)
+        {
+            for (const auto node : {segment.u, segment.v})
+            {
+                min_lon = std::min<std::int64_t>(min_lon, toFixed(projected[node].lon));
+                min_lat = std::min<std::int64_t>(min_lat, toFixed(projected[node].lat));
+                max_lon = std::max<std::int64_t>(max_lon, toFixed(projected[node].lon));
+                max_lat = std::max<std::int64_t>(max_lat, toFixed(projected[node].lat));
+            }
+        }
+
+        if (segments.empty())
+        {
+            header = {0, 0, cell_size, 0, 0};
+            cell_offsets.resize(1, 0);
+            return;
+        }
+
+        const std::uint64_t num_columns = (max_lon - min_lon) / cell_size + 1;
+        const std::uint64_t num_rows = (max_lat - min_lat) / cell_size + 1;
+        if (num_columns * num_rows > MAX_NUMBER_OF_CELLS)
+        {
+            throw util::exception("Spatial grid would need " +
+                                  std::to_string(num_columns * num_rows) +
+                                  " cells, increase the cell size" + SOURCE_REF);
+        }
+
+        header = {static_cast<std::int32_t>(min_lon),
+                  static_cast<std::int32_t>(min_lat),
+                  cell_size,
+                  static_cast<std::uint32_t>(num_columns),
+                  static_cast<std::uint32_t>(num_rows)};
+
+        // Counting sort of segments into cells: count, prefix sum, then fill
+        std::vector<std::uint64_t> counts(num_columns * num_rows + 1, 0);
+        for (const auto &segment : segments)
+        {
+            ForEachCell(projected[segment.u],
+                        projected[segment.v],
+                        [&counts](const std::size_t cell) { counts[cell + 1]++; });
+        }
+        std::partial_sum(counts.begin(), counts.end(), counts.begin());
+        if (counts.back() > std::numeric_limits<std::uint32_t>::max())
+        {
+            throw util::exception("Spatial grid would need " + std::to_string(counts.back()) +
+                                  " entries, increase the cell size" + SOURCE_REF);
+        }
+        cell_offsets.assign(counts.begin(), counts.end());
+
+        entries.resize(cell_offsets.back());
+        std::vector<std::uint32_t> fill_positions(cell_offsets.begin(), cell_offsets.end() - 1);
+        for (const auto &segment : segments)
+        {
+            const Entry entry{segment, coordinates[segment.u], coordinates[segment.v]};
+            ForEachCell(projected[segment.u],
+                        projected[segment.v],
+                        [this, &entry, &fill_positions](const std::size_t cell) {
+                            entries[fill_positions[cell]++] = entry;
+                        });
+        }
+    }
+
+    bool Empty() const { return entries.empty(); }
+
+    // Returns the cell containing the given fixed-point web mercator coordinate.
+    // Coordinates outside of the grid return an empty cell with zero radius.
+    Cell GetCell(const Coordinate fixed_projected_coordinate) const
+    {
+        const std::int64_t lon = toFixed(fixed_projected_coordinate.lon) - header.min_lon;
+        const std::int64_t lat = toFixed(fixed_projected_coordinate.lat) - header.min_lat;
+        if (Empty() || lon < 0 || lat < 0)
+        {
+            return {{nullptr, nullptr}, 0};
+        }
+
+        const std::int64_t column = lon / header.cell_size;
+        const std::int64_t row = lat / header.cell_size;
+        if (column >= header.num_columns || row >= header.num_rows)
+        {
+            return {{nullptr, nullptr}, 0};
+        }
+
+        const std::int64_t to_border = std::min({lon - column * header.cell_size,
+                                                 (column + 1) * header.cell_size - lon,
+                                                 lat - row * header.cell_size,
+                                                 (row + 1) * header.cell_size - lat}) -
+                                       MARGIN;
+        const std::uint64_t radius = std::max<std::int64_t>(0, to_border);
+
+        const auto cell = row * header.num_columns + column;
+        BOOST_ASSERT(static_cast<std::size_t>(cell + 1) < cell_offsets.size());
+        const auto first = entries.data() + cell_offsets[cell];
+        const auto last = entries.data() + cell_offsets[cell + 1];
+        return {{first, last}, radius * radius};
+    }
+
+    const Header &GetHeader() const { return header; }
+
+    friend void serialization::read<EdgeDataT, Ownership>(storage::io::FileReader &reader,
+                                                          StaticGridImpl &grid);
+    friend void serialization::write<EdgeDataT, Ownership>(storage::io::FileWriter &writer,
+                                                           const StaticGridImpl &grid);
+
+  private:
+    template <typename T> static std::int64_t toFixed(const T value)
+    {
+        return static_cast<std::int32_t>(value);
+    }
+
+    // Calls func for every cell the segment (expanded by MARGIN) passes through.
+    // Walks the columns of the bounding box and only visits the rows that the
+    // segment covers in each column, so long diagonal segments stay cheap.
+    template <typename FuncT>
+    void ForEachCell(const Coordinate projected_u, const Coordinate projected_v, FuncT func) const
+    {
+        const double x0 = toFixed(projected_u.lon) - header.min_lon;
+        const double y0 = toFixed(projected_u.lat) - header.min_lat;
+        const double x1 = toFixed(projected_v.lon) - header.min_lon;
+        const double y1 = toFixed(projected_v.lat) - header.min_lat;
+        const double cell_size = header.cell_size;
+
+        const auto clamp = [](const double value, const std::uint32_t size) {
+            return static_cast<std::uint32_t>(
+                std::max(0., std::min(std::floor(value), static_cast<double>(size) - 1)));
+        };
+
+        const auto first_column =
+            clamp((std::min(x0, x1) - MARGIN) / cell_size, header.num_columns);
+        const auto last_column =
+            clamp((std::max(x0, x1) + MARGIN) / cell_size, header.num_columns);
+        for (const auto column : irange<std::uint32_t>(first_column, last_column + 1))
+        {
+            double y_first = y0;
+            double y_last = y1;
+            if (x0 != x1)
+            {
+                const double left = column * cell_size - MARGIN;
+                const double right = (column + 1) * cell_size + MARGIN;
+                const double t_left = std::max(0., std::min(1., (left - x0) / (x1 - x0)));
+                const double t_right = std::max(0., std::min(1., (right - x0) / (x1 - x0)));
+                y_first = y0 + t_left * (y1 - y0);
+                y_last = y0 + t_right * (y1 - y0);
+            }
+
+            const auto first_row =
+                clamp((std::min(y_first, y_last) - MARGIN) / cell_size, header.num_rows);
+            const auto last_row =
+                clamp((std::max(y_first, y_last) + MARGIN) / cell_size, header.num_rows);
+            for (const auto row : irange<std::uint32_t>(first_row, last_row + 1))
+            {
+                func(static_cast<std::size_t>(row) * header.num_columns + column);
+            }
+        }
+    }
+
+    Header header;
+    Vector<std::uint32_t> cell_offsets;
+    Vector<Entry> entries;
+};
+}
+}
+}
+
+#endif // OSRM_UTIL_STATIC_GRID_HPP
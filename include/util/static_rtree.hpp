@@ -28,6 +28,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <limits>
 #include <memory>
 #include <queue>
@@ -49,6 +50,13 @@ namespace osrm
 namespace util
 {
 
+namespace detail
+{
+// Written in front of the tree nodes in the .ramIndex file. Files from before the big component
+// flag was packed into the nodes start with the node count instead and are rejected on load.
+constexpr std::uint64_t RTREE_FILE_FORMAT = 0x324545525452534fULL;
+}
+
 /***
  * Static RTree for serving nearest neighbour queries
  * // All coordinates are pojected first to Web Mercator before the bounding boxes
@@ -170,7 +178,36 @@ class StaticRTree
     struct TreeNode
     {
         Rectangle minimum_bounding_rectangle;
+
+        // Set if any element below this node is part of a big component. Searches that
+        // only look for big components anymore can skip the node otherwise.
+        // The flag is stored in the lowest bit of min_lon so the node stays 16 bytes. Setting
+        // it moves min_lon down by at most one unit, which only ever grows the rectangle.
+        bool HasBigComponent() const
+        {
+            return (static_cast<std::int32_t>(minimum_bounding_rectangle.min_lon) & 1) != 0;
+        }
+
+        void SetBigComponent(const bool has_big_component)
+        {
+            const auto min_lon = static_cast<std::int32_t>(minimum_bounding_rectangle.min_lon);
+            minimum_bounding_rectangle.min_lon =
+                FixedLongitude{min_lon - ((min_lon ^ (has_big_component ? 1 : 0)) & 1)};
+        }
     };
+    static_assert(sizeof(TreeNode) == sizeof(Rectangle), "TreeNode must not grow");
+
+    static void ReadFileFormat(storage::io::FileReader &tree_node_file,
+                               const boost::filesystem::path &node_file)
+    {
+        if (tree_node_file.ReadOne<std::uint64_t>() != detail::RTREE_FILE_FORMAT)
+        {
+            throw util::RuntimeError(node_file.string() +
+                                         " has an outdated r-tree layout, re-run osrm-extract",
+                                     ErrorCode::IncompatibleFileVersion,
+                                     SOURCE_REF);
+        }
+    }
 
   private:
     /**
@@ -257,16 +294,24 @@ class StaticRTree
     boost::iostreams::mapped_file_source m_objects_region;
     // This is a view of the EdgeDataT data mmap'd from the .fileIndex file
     util::vector_view<const EdgeDataT> m_objects;
+    // How the kernel should treat the mapped leaf pages
+    MMapAdvice m_leaf_advice;
+    // Whether the leaves below a node of the level above the leaves were prefetched already
+    mutable std::vector<std::atomic<bool>> m_prefetched_leaves;
 
   public:
     StaticRTree(const StaticRTree &) = delete;
     StaticRTree &operator=(const StaticRTree &) = delete;
 
     // Construct a packed Hilbert-R-Tree with Kamel-Faloutsos algorithm [1]
+    // is_big_component(element) decides whether the element is part of a big component,
+    // by default all elements are.
+    template <typename BigComponentPredicateT = bool (*)(const EdgeDataT &)>
     explicit StaticRTree(const std::vector<EdgeDataT> &input_data_vector,
                          const std::string &tree_node_filename,
                          const std::string &leaf_node_filename,
-                         const Vector<Coordinate> &coordinate_list)
+                         const Vector<Coordinate> &coordinate_list,
+                         const BigComponentPredicateT is_big_component = &AlwaysBigComponent)
         : m_coordinate_list(coordinate_list)
     {
         const auto element_count = input_data_vector.size();
@@ -317,6 +362,7 @@ class StaticRTree
             while (wrapped_element_index < element_count)
             {
                 TreeNode current_node;
+                bool has_big_component = false;
 
                 std::array<EdgeDataT, LEAF_NODE_SIZE> objects;
                 std::uint32_t object_count = 0;
@@ -358,7 +404,9 @@ class StaticRTree
 
                     BOOST_ASSERT(rectangle.IsValid());
                     current_node.minimum_bounding_rectangle.MergeBoundingBoxes(rectangle);
+                    has_big_component = has_big_component || is_big_component(object);
                 }
+                current_node.SetBigComponent(has_big_component);
 
                 // Write out our EdgeDataT block to the leaf node file
                 leaf_node_file.WriteFrom(objects.data(), object_count);
@@ -389,6 +437,7 @@ class StaticRTree
             for (auto current_node_idx : irange<std::size_t>(0, nodes_in_current_level))
             {
                 TreeNode parent_node;
+                bool has_big_component = false;
                 auto first_child_index =
                     current_node_idx * BRANCHING_FACTOR + previous_level_start_pos;
                 auto last_child_index =
@@ -403,7 +452,10 @@ class StaticRTree
                 {
                     parent_node.minimum_bounding_rectangle.MergeBoundingBoxes(
                         m_search_tree[child_node_idx].minimum_bounding_rectangle);
+                    has_big_component =
+                        has_big_component || m_search_tree[child_node_idx].HasBigComponent();
                 }
+                parent_node.SetBigComponent(has_big_component);
                 m_search_tree.emplace_back(parent_node);
             }
             nodes_in_previous_level = nodes_in_current_level;
@@ -451,6 +503,7 @@ class StaticRTree
             std::uint64_t size_of_tree = m_search_tree.size();
             BOOST_ASSERT_MSG(0 < size_of_tree, "tree empty");
 
+            tree_node_file.WriteOne(detail::RTREE_FILE_FORMAT);
             tree_node_file.WriteOne(size_of_tree);
             tree_node_file.WriteFrom(m_search_tree);
 
@@ -467,11 +520,13 @@ class StaticRTree
      */
     explicit StaticRTree(const boost::filesystem::path &node_file,
                          const boost::filesystem::path &leaf_file,
-                         const Vector<Coordinate> &coordinate_list)
-        : m_coordinate_list(coordinate_list)
+                         const Vector<Coordinate> &coordinate_list,
+                         const MMapAdvice &leaf_advice = {})
+        : m_coordinate_list(coordinate_list), m_leaf_advice(leaf_advice)
     {
         storage::io::FileReader tree_node_file(node_file,
                                                storage::io::FileReader::VerifyFingerprint);
+        ReadFileFormat(tree_node_file, node_file);
 
         const auto tree_size = tree_node_file.ReadElementCount64();
         m_search_tree.resize(tree_size);
@@ -488,7 +543,7 @@ class StaticRTree
                          m_tree_level_sizes.end() - 1,
                          std::back_inserter(m_tree_level_starts));
 
-        m_objects = mmapFile<EdgeDataT>(leaf_file, m_objects_region);
+        MapLeafFile(leaf_file);
     }
 
     /**
@@ -502,9 +557,35 @@ class StaticRTree
                          const std::uint64_t *level_sizes_ptr,
                          const std::size_t number_of_levels,
                          const boost::filesystem::path &leaf_file,
+                         const Vector<Coordinate> &coordinate_list,
+                         const MMapAdvice &leaf_advice = {})
+        : m_search_tree(tree_node_ptr, number_of_nodes), m_coordinate_list(coordinate_list),
+          m_tree_level_sizes(level_sizes_ptr, level_sizes_ptr + number_of_levels),
+          m_leaf_advice(leaf_advice)
+    {
+        // The first level starts at 0
+        m_tree_level_starts = {0};
+        // The remaining levels start at the partial sum of the preceeding level sizes
+        std::partial_sum(m_tree_level_sizes.begin(),
+                         m_tree_level_sizes.end() - 1,
+                         std::back_inserter(m_tree_level_starts));
+        MapLeafFile(leaf_file);
+    }
+
+    /**
+     * Constructs an r-tree where the leaves have been loaded into memory as well
+     * (osrm-datastore --embed-rtree-leaves), so no .fileIndex file needs to be mapped.
+     */
+    explicit StaticRTree(const TreeNode *tree_node_ptr,
+                         const uint64_t number_of_nodes,
+                         const std::uint64_t *level_sizes_ptr,
+                         const std::size_t number_of_levels,
+                         const EdgeDataT *leaves_ptr,
+                         const std::size_t number_of_leaves,
                          const Vector<Coordinate> &coordinate_list)
         : m_search_tree(tree_node_ptr, number_of_nodes), m_coordinate_list(coordinate_list),
-          m_tree_level_sizes(level_sizes_ptr, level_sizes_ptr + number_of_levels)
+          m_tree_level_sizes(level_sizes_ptr, level_sizes_ptr + number_of_levels),
+          m_objects(leaves_ptr, number_of_leaves)
     {
         // The first level starts at 0
         m_tree_level_starts = {0};
@@ -512,7 +593,6 @@ class StaticRTree
         std::partial_sum(m_tree_level_sizes.begin(),
                          m_tree_level_sizes.end() - 1,
                          std::back_inserter(m_tree_level_starts));
-        m_objects = mmapFile<EdgeDataT>(leaf_file, m_objects_region);
     }
 
     /* Returns all features inside the bounding box.
@@ -602,6 +682,18 @@ class StaticRTree
     std::vector<EdgeDataT> Nearest(const Coordinate input_coordinate,
                                    const FilterT filter,
                                    const TerminationT terminate) const
+    {
+        return Nearest(input_coordinate, filter, terminate, [] { return false; });
+    }
+
+    // Override filter and terminator for the desired behaviour.
+    // Once only_big_components() returns true, subtrees without any element of a big
+    // component are not explored anymore.
+    template <typename FilterT, typename TerminationT, typename BigComponentsOnlyT>
+    std::vector<EdgeDataT> Nearest(const Coordinate input_coordinate,
+                                   const FilterT filter,
+                                   const TerminationT terminate,
+                                   const BigComponentsOnlyT only_big_components) const
     {
         std::vector<EdgeDataT> results;
         auto projected_coordinate = web_mercator::fromWGS84(input_coordinate);
@@ -618,6 +710,13 @@ class StaticRTree
             const TreeIndex &current_tree_index = current_query_node.tree_index;
             if (!current_query_node.is_segment())
             { // current object is a tree node
+                const auto node_index =
+                    m_tree_level_starts[current_tree_index.level] + current_tree_index.offset;
+                if (only_big_components() && !m_search_tree[node_index].HasBigComponent())
+                {
+                    continue;
+                }
+
                 if (is_leaf(current_tree_index))
                 {
                     ExploreLeafNode(current_tree_index,
@@ -663,6 +762,52 @@ class StaticRTree
     }
 
   private:
+    static bool AlwaysBigComponent(const EdgeDataT &) { return true; }
+
+    void MapLeafFile(const boost::filesystem::path &leaf_file)
+    {
+        m_objects = mmapFile<EdgeDataT>(leaf_file, m_objects_region);
+        adviseMappedRegion(reinterpret_cast<const char *>(m_objects.data()),
+                           m_objects.size() * sizeof(EdgeDataT),
+                           m_leaf_advice);
+
+        // populated leaves are resident already, read-ahead would only cost syscalls
+        if (m_leaf_advice.prefetch && !m_leaf_advice.populate && m_tree_level_sizes.size() >= 2)
+        {
+            m_prefetched_leaves =
+                std::vector<std::atomic<bool>>(m_tree_level_sizes[m_tree_level_sizes.size() - 2]);
+        }
+    }
+
+    /**
+     * Asks the kernel to read in all leaves below `parent` at once.
+     * Children of a node are stored next to each other in the leaf file, so this
+     * is a single contiguous range. Siblings of the closest leaf are very likely to
+     * be visited next, and reading them in one go saves a page fault per leaf.
+     * Every range is advised only once, after that the pages are usually resident and
+     * another madvise call would only slow down the query.
+     */
+    void PrefetchLeaves(const TreeIndex &parent) const
+    {
+        BOOST_ASSERT(parent.offset < m_prefetched_leaves.size());
+        if (m_prefetched_leaves[parent.offset].exchange(true, std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        const auto children = child_indexes(parent);
+        const auto leaf_level_start = m_tree_level_starts[parent.level + 1];
+        const std::uint64_t first_object = (children.front() - leaf_level_start) * LEAF_NODE_SIZE;
+        const std::uint64_t end_object =
+            std::min<std::uint64_t>((children.back() + 1 - leaf_level_start) * LEAF_NODE_SIZE,
+                                    static_cast<std::uint64_t>(m_objects.size()));
+        if (first_object < end_object)
+        {
+            prefetchMappedRange(reinterpret_cast<const char *>(m_objects.data() + first_object),
+                                (end_object - first_object) * sizeof(EdgeDataT));
+        }
+    }
+
     /**
      * Iterates over all the objects in a leaf node and inserts them into our
      * search priority queue.  The speed of this function is very much governed
@@ -719,6 +864,11 @@ class StaticRTree
         // Check that we're actually looking at the bottom level of the tree
         BOOST_ASSERT(!is_leaf(parent));
 
+        if (!m_prefetched_leaves.empty() && parent.level + 2 == m_tree_level_starts.size())
+        {
+            PrefetchLeaves(parent);
+        }
+
         for (const auto child_index : child_indexes(parent))
         {
             const auto &child = m_search_tree[child_index];
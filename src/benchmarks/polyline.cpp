@@ -0,0 +1,161 @@
+#include "engine/polyline_compressor.hpp"
+#include "util/coordinate.hpp"
+#include "util/exception.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace osrm;
+
+namespace
+{
+
+// The polyline encoder as it was before the batch encoder, kept to compare against
+namespace reference
+{
+std::string encode(int number_to_encode)
+{
+    std::string output;
+    while (number_to_encode >= 0x20)
+    {
+        const int next_value = (0x20 | (number_to_encode & 0x1f)) + 63;
+        output += static_cast<char>(next_value);
+        number_to_encode >>= 5;
+    }
+
+    number_to_encode += 63;
+    output += static_cast<char>(number_to_encode);
+    return output;
+}
+
+std::string encode(std::vector<int> &numbers)
+{
+    std::string output;
+    for (auto &number : numbers)
+    {
+        if (number < 0)
+        {
+            const unsigned binary = std::llabs(number);
+            const unsigned twos = (~binary) + 1u;
+            const unsigned shl = twos << 1u;
+            number = static_cast<int>(~shl);
+        }
+        else
+        {
+            number <<= 1u;
+        }
+    }
+    for (const int number : numbers)
+    {
+        output += encode(number);
+    }
+    return output;
+}
+
+template <unsigned POLYLINE_PRECISION>
+std::string encodePolyline(const std::vector<util::Coordinate> &coordinates)
+{
+    double coordinate_to_polyline = POLYLINE_PRECISION / COORDINATE_PRECISION;
+    std::vector<int> delta_numbers;
+    int current_lat = 0;
+    int current_lon = 0;
+    for (const auto loc : coordinates)
+    {
+        const int lat_diff =
+            std::round(static_cast<int>(loc.lat) * coordinate_to_polyline) - current_lat;
+        const int lon_diff =
+            std::round(static_cast<int>(loc.lon) * coordinate_to_polyline) - current_lon;
+        delta_numbers.emplace_back(lat_diff);
+        delta_numbers.emplace_back(lon_diff);
+        current_lat += lat_diff;
+        current_lon += lon_diff;
+    }
+    return encode(delta_numbers);
+}
+}
+
+// random walk that looks like a cross-country route
+std::vector<util::Coordinate> makeGeometry(const std::size_t num_coordinates)
+{
+    std::mt19937 generator(1337);
+    std::uniform_int_distribution<int> step(-2000, 2000);
+
+    std::vector<util::Coordinate> coordinates;
+    coordinates.reserve(num_coordinates);
+    util::Coordinate current{util::FloatLongitude{13.388798}, util::FloatLatitude{52.517033}};
+    for (const auto index : util::irange<std::size_t>(0, num_coordinates))
+    {
+        (void)index;
+        current.lon += util::FixedLongitude{step(generator)};
+        current.lat += util::FixedLatitude{step(generator)};
+        coordinates.push_back(current);
+    }
+    return coordinates;
+}
+
+template <unsigned POLYLINE_PRECISION>
+void benchmark(const std::vector<util::Coordinate> &coordinates, const std::size_t num_rounds)
+{
+    std::size_t reference_size = 0;
+    TIMER_START(reference_encode);
+    for (const auto round : util::irange<std::size_t>(0, num_rounds))
+    {
+        (void)round;
+        reference_size += reference::encodePolyline<POLYLINE_PRECISION>(coordinates).size();
+    }
+    TIMER_STOP(reference_encode);
+
+    std::size_t size = 0;
+    TIMER_START(encode);
+    for (const auto round : util::irange<std::size_t>(0, num_rounds))
+    {
+        (void)round;
+        size += engine::encodePolyline<POLYLINE_PRECISION>(coordinates.begin(), coordinates.end())
+                    .size();
+    }
+    TIMER_STOP(encode);
+
+    const auto polyline =
+        engine::encodePolyline<POLYLINE_PRECISION>(coordinates.begin(), coordinates.end());
+    if (size != reference_size ||
+        polyline != reference::encodePolyline<POLYLINE_PRECISION>(coordinates))
+    {
+        throw util::exception("polyline encoding differs from the reference");
+    }
+
+    std::size_t num_decoded = 0;
+    TIMER_START(decode);
+    for (const auto round : util::irange<std::size_t>(0, num_rounds))
+    {
+        (void)round;
+        num_decoded += engine::decodePolyline<POLYLINE_PRECISION>(polyline).size();
+    }
+    TIMER_STOP(decode);
+    if (num_decoded != num_rounds * coordinates.size())
+    {
+        throw util::exception("polyline decoding lost coordinates");
+    }
+
+    util::Log() << "precision " << POLYLINE_PRECISION << ": reference encode "
+                << TIMER_MSEC(reference_encode) << " ms, encode " << TIMER_MSEC(encode)
+                << " ms, decode " << TIMER_MSEC(decode) << " ms for " << num_rounds << " x "
+                << coordinates.size() << " coordinates";
+}
+}
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    const auto coordinates = makeGeometry(100000);
+    benchmark<100000>(coordinates, 100);
+    benchmark<1000000>(coordinates, 100);
+
+    return EXIT_SUCCESS;
+}
@@ -13,6 +13,11 @@
 
 #include <boost/filesystem/fstream.hpp>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace osrm
 {
 namespace benchmarks
@@ -62,7 +67,7 @@ void benchmarkQuery(const std::vector<util::Coordinate> &queries,
               << ")" << std::endl;
 }
 
-void benchmark(BenchStaticRTree &rtree, unsigned num_queries)
+std::vector<util::Coordinate> generateQueries(unsigned num_queries)
 {
     std::mt19937 mt_rand(RANDOM_SEED);
     std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
@@ -73,6 +78,28 @@ void benchmark(BenchStaticRTree &rtree, unsigned num_queries)
         queries.emplace_back(util::FixedLongitude{lon_udist(mt_rand)},
                              util::FixedLatitude{lat_udist(mt_rand)});
     }
+    return queries;
+}
+
+// Drops the pages of the file from the page cache, so the next access hits the disk
+void evictFromPageCache(const boost::filesystem::path &path)
+{
+#ifndef _WIN32
+    const auto fd = ::open(path.string().c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        ::fdatasync(fd);
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+void benchmark(BenchStaticRTree &rtree, unsigned num_queries)
+{
+    const auto queries = generateQueries(num_queries);
 
     benchmarkQuery(queries, "raw RTree queries (1 result)", [&rtree](const util::Coordinate &q) {
         return rtree.Nearest(q, 1);
@@ -81,6 +108,32 @@ void benchmark(BenchStaticRTree &rtree, unsigned num_queries)
         return rtree.Nearest(q, 10);
     });
 }
+
+// Compares the first queries after loading (leaf pages not in the page cache yet)
+// with the same queries once every leaf they touch is resident.
+void benchmarkColdWarm(const boost::filesystem::path &ram_path,
+                       const boost::filesystem::path &file_path,
+                       const std::vector<util::Coordinate> &coords,
+                       const std::string &name,
+                       const util::MMapAdvice &advice,
+                       unsigned num_queries)
+{
+    const auto queries = generateQueries(num_queries);
+    const auto query = [](const BenchStaticRTree &rtree) {
+        return [&rtree](const util::Coordinate &q) { return rtree.Nearest(q, 1); };
+    };
+
+    evictFromPageCache(file_path);
+
+    std::cout << name << ":" << std::endl;
+    TIMER_START(load);
+    BenchStaticRTree rtree(ram_path, file_path, coords, advice);
+    TIMER_STOP(load);
+    std::cout << "Loading took " << TIMER_MSEC(load) << "ms" << std::endl;
+
+    benchmarkQuery(queries, "cold RTree queries (1 result)", query(rtree));
+    benchmarkQuery(queries, "warm RTree queries (1 result)", query(rtree));
+}
 }
 }
 
@@ -88,7 +141,7 @@ int main(int argc, char **argv)
 {
     if (argc < 4)
     {
-        std::cout << "./rtree-bench file.ramIndex file.fileIndx file.nodes"
+        std::cout << "./rtree-bench file.ramIndex file.fileIndx file.nodes [--cold]"
                   << "\n";
         return 1;
     }
@@ -96,9 +149,32 @@ int main(int argc, char **argv)
     const char *ram_path = argv[1];
     const char *file_path = argv[2];
     const char *nodes_path = argv[3];
+    const bool cold = argc > 4 && std::string(argv[4]) == "--cold";
 
     auto coords = osrm::benchmarks::loadCoordinates(nodes_path);
 
+    if (cold)
+    {
+        osrm::util::MMapAdvice lazy;
+        osrm::util::MMapAdvice populate;
+        populate.populate = true;
+        osrm::util::MMapAdvice prefetch;
+        prefetch.prefetch = true;
+        osrm::util::MMapAdvice huge_pages;
+        huge_pages.populate = true;
+        huge_pages.huge_pages = true;
+
+        osrm::benchmarks::benchmarkColdWarm(
+            ram_path, file_path, coords, "lazy loading", lazy, 1000);
+        osrm::benchmarks::benchmarkColdWarm(
+            ram_path, file_path, coords, "populate on load", populate, 1000);
+        osrm::benchmarks::benchmarkColdWarm(
+            ram_path, file_path, coords, "prefetch sibling leaves", prefetch, 1000);
+        osrm::benchmarks::benchmarkColdWarm(
+            ram_path, file_path, coords, "populate with huge pages", huge_pages, 1000);
+        return 0;
+    }
+
     osrm::benchmarks::BenchStaticRTree rtree(ram_path, file_path, coords);
 
     osrm::benchmarks::benchmark(rtree, 10000);
@@ -0,0 +1,82 @@
+#include "engine/trip/trip_farthest_insertion.hpp"
+#include "engine/trip/trip_local_search.hpp"
+#include "util/dist_table_wrapper.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace osrm;
+
+// Durations between random locations on a plane, slightly asymmetric like real road networks
+util::DistTableWrapper<EdgeWeight> makeTable(const std::size_t number_of_locations)
+{
+    std::mt19937 g(1337);
+    std::uniform_real_distribution<double> position(0, 10000);
+    std::uniform_real_distribution<double> detour(1.0, 1.3);
+
+    std::vector<double> x(number_of_locations), y(number_of_locations);
+    for (auto location : util::irange<std::size_t>(0, number_of_locations))
+    {
+        x[location] = position(g);
+        y[location] = position(g);
+    }
+
+    std::vector<EdgeWeight> table(number_of_locations * number_of_locations, 0);
+    for (auto from : util::irange<std::size_t>(0, number_of_locations))
+    {
+        for (auto to : util::irange<std::size_t>(0, number_of_locations))
+        {
+            if (from != to)
+            {
+                table[from * number_of_locations + to] = static_cast<EdgeWeight>(
+                    std::hypot(x[from] - x[to], y[from] - y[to]) * detour(g));
+            }
+        }
+    }
+
+    return util::DistTableWrapper<EdgeWeight>(std::move(table), number_of_locations);
+}
+
+std::int64_t tripDuration(const std::vector<NodeID> &trip,
+                          const util::DistTableWrapper<EdgeWeight> &table)
+{
+    std::int64_t duration = 0;
+    for (auto position : util::irange<std::size_t>(0, trip.size()))
+    {
+        duration += table(trip[position], trip[(position + 1) % trip.size()]);
+    }
+    return duration;
+}
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    for (const std::size_t number_of_locations : {10, 25, 50, 100, 200, 400})
+    {
+        const auto table = makeTable(number_of_locations);
+
+        TIMER_START(insertion);
+        auto trip = engine::trip::FarthestInsertionTrip(number_of_locations, table);
+        TIMER_STOP(insertion);
+        const auto insertion_duration = tripDuration(trip, table);
+
+        TIMER_START(local_search);
+        trip = engine::trip::LocalSearchTrip(std::move(trip), table, std::chrono::seconds(10));
+        TIMER_STOP(local_search);
+        const auto local_search_duration = tripDuration(trip, table);
+
+        util::Log() << number_of_locations << " locations: farthest insertion "
+                    << insertion_duration << " in " << TIMER_MSEC(insertion)
+                    << " ms, with local search " << local_search_duration << " in "
+                    << TIMER_MSEC(insertion) + TIMER_MSEC(local_search) << " ms ("
+                    << 100. * (insertion_duration - local_search_duration) / insertion_duration
+                    << "% shorter)";
+    }
+}
@@ -174,21 +174,21 @@ util::json::Object makeRouteStep(guidance::RouteStep step, util::json::Value geo
     route_step.values["distance"] = std::round(step.distance * 10) / 10.;
     route_step.values["duration"] = step.duration;
     route_step.values["weight"] = step.weight;
-    route_step.values["name"] = std::move(step.name);
+    route_step.values["name"] = step.name.to_string();
     if (!step.ref.empty())
-        route_step.values["ref"] = std::move(step.ref);
+        route_step.values["ref"] = step.ref.to_string();
     if (!step.pronunciation.empty())
-        route_step.values["pronunciation"] = std::move(step.pronunciation);
+        route_step.values["pronunciation"] = step.pronunciation.to_string();
     if (!step.destinations.empty())
-        route_step.values["destinations"] = std::move(step.destinations);
+        route_step.values["destinations"] = step.destinations.to_string();
     if (!step.exits.empty())
-        route_step.values["exits"] = std::move(step.exits);
+        route_step.values["exits"] = step.exits.to_string();
     if (!step.rotary_name.empty())
     {
-        route_step.values["rotary_name"] = std::move(step.rotary_name);
+        route_step.values["rotary_name"] = step.rotary_name.to_string();
         if (!step.rotary_pronunciation.empty())
         {
-            route_step.values["rotary_pronunciation"] = std::move(step.rotary_pronunciation);
+            route_step.values["rotary_pronunciation"] = step.rotary_pronunciation.to_string();
         }
     }
 
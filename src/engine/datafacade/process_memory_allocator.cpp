@@ -10,9 +10,10 @@ namespace engine
 namespace datafacade
 {
 
-ProcessMemoryAllocator::ProcessMemoryAllocator(const storage::StorageConfig &config)
+ProcessMemoryAllocator::ProcessMemoryAllocator(const storage::StorageConfig &config,
+                                               const bool embed_rtree_leaves)
 {
-    storage::Storage storage(config);
+    storage::Storage storage(config, embed_rtree_leaves);
 
     // Calculate the layout/size of the memory block
     internal_layout = std::make_unique<storage::DataLayout>();
@@ -27,6 +28,7 @@ ProcessMemoryAllocator::~ProcessMemoryAllocator() {}
 
 storage::DataLayout &ProcessMemoryAllocator::GetLayout() { return *internal_layout.get(); }
 char *ProcessMemoryAllocator::GetMemory() { return internal_memory.get(); }
+unsigned ProcessMemoryAllocator::GetDatasetGeneration() const { return 0; }
 
 } // namespace datafacade
 } // namespace engine
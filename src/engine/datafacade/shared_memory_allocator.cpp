@@ -10,7 +10,9 @@ namespace engine
 namespace datafacade
 {
 
-SharedMemoryAllocator::SharedMemoryAllocator(storage::SharedDataType data_region)
+SharedMemoryAllocator::SharedMemoryAllocator(storage::SharedDataType data_region,
+                                             unsigned generation)
+    : m_generation(generation)
 {
     util::Log(logDEBUG) << "Loading new data for region " << regionToString(data_region);
 
@@ -28,6 +30,7 @@ char *SharedMemoryAllocator::GetMemory()
 {
     return reinterpret_cast<char *>(m_large_memory->Ptr()) + sizeof(storage::DataLayout);
 }
+unsigned SharedMemoryAllocator::GetDatasetGeneration() const { return m_generation; }
 
 } // namespace datafacade
 } // namespace engine
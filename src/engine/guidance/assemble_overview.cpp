@@ -1,5 +1,5 @@
-#include "engine/douglas_peucker.hpp"
 #include "engine/guidance/leg_geometry.hpp"
+#include "util/douglas_peucker.hpp"
 #include "util/viewport.hpp"
 
 #include <iterator>
@@ -75,7 +75,8 @@ std::vector<util::Coordinate> assembleOverview(const std::vector<LegGeometry> &l
         for (const auto &geometry : leg_geometries)
         {
             const auto simplified =
-                douglasPeucker(geometry.locations.begin(), geometry.locations.end(), zoom_level);
+                util::douglasPeucker(
+                    geometry.locations.begin(), geometry.locations.end(), zoom_level);
             insert_without_overlap(simplified.begin(), simplified.end());
         }
     }
@@ -53,7 +53,7 @@ void compressRange(const RouteStepIterator begin, const RouteStepIterator end)
         // ensure not to invalidate the final arrive
         if (!hasWaypointType(*itr))
         {
-            begin->ElongateBy(*itr);
+            begin->ElongateBy(std::move(*itr));
             itr->Invalidate();
         }
     }
@@ -120,9 +120,9 @@ void processRoundaboutExits(const RouteStepIterator begin, const RouteStepIterat
         else if (begin->maneuver.instruction.type == TurnType::EnterRoundaboutIntersection ||
                  begin->maneuver.instruction.type == TurnType::EnterRoundaboutIntersectionAtExit)
         {
-            const auto entry_intersection = begin->intersections.front();
+            const auto &entry_intersection = begin->intersections.front();
 
-            const auto exit_intersection = last->intersections.front();
+            const auto &exit_intersection = last->intersections.front();
             const auto exit_bearing = exit_intersection.bearings[exit_intersection.out];
 
             BOOST_ASSERT(!begin->intersections.empty());
@@ -527,9 +527,25 @@ std::vector<RouteStep> buildIntersections(std::vector<RouteStep> steps)
         if (instruction.type == TurnType::Suppressed)
         {
             BOOST_ASSERT(steps[last_valid_instruction].mode == step.mode);
+            // make room for the intersections of the whole run of suppressed steps at once,
+            // instead of growing the intersections with every step that is merged
+            auto &intersections = steps[last_valid_instruction].intersections;
+            if (steps[step_index - 1].maneuver.instruction.type != TurnType::Suppressed)
+            {
+                auto number_of_intersections = intersections.size();
+                for (auto run_index = step_index; run_index < steps.size() &&
+                                                  steps[run_index].maneuver.instruction.type ==
+                                                      TurnType::Suppressed;
+                     ++run_index)
+                {
+                    number_of_intersections += steps[run_index].intersections.size();
+                }
+                intersections.reserve(number_of_intersections);
+            }
+
             // count intersections. We cannot use exit, since intersections can follow directly
             // after a roundabout
-            steps[last_valid_instruction].ElongateBy(step);
+            steps[last_valid_instruction].ElongateBy(std::move(step));
             steps[step_index].Invalidate();
         }
         else if (!isSilent(instruction))
@@ -3,6 +3,7 @@
 
 #include <boost/assert.hpp>
 #include <iterator>
+#include <utility>
 
 namespace osrm
 {
@@ -30,7 +31,7 @@ std::vector<RouteStep> suppressShortNameSegments(std::vector<RouteStep> steps)
     };
 
     const auto suppress = [](RouteStep &from_step, RouteStep &onto_step) {
-        from_step.ElongateBy(onto_step);
+        from_step.ElongateBy(std::move(onto_step));
         onto_step.Invalidate();
     };
 
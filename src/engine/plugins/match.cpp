@@ -109,6 +109,70 @@ void filterCandidates(const std::vector<util::Coordinate> &coordinates,
     }
 }
 
+// Assuming radius is the standard deviation of a normal distribution
+// that models GPS noise (in this model), x3 should give us the correct
+// search radius with > 99% confidence
+std::vector<double> getSearchRadiuses(const api::MatchParameters &parameters)
+{
+    std::vector<double> search_radiuses;
+    if (parameters.radiuses.empty())
+    {
+        search_radiuses.resize(parameters.coordinates.size(),
+                               routing_algorithms::DEFAULT_GPS_PRECISION *
+                                   MatchPlugin::RADIUS_MULTIPLIER);
+    }
+    else
+    {
+        search_radiuses.resize(parameters.coordinates.size());
+        std::transform(parameters.radiuses.begin(),
+                       parameters.radiuses.end(),
+                       search_radiuses.begin(),
+                       [](const boost::optional<double> &maybe_radius) {
+                           if (maybe_radius)
+                           {
+                               return *maybe_radius * MatchPlugin::RADIUS_MULTIPLIER;
+                           }
+                           else
+                           {
+                               return routing_algorithms::DEFAULT_GPS_PRECISION *
+                                      MatchPlugin::RADIUS_MULTIPLIER;
+                           }
+
+                       });
+    }
+    return search_radiuses;
+}
+
+std::vector<InternalRouteResult>
+routeSubMatchings(const RoutingAlgorithmsInterface &algorithms,
+                  const MatchPlugin::SubMatchingList &sub_matchings)
+{
+    std::vector<InternalRouteResult> sub_routes(sub_matchings.size());
+    for (auto index : util::irange<std::size_t>(0UL, sub_matchings.size()))
+    {
+        BOOST_ASSERT(sub_matchings[index].nodes.size() > 1);
+
+        // FIXME we only run this to obtain the geometry
+        // The clean way would be to get this directly from the map matching plugin
+        PhantomNodes current_phantom_node_pair;
+        for (unsigned i = 0; i < sub_matchings[index].nodes.size() - 1; ++i)
+        {
+            current_phantom_node_pair.source_phantom = sub_matchings[index].nodes[i];
+            current_phantom_node_pair.target_phantom = sub_matchings[index].nodes[i + 1];
+            BOOST_ASSERT(current_phantom_node_pair.source_phantom.IsValid());
+            BOOST_ASSERT(current_phantom_node_pair.target_phantom.IsValid());
+            sub_routes[index].segment_end_coordinates.emplace_back(current_phantom_node_pair);
+        }
+        // force uturns to be on, since we split the phantom nodes anyway and only have
+        // bi-directional
+        // phantom nodes for possible uturns
+        sub_routes[index] =
+            algorithms.ShortestPathSearch(sub_routes[index].segment_end_coordinates, {false});
+        BOOST_ASSERT(sub_routes[index].shortest_path_weight != INVALID_EDGE_WEIGHT);
+    }
+    return sub_routes;
+}
+
 Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                                   const api::MatchParameters &parameters,
                                   util::json::Object &json_result) const
@@ -150,6 +214,11 @@ Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
             "InvalidValue", "Timestamps need to be monotonically increasing.", json_result);
     }
 
+    if (!parameters.vehicle.empty())
+    {
+        return HandleLiveTraceRequest(algorithms, parameters, json_result);
+    }
+
     SubMatchingList sub_matchings;
     api::tidy::Result tidied;
     if (parameters.tidy)
@@ -163,35 +232,8 @@ Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
         tidied = api::tidy::keep_all(parameters);
     }
 
-    // assuming radius is the standard deviation of a normal distribution
-    // that models GPS noise (in this model), x3 should give us the correct
-    // search radius with > 99% confidence
-    std::vector<double> search_radiuses;
-    if (tidied.parameters.radiuses.empty())
-    {
-        search_radiuses.resize(tidied.parameters.coordinates.size(),
-                               routing_algorithms::DEFAULT_GPS_PRECISION * RADIUS_MULTIPLIER);
-    }
-    else
-    {
-        search_radiuses.resize(tidied.parameters.coordinates.size());
-        std::transform(tidied.parameters.radiuses.begin(),
-                       tidied.parameters.radiuses.end(),
-                       search_radiuses.begin(),
-                       [](const boost::optional<double> &maybe_radius) {
-                           if (maybe_radius)
-                           {
-                               return *maybe_radius * RADIUS_MULTIPLIER;
-                           }
-                           else
-                           {
-                               return routing_algorithms::DEFAULT_GPS_PRECISION * RADIUS_MULTIPLIER;
-                           }
-
-                       });
-    }
-
-    auto candidates_lists = GetPhantomNodesInRange(facade, tidied.parameters, search_radiuses);
+    auto candidates_lists =
+        GetPhantomNodesInRange(facade, tidied.parameters, getSearchRadiuses(tidied.parameters));
 
     filterCandidates(tidied.parameters.coordinates, candidates_lists);
     if (std::all_of(candidates_lists.begin(),
@@ -218,32 +260,169 @@ Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
         return Error("NoMatch", "Could not match the trace.", json_result);
     }
 
-    std::vector<InternalRouteResult> sub_routes(sub_matchings.size());
-    for (auto index : util::irange<std::size_t>(0UL, sub_matchings.size()))
+    const auto sub_routes = routeSubMatchings(algorithms, sub_matchings);
+
+    api::MatchAPI match_api{facade, parameters, tidied};
+    match_api.MakeResponse(sub_matchings, sub_routes, json_result);
+
+    return Status::Ok;
+}
+
+// Matches the points of a request together with the points of the same vehicle that are not
+// finally matched yet. Only the leading points whose matching can not change anymore are
+// returned, the remaining ones are kept until the next request of the vehicle.
+Status MatchPlugin::HandleLiveTraceRequest(const RoutingAlgorithmsInterface &algorithms,
+                                           const api::MatchParameters &parameters,
+                                           util::json::Object &json_result) const
+{
+    const auto &facade = algorithms.GetFacade();
+
+    // hints, bearings and approaches would only be known for the points of this request
+    if (!parameters.hints.empty() || !parameters.bearings.empty() ||
+        !parameters.approaches.empty())
     {
-        BOOST_ASSERT(sub_matchings[index].nodes.size() > 1);
+        return Error("InvalidOptions",
+                     "Hints, bearings and approaches are not supported for live traces.",
+                     json_result);
+    }
 
-        // FIXME we only run this to obtain the geometry
-        // The clean way would be to get this directly from the map matching plugin
-        PhantomNodes current_phantom_node_pair;
-        for (unsigned i = 0; i < sub_matchings[index].nodes.size() - 1; ++i)
+    // waits for other requests of the vehicle, the session is put back when handle goes away
+    auto handle = live_traces.Take(parameters.vehicle);
+    auto &session = *handle;
+
+    if (!session.coordinates.empty() &&
+        session.timestamps.empty() != parameters.timestamps.empty())
+    {
+        return Error("InvalidValue",
+                     "Timestamps need to be given for all or none of the points of a vehicle.",
+                     json_result);
+    }
+
+    if (!session.timestamps.empty() && !parameters.timestamps.empty() &&
+        parameters.timestamps.front() < session.timestamps.back())
+    {
+        return Error(
+            "InvalidValue", "Timestamps need to be monotonically increasing.", json_result);
+    }
+
+    // the anchor was snapped on a different dataset
+    if (session.checksum != facade.GetCheckSum())
+    {
+        session.anchor = boost::none;
+    }
+    session.checksum = facade.GetCheckSum();
+
+    session.coordinates.insert(
+        session.coordinates.end(), parameters.coordinates.begin(), parameters.coordinates.end());
+    session.timestamps.insert(
+        session.timestamps.end(), parameters.timestamps.begin(), parameters.timestamps.end());
+    if (parameters.radiuses.empty())
+    {
+        session.radiuses.resize(session.coordinates.size());
+    }
+    else
+    {
+        session.radiuses.insert(
+            session.radiuses.end(), parameters.radiuses.begin(), parameters.radiuses.end());
+    }
+
+    api::MatchParameters window = parameters;
+    window.coordinates = session.coordinates;
+    window.timestamps = session.timestamps;
+    window.radiuses = session.radiuses;
+
+    SubMatchingList sub_matchings;
+    if (window.coordinates.size() > 1)
+    {
+        auto candidates_lists =
+            GetPhantomNodesInRange(facade, window, getSearchRadiuses(window));
+        filterCandidates(window.coordinates, candidates_lists);
+
+        // the first point was already matched by an earlier request
+        if (session.anchor)
         {
-            current_phantom_node_pair.source_phantom = sub_matchings[index].nodes[i];
-            current_phantom_node_pair.target_phantom = sub_matchings[index].nodes[i + 1];
-            BOOST_ASSERT(current_phantom_node_pair.source_phantom.IsValid());
-            BOOST_ASSERT(current_phantom_node_pair.target_phantom.IsValid());
-            sub_routes[index].segment_end_coordinates.emplace_back(current_phantom_node_pair);
+            candidates_lists.front() = {*session.anchor};
         }
-        // force uturns to be on, since we split the phantom nodes anyway and only have
-        // bi-directional
-        // phantom nodes for possible uturns
-        sub_routes[index] =
-            algorithms.ShortestPathSearch(sub_routes[index].segment_end_coordinates, {false});
-        BOOST_ASSERT(sub_routes[index].shortest_path_weight != INVALID_EDGE_WEIGHT);
+
+        sub_matchings = algorithms.MapMatching(candidates_lists,
+                                               window.coordinates,
+                                               window.timestamps,
+                                               window.radiuses,
+                                               parameters.gaps ==
+                                                   api::MatchParameters::GapsType::Split);
     }
 
-    api::MatchAPI match_api{facade, parameters, tidied};
-    match_api.MakeResponse(sub_matchings, sub_routes, json_result);
+    // Once the window is full everything is finalised to bound the pending points
+    const auto max_points =
+        max_locations_map_matching > 0
+            ? std::min<std::size_t>(max_locations_map_matching, MAX_LIVE_TRACE_POINTS)
+            : MAX_LIVE_TRACE_POINTS;
+    const bool window_full = window.coordinates.size() >= max_points;
+
+    SubMatchingList finalised;
+    std::size_t first_pending = 0;
+    boost::optional<PhantomNodeWithDistance> anchor;
+    for (auto &sub_matching : sub_matchings)
+    {
+        const std::size_t converged =
+            window_full ? sub_matching.nodes.size() : sub_matching.converged_nodes;
+
+        if (converged == 0)
+        {
+            // points in front of this sub-matching are not part of any matching
+            first_pending = sub_matching.indices.front();
+            anchor = boost::none;
+            continue;
+        }
+
+        // the last converged point is kept to connect the matching of the next request
+        const auto last = converged - 1;
+        first_pending = sub_matching.indices[last];
+        anchor = PhantomNodeWithDistance{
+            sub_matching.nodes[last],
+            util::coordinate_calculation::haversineDistance(
+                window.coordinates[first_pending], sub_matching.nodes[last].location)};
+
+        if (converged > 1)
+        {
+            sub_matching.nodes.resize(converged);
+            sub_matching.indices.resize(converged);
+            sub_matching.alternatives_count.resize(converged);
+            finalised.push_back(std::move(sub_matching));
+        }
+    }
+
+    // nothing could be matched for a long time
+    if (window.coordinates.size() - first_pending >= max_points)
+    {
+        first_pending = window.coordinates.size() - 1;
+        anchor = boost::none;
+    }
+
+    // respond with the finalised points, including the new anchor
+    const auto num_finalised = anchor ? first_pending + 1 : first_pending;
+    window.coordinates.resize(num_finalised);
+    window.radiuses.resize(num_finalised);
+    if (!window.timestamps.empty())
+    {
+        window.timestamps.resize(num_finalised);
+    }
+
+    const auto sub_routes = routeSubMatchings(algorithms, finalised);
+
+    const auto tidied = api::tidy::keep_all(window);
+    api::MatchAPI match_api{facade, window, tidied};
+    match_api.MakeResponse(finalised, sub_routes, json_result);
+
+    session.coordinates.erase(session.coordinates.begin(),
+                              session.coordinates.begin() + first_pending);
+    session.radiuses.erase(session.radiuses.begin(), session.radiuses.begin() + first_pending);
+    if (!session.timestamps.empty())
+    {
+        session.timestamps.erase(session.timestamps.begin(),
+                                 session.timestamps.begin() + first_pending);
+    }
+    session.anchor = anchor;
 
     return Status::Ok;
 }
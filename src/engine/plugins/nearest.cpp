@@ -2,6 +2,7 @@
 #include "engine/api/nearest_api.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/phantom_node.hpp"
+#include "util/hilbert_value.hpp"
 #include "util/integer_range.hpp"
 
 #include <cstddef>
@@ -10,6 +11,13 @@
 #include <boost/assert.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -17,7 +25,37 @@ namespace engine
 namespace plugins
 {
 
-NearestPlugin::NearestPlugin(const int max_results_) : max_results{max_results_} {}
+namespace
+{
+// Number of consecutive (Hilbert ordered) coordinates snapped by one task in batch requests
+constexpr std::size_t BATCH_GRAIN_SIZE = 256;
+
+// Orders the coordinate indices along the Hilbert curve. Queries that are close in this order
+// descend through the same r-tree nodes and mostly touch the same leaves, so snapping them one
+// after the other on the same thread finds those pages in the cache.
+std::vector<std::size_t> hilbertOrder(const std::vector<util::Coordinate> &coordinates)
+{
+    std::vector<std::uint64_t> hilbert_codes(coordinates.size());
+    std::transform(coordinates.begin(),
+                   coordinates.end(),
+                   hilbert_codes.begin(),
+                   [](const util::Coordinate &coordinate) {
+                       return util::GetHilbertCode(coordinate);
+                   });
+
+    std::vector<std::size_t> order(coordinates.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&hilbert_codes](const auto lhs, const auto rhs) {
+        return hilbert_codes[lhs] < hilbert_codes[rhs];
+    });
+    return order;
+}
+}
+
+NearestPlugin::NearestPlugin(const int max_results_, const int max_locations_)
+    : max_results{max_results_}, max_locations{max_locations_}
+{
+}
 
 Status NearestPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                                     const api::NearestParameters &params,
@@ -42,6 +80,11 @@ Status NearestPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms
     if (!CheckAllCoordinates(params.coordinates))
         return Error("InvalidOptions", "Coordinates are invalid", json_result);
 
+    if (params.batch)
+    {
+        return HandleBatchRequest(facade, params, json_result);
+    }
+
     if (params.coordinates.size() != 1)
     {
         return Error("InvalidOptions", "Only one input coordinate is supported", json_result);
@@ -60,6 +103,39 @@ Status NearestPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms
 
     return Status::Ok;
 }
+
+Status NearestPlugin::HandleBatchRequest(const datafacade::BaseDataFacade &facade,
+                                         const api::NearestParameters &params,
+                                         util::json::Object &json_result) const
+{
+    if (max_locations > 0 && (static_cast<int>(params.coordinates.size()) > max_locations))
+    {
+        return Error("TooBig",
+                     "Number of coordinates " + std::to_string(params.coordinates.size()) +
+                         " is higher than current maximum (" + std::to_string(max_locations) +
+                         ")",
+                     json_result);
+    }
+
+    const auto order = hilbertOrder(params.coordinates);
+
+    std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(params.coordinates.size());
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, order.size(), BATCH_GRAIN_SIZE),
+        [&](const tbb::blocked_range<std::size_t> &range) {
+            for (auto position = range.begin(); position != range.end(); ++position)
+            {
+                const auto index = order[position];
+                phantom_nodes[index] =
+                    GetPhantomNodesForCoordinate(facade, params, index, params.number_of_results);
+            }
+        });
+
+    api::NearestAPI nearest_api(facade, params);
+    nearest_api.MakeBatchResponse(phantom_nodes, json_result);
+
+    return Status::Ok;
+}
 }
 }
 }
@@ -4,12 +4,16 @@
 #include "engine/plugins/tile.hpp"
 
 #include "util/coordinate_calculation.hpp"
+#include "util/log.hpp"
 #include "util/string_view.hpp"
 #include "util/vector_tile.hpp"
 #include "util/web_mercator.hpp"
 
 #include "engine/api/json_factory.hpp"
 
+#include "extractor/files.hpp"
+
+#include <boost/filesystem.hpp>
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/geometries.hpp>
 #include <boost/geometry/geometries/point_xy.hpp>
@@ -18,6 +22,8 @@
 #include <protozero/pbf_writer.hpp>
 #include <protozero/varint.hpp>
 
+#include <tbb/parallel_invoke.h>
+
 #include <algorithm>
 #include <numeric>
 #include <string>
@@ -310,27 +316,30 @@ std::vector<std::size_t> getEdgeIndex(const std::vector<RTreeLeaf> &edges)
     return sorted_edge_indexes;
 }
 
-void encodeVectorTile(const DataFacadeBase &facade,
-                      unsigned x,
-                      unsigned y,
-                      unsigned z,
+// Converts tile coordinates into mercator coordinates
+BBox getTileBBox(unsigned x, unsigned y, unsigned z)
+{
+    double min_mercator_lon, min_mercator_lat, max_mercator_lon, max_mercator_lat;
+    util::web_mercator::xyzToMercator(
+        x, y, z, min_mercator_lon, min_mercator_lat, max_mercator_lon, max_mercator_lat);
+    return BBox{min_mercator_lon, min_mercator_lat, max_mercator_lon, max_mercator_lat};
+}
+
+// Encodes the line layer with the speeds of all edges as a vector tile of its own
+void encodeSpeedLayer(const DataFacadeBase &facade,
+                      const BBox &tile_bbox,
                       const std::vector<RTreeLeaf> &edges,
                       const std::vector<std::size_t> &sorted_edge_indexes,
-                      const std::vector<routing_algorithms::TurnData> &all_turn_data,
                       std::string &pbf_buffer)
 {
-
     std::uint8_t max_datasource_id = 0;
 
     // Vector tiles encode properties on features as indexes into a layer-specific
     // lookup table.  These ValueIndexer's act as memoizers for values as we discover
     // them during edge explioration, and are then used to generate the lookup
-    // tables for each tile layer.
+    // tables for the layer.
     ValueIndexer<int> line_int_index;
     ValueIndexer<util::StringView> line_string_index;
-    ValueIndexer<int> point_int_index;
-    ValueIndexer<float> point_float_index;
-    ValueIndexer<std::string> point_string_index;
 
     const auto get_geometry_id = [&facade](auto edge) {
         return facade.GetGeometryIndex(edge.forward_segment_id.id).id;
@@ -362,33 +371,71 @@ void encodeVectorTile(const DataFacadeBase &facade,
         max_datasource_id = std::max(max_datasource_id, reverse_datasource);
     }
 
-    // Convert tile coordinates into mercator coordinates
-    double min_mercator_lon, min_mercator_lat, max_mercator_lon, max_mercator_lat;
-    util::web_mercator::xyzToMercator(
-        x, y, z, min_mercator_lon, min_mercator_lat, max_mercator_lon, max_mercator_lat);
-    const BBox tile_bbox{min_mercator_lon, min_mercator_lat, max_mercator_lon, max_mercator_lat};
-
     // Protobuf serializes blocks when objects go out of scope, hence
     // the extra scoping below.
     protozero::pbf_writer tile_writer{pbf_buffer};
     {
+        // Add a layer object to the PBF stream.  3=='layer' from the vector tile spec
+        // (2.1)
+        protozero::pbf_writer line_layer_writer(tile_writer, util::vector_tile::LAYER_TAG);
+        // TODO: don't write a layer if there are no features
+
+        line_layer_writer.add_uint32(util::vector_tile::VERSION_TAG, 2); // version
+        // Field 1 is the "layer name" field, it's a string
+        line_layer_writer.add_string(util::vector_tile::NAME_TAG, "speeds"); // name
+        // Field 5 is the tile extent.  It's a uint32 and should be set to 4096
+        // for normal vector tiles.
+        line_layer_writer.add_uint32(util::vector_tile::EXTENT_TAG,
+                                     util::vector_tile::EXTENT); // extent
+
+        // Because we need to know the indexes into the vector tile lookup table,
+        // we need to do an initial pass over the data and create the complete
+        // index of used values.
+        for (const auto &edge_index : sorted_edge_indexes)
         {
-            // Add a layer object to the PBF stream.  3=='layer' from the vector tile spec
-            // (2.1)
-            protozero::pbf_writer line_layer_writer(tile_writer, util::vector_tile::LAYER_TAG);
-            // TODO: don't write a layer if there are no features
-
-            line_layer_writer.add_uint32(util::vector_tile::VERSION_TAG, 2); // version
-            // Field 1 is the "layer name" field, it's a string
-            line_layer_writer.add_string(util::vector_tile::NAME_TAG, "speeds"); // name
-            // Field 5 is the tile extent.  It's a uint32 and should be set to 4096
-            // for normal vector tiles.
-            line_layer_writer.add_uint32(util::vector_tile::EXTENT_TAG,
-                                         util::vector_tile::EXTENT); // extent
-
-            // Because we need to know the indexes into the vector tile lookup table,
-            // we need to do an initial pass over the data and create the complete
-            // index of used values.
+            const auto &edge = edges[edge_index];
+            const auto geometry_id = get_geometry_id(edge);
+
+            // Get coordinates for start/end nodes of segment (NodeIDs u and v)
+            const auto a = facade.GetCoordinateOfNode(edge.u);
+            const auto b = facade.GetCoordinateOfNode(edge.v);
+            // Calculate the length in meters
+            const double length = osrm::util::coordinate_calculation::haversineDistance(a, b);
+
+            // Weight values
+            const auto forward_weight_vector = facade.GetUncompressedForwardWeights(geometry_id);
+            const auto reverse_weight_vector = facade.GetUncompressedReverseWeights(geometry_id);
+            const auto forward_weight = forward_weight_vector[edge.fwd_segment_position];
+            const auto reverse_weight = reverse_weight_vector[reverse_weight_vector.size() -
+                                                              edge.fwd_segment_position - 1];
+            line_int_index.add(forward_weight);
+            line_int_index.add(reverse_weight);
+
+            std::uint32_t forward_rate =
+                static_cast<std::uint32_t>(round(length / forward_weight * 10.));
+            std::uint32_t reverse_rate =
+                static_cast<std::uint32_t>(round(length / reverse_weight * 10.));
+
+            line_int_index.add(forward_rate);
+            line_int_index.add(reverse_rate);
+
+            // Duration values
+            const auto forward_duration_vector =
+                facade.GetUncompressedForwardDurations(geometry_id);
+            const auto reverse_duration_vector =
+                facade.GetUncompressedReverseDurations(geometry_id);
+            const auto forward_duration = forward_duration_vector[edge.fwd_segment_position];
+            const auto reverse_duration =
+                reverse_duration_vector[reverse_duration_vector.size() -
+                                        edge.fwd_segment_position - 1];
+            line_int_index.add(forward_duration);
+            line_int_index.add(reverse_duration);
+        }
+
+        // Begin the layer features block
+        {
+            // Each feature gets a unique id, starting at 1
+            unsigned id = 1;
             for (const auto &edge_index : sorted_edge_indexes)
             {
                 const auto &edge = edges[edge_index];
@@ -400,477 +447,619 @@ void encodeVectorTile(const DataFacadeBase &facade,
                 // Calculate the length in meters
                 const double length = osrm::util::coordinate_calculation::haversineDistance(a, b);
 
-                // Weight values
                 const auto forward_weight_vector =
                     facade.GetUncompressedForwardWeights(geometry_id);
                 const auto reverse_weight_vector =
                     facade.GetUncompressedReverseWeights(geometry_id);
-                const auto forward_weight = forward_weight_vector[edge.fwd_segment_position];
-                const auto reverse_weight = reverse_weight_vector[reverse_weight_vector.size() -
-                                                                  edge.fwd_segment_position - 1];
-                line_int_index.add(forward_weight);
-                line_int_index.add(reverse_weight);
-
-                std::uint32_t forward_rate =
-                    static_cast<std::uint32_t>(round(length / forward_weight * 10.));
-                std::uint32_t reverse_rate =
-                    static_cast<std::uint32_t>(round(length / reverse_weight * 10.));
-
-                line_int_index.add(forward_rate);
-                line_int_index.add(reverse_rate);
-
-                // Duration values
                 const auto forward_duration_vector =
                     facade.GetUncompressedForwardDurations(geometry_id);
                 const auto reverse_duration_vector =
                     facade.GetUncompressedReverseDurations(geometry_id);
+                const auto forward_datasource_vector =
+                    facade.GetUncompressedForwardDatasources(geometry_id);
+                const auto reverse_datasource_vector =
+                    facade.GetUncompressedReverseDatasources(geometry_id);
+                const auto forward_weight = forward_weight_vector[edge.fwd_segment_position];
+                const auto reverse_weight =
+                    reverse_weight_vector[reverse_weight_vector.size() -
+                                          edge.fwd_segment_position - 1];
                 const auto forward_duration = forward_duration_vector[edge.fwd_segment_position];
                 const auto reverse_duration =
                     reverse_duration_vector[reverse_duration_vector.size() -
                                             edge.fwd_segment_position - 1];
-                line_int_index.add(forward_duration);
-                line_int_index.add(reverse_duration);
-            }
-
-            // Begin the layer features block
-            {
-                // Each feature gets a unique id, starting at 1
-                unsigned id = 1;
-                for (const auto &edge_index : sorted_edge_indexes)
-                {
-                    const auto &edge = edges[edge_index];
-                    const auto geometry_id = get_geometry_id(edge);
-
-                    // Get coordinates for start/end nodes of segment (NodeIDs u and v)
-                    const auto a = facade.GetCoordinateOfNode(edge.u);
-                    const auto b = facade.GetCoordinateOfNode(edge.v);
-                    // Calculate the length in meters
-                    const double length =
-                        osrm::util::coordinate_calculation::haversineDistance(a, b);
-
-                    const auto forward_weight_vector =
-                        facade.GetUncompressedForwardWeights(geometry_id);
-                    const auto reverse_weight_vector =
-                        facade.GetUncompressedReverseWeights(geometry_id);
-                    const auto forward_duration_vector =
-                        facade.GetUncompressedForwardDurations(geometry_id);
-                    const auto reverse_duration_vector =
-                        facade.GetUncompressedReverseDurations(geometry_id);
-                    const auto forward_datasource_vector =
-                        facade.GetUncompressedForwardDatasources(geometry_id);
-                    const auto reverse_datasource_vector =
-                        facade.GetUncompressedReverseDatasources(geometry_id);
-                    const auto forward_weight = forward_weight_vector[edge.fwd_segment_position];
-                    const auto reverse_weight =
-                        reverse_weight_vector[reverse_weight_vector.size() -
+                const auto forward_datasource_idx =
+                    forward_datasource_vector[edge.fwd_segment_position];
+                const auto reverse_datasource_idx =
+                    reverse_datasource_vector[reverse_datasource_vector.size() -
                                               edge.fwd_segment_position - 1];
-                    const auto forward_duration =
-                        forward_duration_vector[edge.fwd_segment_position];
-                    const auto reverse_duration =
-                        reverse_duration_vector[reverse_duration_vector.size() -
-                                                edge.fwd_segment_position - 1];
-                    const auto forward_datasource_idx =
-                        forward_datasource_vector[edge.fwd_segment_position];
-                    const auto reverse_datasource_idx =
-                        reverse_datasource_vector[reverse_datasource_vector.size() -
-                                                  edge.fwd_segment_position - 1];
-
-                    const auto component_id = facade.GetComponentID(edge.forward_segment_id.id);
-                    const auto name_id = facade.GetNameIndex(edge.forward_segment_id.id);
-                    auto name = facade.GetNameForID(name_id);
-
-                    line_string_index.add(name);
-
-                    const auto encode_tile_line = [&line_layer_writer,
-                                                   &edge,
-                                                   &component_id,
-                                                   &id,
-                                                   &max_datasource_id,
-                                                   &line_int_index](
-                        const FixedLine &tile_line,
-                        const std::uint32_t speed_kmh_idx,
-                        const std::uint32_t rate_idx,
-                        const std::size_t weight_idx,
-                        const std::size_t duration_idx,
-                        const DatasourceID datasource_idx,
-                        const std::size_t name_idx,
-                        std::int32_t &start_x,
-                        std::int32_t &start_y) {
-                        // Here, we save the two attributes for our feature: the speed and
-                        // the is_small boolean.  We only serve up speeds from 0-139, so all we
-                        // do is save the first
-                        protozero::pbf_writer feature_writer(line_layer_writer,
-                                                             util::vector_tile::FEATURE_TAG);
-                        // Field 3 is the "geometry type" field.  Value 2 is "line"
-                        feature_writer.add_enum(
-                            util::vector_tile::GEOMETRY_TAG,
-                            util::vector_tile::GEOMETRY_TYPE_LINE); // geometry type
-                        // Field 1 for the feature is the "id" field.
-                        feature_writer.add_uint64(util::vector_tile::ID_TAG, id++); // id
-                        {
-                            // When adding attributes to a feature, we have to write
-                            // pairs of numbers.  The first value is the index in the
-                            // keys array (written later), and the second value is the
-                            // index into the "values" array (also written later).  We're
-                            // not writing the actual speed or bool value here, we're saving
-                            // an index into the "values" array.  This means many features
-                            // can share the same value data, leading to smaller tiles.
-                            protozero::packed_field_uint32 field(
-                                feature_writer, util::vector_tile::FEATURE_ATTRIBUTES_TAG);
-
-                            field.add_element(0); // "speed" tag key offset
-                            field.add_element(std::min(
-                                speed_kmh_idx, 127u)); // save the speed value, capped at 127
-                            field.add_element(1);      // "is_small" tag key offset
-                            field.add_element(
-                                128 + (component_id.is_tiny ? 0 : 1)); // is_small feature offset
-                            field.add_element(2);                    // "datasource" tag key offset
-                            field.add_element(130 + datasource_idx); // datasource value offset
-                            field.add_element(3);                    // "weight" tag key offset
-                            field.add_element(130 + max_datasource_id + 1 +
-                                              weight_idx); // weight value offset
-                            field.add_element(4);          // "duration" tag key offset
-                            field.add_element(130 + max_datasource_id + 1 +
-                                              duration_idx); // duration value offset
-                            field.add_element(5);            // "name" tag key offset
-
-                            field.add_element(130 + max_datasource_id + 1 +
-                                              line_int_index.values().size() + name_idx);
-
-                            field.add_element(6); // rate tag key offset
-                            field.add_element(130 + max_datasource_id + 1 + rate_idx);
-                        }
-                        {
-
-                            // Encode the geometry for the feature
-                            protozero::packed_field_uint32 geometry(
-                                feature_writer, util::vector_tile::FEATURE_GEOMETRIES_TAG);
-                            encodeLinestring(tile_line, geometry, start_x, start_y);
-                        }
-                    };
-
-                    // If this is a valid forward edge, go ahead and add it to the tile
-                    if (forward_duration != 0 && edge.forward_segment_id.enabled)
-                    {
-                        std::int32_t start_x = 0;
-                        std::int32_t start_y = 0;
-
-                        // Calculate the speed for this line
-                        // Speeds are looked up in a simple 1:1 table, so the speed value == lookup
-                        // table index
-                        std::uint32_t speed_kmh_idx =
-                            static_cast<std::uint32_t>(round(length / forward_duration * 10 * 3.6));
-
-                        // Rate values are in meters per weight-unit - and similar to speeds, we
-                        // present 1 decimal place of precision (these values are added as
-                        // double/10) lower down
-                        std::uint32_t forward_rate =
-                            static_cast<std::uint32_t>(round(length / forward_weight * 10.));
-
-                        auto tile_line = coordinatesToTileLine(a, b, tile_bbox);
-                        if (!tile_line.empty())
-                        {
-                            encode_tile_line(tile_line,
-                                             speed_kmh_idx,
-                                             line_int_index.indexOf(forward_rate),
-                                             line_int_index.indexOf(forward_weight),
-                                             line_int_index.indexOf(forward_duration),
-                                             forward_datasource_idx,
-                                             line_string_index.indexOf(name),
-                                             start_x,
-                                             start_y);
-                        }
-                    }
-
-                    // Repeat the above for the coordinates reversed and using the `reverse`
-                    // properties
-                    if (reverse_duration != 0 && edge.reverse_segment_id.enabled)
-                    {
-                        std::int32_t start_x = 0;
-                        std::int32_t start_y = 0;
-
-                        // Calculate the speed for this line
-                        // Speeds are looked up in a simple 1:1 table, so the speed value == lookup
-                        // table index
-                        std::uint32_t speed_kmh_idx =
-                            static_cast<std::uint32_t>(round(length / reverse_duration * 10 * 3.6));
-
-                        // Rate values are in meters per weight-unit - and similar to speeds, we
-                        // present 1 decimal place of precision (these values are added as
-                        // double/10) lower down
-                        std::uint32_t reverse_rate =
-                            static_cast<std::uint32_t>(round(length / reverse_weight * 10.));
-
-                        auto tile_line = coordinatesToTileLine(b, a, tile_bbox);
-                        if (!tile_line.empty())
-                        {
-                            encode_tile_line(tile_line,
-                                             speed_kmh_idx,
-                                             line_int_index.indexOf(reverse_rate),
-                                             line_int_index.indexOf(reverse_weight),
-                                             line_int_index.indexOf(reverse_duration),
-                                             reverse_datasource_idx,
-                                             line_string_index.indexOf(name),
-                                             start_x,
-                                             start_y);
-                        }
-                    }
-                }
-            }
 
-            // Field id 3 is the "keys" attribute
-            // We need two "key" fields, these are referred to with 0 and 1 (their array
-            // indexes) earlier
-            line_layer_writer.add_string(util::vector_tile::KEY_TAG, "speed");
-            line_layer_writer.add_string(util::vector_tile::KEY_TAG, "is_small");
-            line_layer_writer.add_string(util::vector_tile::KEY_TAG, "datasource");
-            line_layer_writer.add_string(util::vector_tile::KEY_TAG, "weight");
-            line_layer_writer.add_string(util::vector_tile::KEY_TAG, "duration");
-            line_layer_writer.add_string(util::vector_tile::KEY_TAG, "name");
-            line_layer_writer.add_string(util::vector_tile::KEY_TAG, "rate");
-
-            // Now, we write out the possible speed value arrays and possible is_tiny
-            // values.  Field type 4 is the "values" field.  It's a variable type field,
-            // so requires a two-step write (create the field, then write its value)
-            for (std::size_t i = 0; i < 128; i++)
-            {
-                // Writing field type 4 == variant type
-                protozero::pbf_writer values_writer(line_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                // Attribute value 5 == uint64 type
-                values_writer.add_uint64(util::vector_tile::VARIANT_TYPE_UINT64, i);
-            }
-            {
-                protozero::pbf_writer values_writer(line_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                // Attribute value 7 == bool type
-                values_writer.add_bool(util::vector_tile::VARIANT_TYPE_BOOL, true);
-            }
-            {
-                protozero::pbf_writer values_writer(line_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                // Attribute value 7 == bool type
-                values_writer.add_bool(util::vector_tile::VARIANT_TYPE_BOOL, false);
-            }
-            for (std::size_t i = 0; i <= max_datasource_id; i++)
-            {
-                // Writing field type 4 == variant type
-                protozero::pbf_writer values_writer(line_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                // Attribute value 1 == string type
-                values_writer.add_string(util::vector_tile::VARIANT_TYPE_STRING,
-                                         facade.GetDatasourceName(i).to_string());
-            }
-            for (auto value : line_int_index.values())
-            {
-                // Writing field type 4 == variant type
-                protozero::pbf_writer values_writer(line_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                // Attribute value 2 == float type
-                // Durations come out of OSRM in integer deciseconds, so we convert them
-                // to seconds with a simple /10 for display
-                values_writer.add_double(util::vector_tile::VARIANT_TYPE_DOUBLE, value / 10.);
-            }
-
-            for (const auto &name : line_string_index.values())
-            {
-                // Writing field type 4 == variant type
-                protozero::pbf_writer values_writer(line_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                // Attribute value 1 == string type
-                values_writer.add_string(
-                    util::vector_tile::VARIANT_TYPE_STRING, name.data(), name.size());
-            }
-        }
-
-        // Only add the turn layer to the tile if it has some features (we sometimes won't
-        // for tiles of z<16, and tiles that don't show any intersections)
-        if (!all_turn_data.empty())
-        {
-
-            struct EncodedTurnData
-            {
-                util::Coordinate coordinate;
-                std::size_t angle_index;
-                std::size_t turn_index;
-                std::size_t duration_index;
-                std::size_t weight_index;
-                std::size_t turntype_index;
-                std::size_t turnmodifier_index;
-            };
-            // we need to pre-encode all values here because we need the full offsets later
-            // for encoding the actual features.
-            std::vector<EncodedTurnData> encoded_turn_data(all_turn_data.size());
-            std::transform(
-                all_turn_data.begin(),
-                all_turn_data.end(),
-                encoded_turn_data.begin(),
-                [&](const routing_algorithms::TurnData &t) {
-                    auto angle_idx = point_int_index.add(t.in_angle);
-                    auto turn_idx = point_int_index.add(t.turn_angle);
-                    auto duration_idx =
-                        point_float_index.add(t.duration / 10.0); // Note conversion to float here
-                    auto weight_idx =
-                        point_float_index.add(t.weight / 10.0); // Note conversion to float here
-
-                    auto turntype_idx =
-                        point_string_index.add(extractor::guidance::internalInstructionTypeToString(
-                            t.turn_instruction.type));
-                    auto turnmodifier_idx =
-                        point_string_index.add(extractor::guidance::instructionModifierToString(
-                            t.turn_instruction.direction_modifier));
-                    return EncodedTurnData{t.coordinate,
-                                           angle_idx,
-                                           turn_idx,
-                                           duration_idx,
-                                           weight_idx,
-                                           turntype_idx,
-                                           turnmodifier_idx};
-                });
-
-            // Now write the points layer for turn penalty data:
-            // Add a layer object to the PBF stream.  3=='layer' from the vector tile spec
-            // (2.1)
-            protozero::pbf_writer point_layer_writer(tile_writer, util::vector_tile::LAYER_TAG);
-            point_layer_writer.add_uint32(util::vector_tile::VERSION_TAG, 2);    // version
-            point_layer_writer.add_string(util::vector_tile::NAME_TAG, "turns"); // name
-            point_layer_writer.add_uint32(util::vector_tile::EXTENT_TAG,
-                                          util::vector_tile::EXTENT); // extent
-
-            // Begin writing the set of point features
-            {
-                // Start each features with an ID starting at 1
-                int id = 1;
-
-                // Helper function to encode a new point feature on a vector tile.
-                const auto encode_tile_point = [&](const FixedPoint &tile_point,
-                                                   const auto &point_turn_data) {
-                    protozero::pbf_writer feature_writer(point_layer_writer,
+                const auto component_id = facade.GetComponentID(edge.forward_segment_id.id);
+                const auto name_id = facade.GetNameIndex(edge.forward_segment_id.id);
+                auto name = facade.GetNameForID(name_id);
+
+                line_string_index.add(name);
+
+                const auto encode_tile_line = [&line_layer_writer,
+                                               &edge,
+                                               &component_id,
+                                               &id,
+                                               &max_datasource_id,
+                                               &line_int_index](
+                    const FixedLine &tile_line,
+                    const std::uint32_t speed_kmh_idx,
+                    const std::uint32_t rate_idx,
+                    const std::size_t weight_idx,
+                    const std::size_t duration_idx,
+                    const DatasourceID datasource_idx,
+                    const std::size_t name_idx,
+                    std::int32_t &start_x,
+                    std::int32_t &start_y) {
+                    // Here, we save the two attributes for our feature: the speed and
+                    // the is_small boolean.  We only serve up speeds from 0-139, so all we
+                    // do is save the first
+                    protozero::pbf_writer feature_writer(line_layer_writer,
                                                          util::vector_tile::FEATURE_TAG);
-                    // Field 3 is the "geometry type" field.  Value 1 is "point"
+                    // Field 3 is the "geometry type" field.  Value 2 is "line"
                     feature_writer.add_enum(
                         util::vector_tile::GEOMETRY_TAG,
-                        util::vector_tile::GEOMETRY_TYPE_POINT);                // geometry type
+                        util::vector_tile::GEOMETRY_TYPE_LINE); // geometry type
+                    // Field 1 for the feature is the "id" field.
                     feature_writer.add_uint64(util::vector_tile::ID_TAG, id++); // id
                     {
-                        // Write out the 4 properties we want on the feature.  These
-                        // refer to indexes in the properties lookup table, which we
-                        // add to the tile after we add all features.
+                        // When adding attributes to a feature, we have to write
+                        // pairs of numbers.  The first value is the index in the
+                        // keys array (written later), and the second value is the
+                        // index into the "values" array (also written later).  We're
+                        // not writing the actual speed or bool value here, we're saving
+                        // an index into the "values" array.  This means many features
+                        // can share the same value data, leading to smaller tiles.
                         protozero::packed_field_uint32 field(
                             feature_writer, util::vector_tile::FEATURE_ATTRIBUTES_TAG);
-                        field.add_element(0); // "bearing_in" tag key offset
-                        field.add_element(point_turn_data.angle_index);
-                        field.add_element(1); // "turn_angle" tag key offset
-                        field.add_element(point_turn_data.turn_index);
-                        field.add_element(2); // "cost" tag key offset
-                        field.add_element(point_int_index.size() + point_turn_data.duration_index);
-                        field.add_element(3); // "weight" tag key offset
-                        field.add_element(point_int_index.size() + point_turn_data.weight_index);
-                        field.add_element(4); // "type" tag key offset
-                        field.add_element(point_int_index.size() + point_float_index.size() +
-                                          point_turn_data.turntype_index);
-                        field.add_element(5); // "modifier" tag key offset
-                        field.add_element(point_int_index.size() + point_float_index.size() +
-                                          point_turn_data.turnmodifier_index);
+
+                        field.add_element(0); // "speed" tag key offset
+                        field.add_element(std::min(
+                            speed_kmh_idx, 127u)); // save the speed value, capped at 127
+                        field.add_element(1);      // "is_small" tag key offset
+                        field.add_element(
+                            128 + (component_id.is_tiny ? 0 : 1)); // is_small feature offset
+                        field.add_element(2);                    // "datasource" tag key offset
+                        field.add_element(130 + datasource_idx); // datasource value offset
+                        field.add_element(3);                    // "weight" tag key offset
+                        field.add_element(130 + max_datasource_id + 1 +
+                                          weight_idx); // weight value offset
+                        field.add_element(4);          // "duration" tag key offset
+                        field.add_element(130 + max_datasource_id + 1 +
+                                          duration_idx); // duration value offset
+                        field.add_element(5);            // "name" tag key offset
+
+                        field.add_element(130 + max_datasource_id + 1 +
+                                          line_int_index.values().size() + name_idx);
+
+                        field.add_element(6); // rate tag key offset
+                        field.add_element(130 + max_datasource_id + 1 + rate_idx);
                     }
                     {
-                        // Add the geometry as the last field in this feature
+
+                        // Encode the geometry for the feature
                         protozero::packed_field_uint32 geometry(
                             feature_writer, util::vector_tile::FEATURE_GEOMETRIES_TAG);
-                        encodePoint(tile_point, geometry);
+                        encodeLinestring(tile_line, geometry, start_x, start_y);
                     }
                 };
 
-                // Loop over all the turns we found and add them as features to the layer
-                for (const auto &turndata : encoded_turn_data)
+                // If this is a valid forward edge, go ahead and add it to the tile
+                if (forward_duration != 0 && edge.forward_segment_id.enabled)
                 {
-                    const auto tile_point = coordinatesToTilePoint(turndata.coordinate, tile_bbox);
-                    if (!boost::geometry::within(point_t(tile_point.x, tile_point.y), clip_box))
+                    std::int32_t start_x = 0;
+                    std::int32_t start_y = 0;
+
+                    // Calculate the speed for this line
+                    // Speeds are looked up in a simple 1:1 table, so the speed value == lookup
+                    // table index
+                    std::uint32_t speed_kmh_idx =
+                        static_cast<std::uint32_t>(round(length / forward_duration * 10 * 3.6));
+
+                    // Rate values are in meters per weight-unit - and similar to speeds, we
+                    // present 1 decimal place of precision (these values are added as
+                    // double/10) lower down
+                    std::uint32_t forward_rate =
+                        static_cast<std::uint32_t>(round(length / forward_weight * 10.));
+
+                    auto tile_line = coordinatesToTileLine(a, b, tile_bbox);
+                    if (!tile_line.empty())
                     {
-                        continue;
+                        encode_tile_line(tile_line,
+                                         speed_kmh_idx,
+                                         line_int_index.indexOf(forward_rate),
+                                         line_int_index.indexOf(forward_weight),
+                                         line_int_index.indexOf(forward_duration),
+                                         forward_datasource_idx,
+                                         line_string_index.indexOf(name),
+                                         start_x,
+                                         start_y);
                     }
-                    encode_tile_point(tile_point, turndata);
                 }
-            }
 
-            // Add the names of the three attributes we added to all the turn penalty
-            // features previously.  The indexes used there refer to these keys.
-            point_layer_writer.add_string(util::vector_tile::KEY_TAG, "bearing_in");
-            point_layer_writer.add_string(util::vector_tile::KEY_TAG, "turn_angle");
-            point_layer_writer.add_string(util::vector_tile::KEY_TAG, "cost");
-            point_layer_writer.add_string(util::vector_tile::KEY_TAG, "weight");
-            point_layer_writer.add_string(util::vector_tile::KEY_TAG, "type");
-            point_layer_writer.add_string(util::vector_tile::KEY_TAG, "modifier");
-
-            // Now, save the lists of integers and floats that our features refer to.
-            for (const auto &value : point_int_index.values())
-            {
-                protozero::pbf_writer values_writer(point_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                values_writer.add_sint64(util::vector_tile::VARIANT_TYPE_SINT64, value);
-            }
-            for (const auto &value : point_float_index.values())
-            {
-                protozero::pbf_writer values_writer(point_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                values_writer.add_float(util::vector_tile::VARIANT_TYPE_FLOAT, value);
-            }
-            for (const auto &value : point_string_index.values())
-            {
-                protozero::pbf_writer values_writer(point_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                values_writer.add_string(util::vector_tile::VARIANT_TYPE_STRING, value);
+                // Repeat the above for the coordinates reversed and using the `reverse`
+                // properties
+                if (reverse_duration != 0 && edge.reverse_segment_id.enabled)
+                {
+                    std::int32_t start_x = 0;
+                    std::int32_t start_y = 0;
+
+                    // Calculate the speed for this line
+                    // Speeds are looked up in a simple 1:1 table, so the speed value == lookup
+                    // table index
+                    std::uint32_t speed_kmh_idx =
+                        static_cast<std::uint32_t>(round(length / reverse_duration * 10 * 3.6));
+
+                    // Rate values are in meters per weight-unit - and similar to speeds, we
+                    // present 1 decimal place of precision (these values are added as
+                    // double/10) lower down
+                    std::uint32_t reverse_rate =
+                        static_cast<std::uint32_t>(round(length / reverse_weight * 10.));
+
+                    auto tile_line = coordinatesToTileLine(b, a, tile_bbox);
+                    if (!tile_line.empty())
+                    {
+                        encode_tile_line(tile_line,
+                                         speed_kmh_idx,
+                                         line_int_index.indexOf(reverse_rate),
+                                         line_int_index.indexOf(reverse_weight),
+                                         line_int_index.indexOf(reverse_duration),
+                                         reverse_datasource_idx,
+                                         line_string_index.indexOf(name),
+                                         start_x,
+                                         start_y);
+                    }
+                }
             }
         }
 
-        // OSM Node tile layer
+        // Field id 3 is the "keys" attribute
+        // We need two "key" fields, these are referred to with 0 and 1 (their array
+        // indexes) earlier
+        line_layer_writer.add_string(util::vector_tile::KEY_TAG, "speed");
+        line_layer_writer.add_string(util::vector_tile::KEY_TAG, "is_small");
+        line_layer_writer.add_string(util::vector_tile::KEY_TAG, "datasource");
+        line_layer_writer.add_string(util::vector_tile::KEY_TAG, "weight");
+        line_layer_writer.add_string(util::vector_tile::KEY_TAG, "duration");
+        line_layer_writer.add_string(util::vector_tile::KEY_TAG, "name");
+        line_layer_writer.add_string(util::vector_tile::KEY_TAG, "rate");
+
+        // Now, we write out the possible speed value arrays and possible is_tiny
+        // values.  Field type 4 is the "values" field.  It's a variable type field,
+        // so requires a two-step write (create the field, then write its value)
+        for (std::size_t i = 0; i < 128; i++)
         {
-            protozero::pbf_writer point_layer_writer(tile_writer, util::vector_tile::LAYER_TAG);
-            point_layer_writer.add_uint32(util::vector_tile::VERSION_TAG, 2);       // version
-            point_layer_writer.add_string(util::vector_tile::NAME_TAG, "osmnodes"); // name
-            point_layer_writer.add_uint32(util::vector_tile::EXTENT_TAG,
-                                          util::vector_tile::EXTENT); // extent
-
-            std::vector<NodeID> internal_nodes;
-            internal_nodes.reserve(edges.size() * 2);
-            for (const auto &edge : edges)
-            {
-                internal_nodes.push_back(edge.u);
-                internal_nodes.push_back(edge.v);
-            }
-            std::sort(internal_nodes.begin(), internal_nodes.end());
-            auto new_end = std::unique(internal_nodes.begin(), internal_nodes.end());
-            internal_nodes.resize(new_end - internal_nodes.begin());
+            // Writing field type 4 == variant type
+            protozero::pbf_writer values_writer(line_layer_writer,
+                                                util::vector_tile::VARIANT_TAG);
+            // Attribute value 5 == uint64 type
+            values_writer.add_uint64(util::vector_tile::VARIANT_TYPE_UINT64, i);
+        }
+        {
+            protozero::pbf_writer values_writer(line_layer_writer,
+                                                util::vector_tile::VARIANT_TAG);
+            // Attribute value 7 == bool type
+            values_writer.add_bool(util::vector_tile::VARIANT_TYPE_BOOL, true);
+        }
+        {
+            protozero::pbf_writer values_writer(line_layer_writer,
+                                                util::vector_tile::VARIANT_TAG);
+            // Attribute value 7 == bool type
+            values_writer.add_bool(util::vector_tile::VARIANT_TYPE_BOOL, false);
+        }
+        for (std::size_t i = 0; i <= max_datasource_id; i++)
+        {
+            // Writing field type 4 == variant type
+            protozero::pbf_writer values_writer(line_layer_writer,
+                                                util::vector_tile::VARIANT_TAG);
+            // Attribute value 1 == string type
+            values_writer.add_string(util::vector_tile::VARIANT_TYPE_STRING,
+                                     facade.GetDatasourceName(i).to_string());
+        }
+        for (auto value : line_int_index.values())
+        {
+            // Writing field type 4 == variant type
+            protozero::pbf_writer values_writer(line_layer_writer,
+                                                util::vector_tile::VARIANT_TAG);
+            // Attribute value 2 == float type
+            // Durations come out of OSRM in integer deciseconds, so we convert them
+            // to seconds with a simple /10 for display
+            values_writer.add_double(util::vector_tile::VARIANT_TYPE_DOUBLE, value / 10.);
+        }
 
-            for (const auto &internal_node : internal_nodes)
-            {
-                const auto coord = facade.GetCoordinateOfNode(internal_node);
-                const auto tile_point = coordinatesToTilePoint(coord, tile_bbox);
-                if (!boost::geometry::within(point_t(tile_point.x, tile_point.y), clip_box))
-                {
-                    continue;
-                }
+        for (const auto &name : line_string_index.values())
+        {
+            // Writing field type 4 == variant type
+            protozero::pbf_writer values_writer(line_layer_writer,
+                                                util::vector_tile::VARIANT_TAG);
+            // Attribute value 1 == string type
+            values_writer.add_string(
+                util::vector_tile::VARIANT_TYPE_STRING, name.data(), name.size());
+        }
+    }
+
+    // protozero serializes data during object destructors, so once the scope closes,
+    // our result buffer will have all the layer data encoded into it.
+}
+
+// Encodes the point layer with the turn penalties as a vector tile of its own
+void encodeTurnLayer(const BBox &tile_bbox,
+                     const std::vector<routing_algorithms::TurnData> &all_turn_data,
+                     std::string &pbf_buffer)
+{
+    // Vector tiles encode properties on features as indexes into a layer-specific
+    // lookup table, see encodeSpeedLayer.
+    ValueIndexer<int> point_int_index;
+    ValueIndexer<float> point_float_index;
+    ValueIndexer<std::string> point_string_index;
+
+    // Protobuf serializes blocks when objects go out of scope, hence
+    // the extra scoping below.
+    protozero::pbf_writer tile_writer{pbf_buffer};
+
+    // Only add the turn layer to the tile if it has some features (we sometimes won't
+    // for tiles of z<15, and tiles that don't show any intersections)
+    if (!all_turn_data.empty())
+    {
+
+        struct EncodedTurnData
+        {
+            util::Coordinate coordinate;
+            std::size_t angle_index;
+            std::size_t turn_index;
+            std::size_t duration_index;
+            std::size_t weight_index;
+            std::size_t turntype_index;
+            std::size_t turnmodifier_index;
+        };
+        // we need to pre-encode all values here because we need the full offsets later
+        // for encoding the actual features.
+        std::vector<EncodedTurnData> encoded_turn_data(all_turn_data.size());
+        std::transform(
+            all_turn_data.begin(),
+            all_turn_data.end(),
+            encoded_turn_data.begin(),
+            [&](const routing_algorithms::TurnData &t) {
+                auto angle_idx = point_int_index.add(t.in_angle);
+                auto turn_idx = point_int_index.add(t.turn_angle);
+                auto duration_idx =
+                    point_float_index.add(t.duration / 10.0); // Note conversion to float here
+                auto weight_idx =
+                    point_float_index.add(t.weight / 10.0); // Note conversion to float here
+
+                auto turntype_idx =
+                    point_string_index.add(extractor::guidance::internalInstructionTypeToString(
+                        t.turn_instruction.type));
+                auto turnmodifier_idx =
+                    point_string_index.add(extractor::guidance::instructionModifierToString(
+                        t.turn_instruction.direction_modifier));
+                return EncodedTurnData{t.coordinate,
+                                       angle_idx,
+                                       turn_idx,
+                                       duration_idx,
+                                       weight_idx,
+                                       turntype_idx,
+                                       turnmodifier_idx};
+            });
+
+        // Now write the points layer for turn penalty data:
+        // Add a layer object to the PBF stream.  3=='layer' from the vector tile spec
+        // (2.1)
+        protozero::pbf_writer point_layer_writer(tile_writer, util::vector_tile::LAYER_TAG);
+        point_layer_writer.add_uint32(util::vector_tile::VERSION_TAG, 2);    // version
+        point_layer_writer.add_string(util::vector_tile::NAME_TAG, "turns"); // name
+        point_layer_writer.add_uint32(util::vector_tile::EXTENT_TAG,
+                                      util::vector_tile::EXTENT); // extent
+
+        // Begin writing the set of point features
+        {
+            // Start each features with an ID starting at 1
+            int id = 1;
+
+            // Helper function to encode a new point feature on a vector tile.
+            const auto encode_tile_point = [&](const FixedPoint &tile_point,
+                                               const auto &point_turn_data) {
                 protozero::pbf_writer feature_writer(point_layer_writer,
                                                      util::vector_tile::FEATURE_TAG);
                 // Field 3 is the "geometry type" field.  Value 1 is "point"
-                feature_writer.add_enum(util::vector_tile::GEOMETRY_TAG,
-                                        util::vector_tile::GEOMETRY_TYPE_POINT); // geometry type
-                const auto osmid =
-                    static_cast<OSMNodeID::value_type>(facade.GetOSMNodeIDOfNode(internal_node));
-                feature_writer.add_uint64(util::vector_tile::ID_TAG, osmid); // id
-                // There are no additional properties, just the ID and the geometry
+                feature_writer.add_enum(
+                    util::vector_tile::GEOMETRY_TAG,
+                    util::vector_tile::GEOMETRY_TYPE_POINT);                // geometry type
+                feature_writer.add_uint64(util::vector_tile::ID_TAG, id++); // id
+                {
+                    // Write out the 4 properties we want on the feature.  These
+                    // refer to indexes in the properties lookup table, which we
+                    // add to the tile after we add all features.
+                    protozero::packed_field_uint32 field(
+                        feature_writer, util::vector_tile::FEATURE_ATTRIBUTES_TAG);
+                    field.add_element(0); // "bearing_in" tag key offset
+                    field.add_element(point_turn_data.angle_index);
+                    field.add_element(1); // "turn_angle" tag key offset
+                    field.add_element(point_turn_data.turn_index);
+                    field.add_element(2); // "cost" tag key offset
+                    field.add_element(point_int_index.size() + point_turn_data.duration_index);
+                    field.add_element(3); // "weight" tag key offset
+                    field.add_element(point_int_index.size() + point_turn_data.weight_index);
+                    field.add_element(4); // "type" tag key offset
+                    field.add_element(point_int_index.size() + point_float_index.size() +
+                                      point_turn_data.turntype_index);
+                    field.add_element(5); // "modifier" tag key offset
+                    field.add_element(point_int_index.size() + point_float_index.size() +
+                                      point_turn_data.turnmodifier_index);
+                }
                 {
                     // Add the geometry as the last field in this feature
                     protozero::packed_field_uint32 geometry(
                         feature_writer, util::vector_tile::FEATURE_GEOMETRIES_TAG);
                     encodePoint(tile_point, geometry);
                 }
+            };
+
+            // Loop over all the turns we found and add them as features to the layer
+            for (const auto &turndata : encoded_turn_data)
+            {
+                const auto tile_point = coordinatesToTilePoint(turndata.coordinate, tile_bbox);
+                if (!boost::geometry::within(point_t(tile_point.x, tile_point.y), clip_box))
+                {
+                    continue;
+                }
+                encode_tile_point(tile_point, turndata);
             }
         }
+
+        // Add the names of the three attributes we added to all the turn penalty
+        // features previously.  The indexes used there refer to these keys.
+        point_layer_writer.add_string(util::vector_tile::KEY_TAG, "bearing_in");
+        point_layer_writer.add_string(util::vector_tile::KEY_TAG, "turn_angle");
+        point_layer_writer.add_string(util::vector_tile::KEY_TAG, "cost");
+        point_layer_writer.add_string(util::vector_tile::KEY_TAG, "weight");
+        point_layer_writer.add_string(util::vector_tile::KEY_TAG, "type");
+        point_layer_writer.add_string(util::vector_tile::KEY_TAG, "modifier");
+
+        // Now, save the lists of integers and floats that our features refer to.
+        for (const auto &value : point_int_index.values())
+        {
+            protozero::pbf_writer values_writer(point_layer_writer,
+                                                util::vector_tile::VARIANT_TAG);
+            values_writer.add_sint64(util::vector_tile::VARIANT_TYPE_SINT64, value);
+        }
+        for (const auto &value : point_float_index.values())
+        {
+            protozero::pbf_writer values_writer(point_layer_writer,
+                                                util::vector_tile::VARIANT_TAG);
+            values_writer.add_float(util::vector_tile::VARIANT_TYPE_FLOAT, value);
+        }
+        for (const auto &value : point_string_index.values())
+        {
+            protozero::pbf_writer values_writer(point_layer_writer,
+                                                util::vector_tile::VARIANT_TAG);
+            values_writer.add_string(util::vector_tile::VARIANT_TYPE_STRING, value);
+        }
     }
+
     // protozero serializes data during object destructors, so once the scope closes,
-    // our result buffer will have all the tile data encoded into it.
+    // our result buffer will have all the layer data encoded into it.
 }
+
+// Encodes the point layer with the OSM ids of all nodes as a vector tile of its own
+void encodeOSMNodeLayer(const DataFacadeBase &facade,
+                        const BBox &tile_bbox,
+                        const std::vector<RTreeLeaf> &edges,
+                        std::string &pbf_buffer)
+{
+    // Protobuf serializes blocks when objects go out of scope, hence
+    // the extra scoping below.
+    protozero::pbf_writer tile_writer{pbf_buffer};
+
+    // OSM Node tile layer
+    {
+        protozero::pbf_writer point_layer_writer(tile_writer, util::vector_tile::LAYER_TAG);
+        point_layer_writer.add_uint32(util::vector_tile::VERSION_TAG, 2);       // version
+        point_layer_writer.add_string(util::vector_tile::NAME_TAG, "osmnodes"); // name
+        point_layer_writer.add_uint32(util::vector_tile::EXTENT_TAG,
+                                      util::vector_tile::EXTENT); // extent
+
+        std::vector<NodeID> internal_nodes;
+        internal_nodes.reserve(edges.size() * 2);
+        for (const auto &edge : edges)
+        {
+            internal_nodes.push_back(edge.u);
+            internal_nodes.push_back(edge.v);
+        }
+        std::sort(internal_nodes.begin(), internal_nodes.end());
+        auto new_end = std::unique(internal_nodes.begin(), internal_nodes.end());
+        internal_nodes.resize(new_end - internal_nodes.begin());
+
+        for (const auto &internal_node : internal_nodes)
+        {
+            const auto coord = facade.GetCoordinateOfNode(internal_node);
+            const auto tile_point = coordinatesToTilePoint(coord, tile_bbox);
+            if (!boost::geometry::within(point_t(tile_point.x, tile_point.y), clip_box))
+            {
+                continue;
+            }
+            protozero::pbf_writer feature_writer(point_layer_writer,
+                                                 util::vector_tile::FEATURE_TAG);
+            // Field 3 is the "geometry type" field.  Value 1 is "point"
+            feature_writer.add_enum(util::vector_tile::GEOMETRY_TAG,
+                                    util::vector_tile::GEOMETRY_TYPE_POINT); // geometry type
+            const auto osmid =
+                static_cast<OSMNodeID::value_type>(facade.GetOSMNodeIDOfNode(internal_node));
+            feature_writer.add_uint64(util::vector_tile::ID_TAG, osmid); // id
+            // There are no additional properties, just the ID and the geometry
+            {
+                // Add the geometry as the last field in this feature
+                protozero::packed_field_uint32 geometry(
+                    feature_writer, util::vector_tile::FEATURE_GEOMETRIES_TAG);
+                encodePoint(tile_point, geometry);
+            }
+        }
+    }
+
+    // protozero serializes data during object destructors, so once the scope closes,
+    // our result buffer will have all the layer data encoded into it.
+}
+
+// Encodes the speeds on the road overview for tiles of low zoom levels. A simplified line
+// covers several segments of its packed geometry, their durations are read from the live
+// segment data and summed up.
+void encodeOverviewLayer(const DataFacadeBase &facade,
+                         const BBox &tile_bbox,
+                         const extractor::RoadOverview &overview,
+                         const std::vector<std::uint32_t> &lines,
+                         const unsigned z,
+                         std::string &pbf_buffer)
+{
+    struct OverviewFeature
+    {
+        FixedLine tile_line;
+        std::uint32_t speed_kmh_idx;
+        std::size_t duration_idx;
+    };
+
+    ValueIndexer<int> line_int_index;
+    std::vector<OverviewFeature> features;
+
+    const auto add_feature = [&](const util::Coordinate from,
+                                 const util::Coordinate to,
+                                 const double length,
+                                 const EdgeWeight duration) {
+        if (duration == 0)
+        {
+            return;
+        }
+        auto tile_line = coordinatesToTileLine(from, to, tile_bbox);
+        if (!tile_line.empty())
+        {
+            // Speeds are looked up in a simple 1:1 table, so the speed value == lookup
+            // table index
+            const auto speed_kmh_idx =
+                static_cast<std::uint32_t>(round(length / duration * 10 * 3.6));
+            features.push_back(OverviewFeature{
+                std::move(tile_line), speed_kmh_idx, line_int_index.add(duration)});
+        }
+    };
+
+    for (const auto line_id : lines)
+    {
+        const auto &line = overview.GetLine(line_id);
+        const auto points = overview.GetPoints(line_id);
+
+        const auto forward_durations = facade.GetUncompressedForwardDurations(line.geometry_id);
+        const auto reverse_durations = facade.GetUncompressedReverseDurations(line.geometry_id);
+
+        auto from = points.begin();
+        for (auto to = std::next(from); to != points.end(); ++to)
+        {
+            if (to->min_zoom > z)
+            {
+                continue;
+            }
+            BOOST_ASSERT(to->position <= forward_durations.size());
+
+            const double length = to->distance - from->distance;
+            if (line.forward_enabled)
+            {
+                const auto duration =
+                    std::accumulate(forward_durations.begin() + from->position,
+                                    forward_durations.begin() + to->position,
+                                    EdgeWeight{0});
+                add_feature(from->coordinate, to->coordinate, length, duration);
+            }
+            if (line.reverse_enabled)
+            {
+                // the reverse durations are stored in the opposite order
+                const auto duration =
+                    std::accumulate(reverse_durations.end() - to->position,
+                                    reverse_durations.end() - from->position,
+                                    EdgeWeight{0});
+                add_feature(to->coordinate, from->coordinate, length, duration);
+            }
+            from = to;
+        }
+    }
+
+    // Protobuf serializes blocks when objects go out of scope, hence
+    // the extra scoping below.
+    protozero::pbf_writer tile_writer{pbf_buffer};
+    {
+        protozero::pbf_writer line_layer_writer(tile_writer, util::vector_tile::LAYER_TAG);
+        line_layer_writer.add_uint32(util::vector_tile::VERSION_TAG, 2);     // version
+        line_layer_writer.add_string(util::vector_tile::NAME_TAG, "speeds"); // name
+        line_layer_writer.add_uint32(util::vector_tile::EXTENT_TAG,
+                                     util::vector_tile::EXTENT); // extent
+
+        // Each feature gets a unique id, starting at 1
+        unsigned id = 1;
+        for (const auto &feature : features)
+        {
+            protozero::pbf_writer feature_writer(line_layer_writer,
+                                                 util::vector_tile::FEATURE_TAG);
+            feature_writer.add_enum(util::vector_tile::GEOMETRY_TAG,
+                                    util::vector_tile::GEOMETRY_TYPE_LINE); // geometry type
+            feature_writer.add_uint64(util::vector_tile::ID_TAG, id++);     // id
+            {
+                protozero::packed_field_uint32 field(
+                    feature_writer, util::vector_tile::FEATURE_ATTRIBUTES_TAG);
+                field.add_element(0); // "speed" tag key offset
+                field.add_element(std::min(feature.speed_kmh_idx, 127u)); // capped at 127
+                field.add_element(1); // "duration" tag key offset
+                field.add_element(128 + feature.duration_idx);
+            }
+            {
+                std::int32_t start_x = 0;
+                std::int32_t start_y = 0;
+                protozero::packed_field_uint32 geometry(
+                    feature_writer, util::vector_tile::FEATURE_GEOMETRIES_TAG);
+                encodeLinestring(feature.tile_line, geometry, start_x, start_y);
+            }
+        }
+
+        line_layer_writer.add_string(util::vector_tile::KEY_TAG, "speed");
+        line_layer_writer.add_string(util::vector_tile::KEY_TAG, "duration");
+
+        for (std::size_t i = 0; i < 128; i++)
+        {
+            protozero::pbf_writer values_writer(line_layer_writer,
+                                                util::vector_tile::VARIANT_TAG);
+            values_writer.add_uint64(util::vector_tile::VARIANT_TYPE_UINT64, i);
+        }
+        for (auto value : line_int_index.values())
+        {
+            protozero::pbf_writer values_writer(line_layer_writer,
+                                                util::vector_tile::VARIANT_TAG);
+            // Durations come out of OSRM in integer deciseconds
+            values_writer.add_double(util::vector_tile::VARIANT_TYPE_DOUBLE, value / 10.);
+        }
+    }
+}
+}
+
+TilePlugin::TilePlugin(const std::size_t max_cache_bytes,
+                       const boost::filesystem::path &archive_path,
+                       const storage::StorageConfig &storage_config)
+    : cache(max_cache_bytes), weights_fingerprint(getWeightsFingerprint(storage_config))
+{
+    if (!archive_path.empty())
+    {
+        readTileArchive(archive_path, archive);
+        util::Log() << "Mapped " << archive.Size() << " tiles from " << archive_path.string();
+        if (archive.GetDatasetGeneration() == 0 &&
+            archive.GetWeightsFingerprint() != weights_fingerprint)
+        {
+            util::Log(logWARNING) << "The weights changed since " << archive_path.string()
+                                  << " was rendered, its tiles are not served for these files";
+        }
+    }
+    const auto overview_path = storage_config.GetPath(".osrm.overview");
+    if (boost::filesystem::exists(overview_path))
+    {
+        extractor::files::readRoadOverview(overview_path, overview);
+        util::Log() << "Loaded road overview of " << overview.GetNumberOfLines() << " roads";
+    }
 }
 
 Status TilePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
@@ -880,21 +1069,80 @@ Status TilePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
     BOOST_ASSERT(parameters.IsValid());
 
     const auto &facade = algorithms.GetFacade();
-    auto edges = getEdges(facade, parameters.x, parameters.y, parameters.z);
 
-    auto edge_index = getEdgeIndex(edges);
+    // The archive and the cache only hold tiles of the dataset they were made for. Weight
+    // updates keep the timestamp of the OSM data but change the generation of the dataset.
+    // Data read from files has no generation, it is told apart by its weight files.
+    const auto generation = facade.GetDatasetGeneration();
+    if (archive.Size() > 0 && archive.GetTimestamp() == facade.GetTimestamp() &&
+        archive.GetDatasetGeneration() == generation &&
+        (generation != 0 || archive.GetWeightsFingerprint() == weights_fingerprint))
+    {
+        if (auto tile = archive.Find(parameters.z, parameters.x, parameters.y))
+        {
+            pbf_buffer = std::move(*tile);
+            return Status::Ok;
+        }
+    }
+
+    // Walking the r-tree is too slow for tiles of low zoom levels, they only show the road
+    // overview. Those tiles are not cached to always show the current speeds.
+    if (parameters.z <= extractor::RoadOverview::MAX_ZOOM)
+    {
+        if (overview.GetNumberOfLines() == 0 || overview.GetTimestamp() != facade.GetTimestamp())
+        {
+            pbf_buffer = "No road overview is loaded for this dataset, tiles of zoom level " +
+                         std::to_string(extractor::RoadOverview::MAX_ZOOM) +
+                         " and below need osrm-extract --road-overview";
+            return Status::Error;
+        }
 
-    std::vector<routing_algorithms::TurnData> turns;
+        const auto lines = overview.GetLines(parameters.x, parameters.y, parameters.z);
+        encodeOverviewLayer(facade,
+                            getTileBBox(parameters.x, parameters.y, parameters.z),
+                            overview,
+                            lines,
+                            parameters.z,
+                            pbf_buffer);
+        return Status::Ok;
+    }
 
-    // If we're zooming into 16 or higher, include turn data.  Why?  Because turns make the map
-    // really cramped, so we don't bother including the data for tiles that span a large area.
-    if (parameters.z >= MIN_ZOOM_FOR_TURNS && algorithms.HasGetTileTurns())
+    const TileKey key{parameters.z, parameters.x, parameters.y};
+    if (auto tile = cache.Get(key, generation))
     {
-        turns = algorithms.GetTileTurns(edges, edge_index);
+        pbf_buffer = std::move(*tile);
+        return Status::Ok;
     }
 
-    encodeVectorTile(
-        facade, parameters.x, parameters.y, parameters.z, edges, edge_index, turns, pbf_buffer);
+    const auto edges = getEdges(facade, parameters.x, parameters.y, parameters.z);
+
+    const auto edge_index = getEdgeIndex(edges);
+
+    const auto tile_bbox = getTileBBox(parameters.x, parameters.y, parameters.z);
+
+    // A vector tile is a sequence of layers, so the layers are encoded concurrently into
+    // buffers of their own and then concatenated in a fixed order.
+    std::string speed_layer;
+    std::string turn_layer;
+    std::string osmnode_layer;
+    tbb::parallel_invoke(
+        [&] { encodeSpeedLayer(facade, tile_bbox, edges, edge_index, speed_layer); },
+        [&] {
+            // If we're zooming into 15 or higher, include turn data.  Why?  Because turns make
+            // the map really cramped, so we don't bother including the data for tiles that span
+            // a large area.
+            if (parameters.z >= MIN_ZOOM_FOR_TURNS && algorithms.HasGetTileTurns())
+            {
+                const auto turns = algorithms.GetTileTurns(edges, edge_index);
+                encodeTurnLayer(tile_bbox, turns, turn_layer);
+            }
+        },
+        [&] { encodeOSMNodeLayer(facade, tile_bbox, edges, osmnode_layer); });
+
+    pbf_buffer.reserve(speed_layer.size() + turn_layer.size() + osmnode_layer.size());
+    pbf_buffer.append(speed_layer).append(turn_layer).append(osmnode_layer);
+
+    cache.Put(key, generation, pbf_buffer);
 
     return Status::Ok;
 }
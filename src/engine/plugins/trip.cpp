@@ -3,7 +3,9 @@
 #include "engine/api/trip_api.hpp"
 #include "engine/api/trip_parameters.hpp"
 #include "engine/trip/trip_brute_force.hpp"
+#include "engine/trip/trip_constrained.hpp"
 #include "engine/trip/trip_farthest_insertion.hpp"
+#include "engine/trip/trip_local_search.hpp"
 #include "engine/trip/trip_nearest_neighbour.hpp"
 #include "util/dist_table_wrapper.hpp" // to access the dist table more easily
 #include "util/json_container.hpp"
@@ -159,8 +161,29 @@ Status TripPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                      json_result);
     }
 
-    BOOST_ASSERT(parameters.IsValid());
+    // a negative bound would silently turn into NoTrips, library users do not pass
+    // through the service's validation
+    if (parameters.max_duration && !(*parameters.max_duration >= 0))
+    {
+        return Error("InvalidOptions",
+                     "Max. duration needs to be a non-negative number of seconds.",
+                     json_result);
+    }
+
+    // precedences index into the coordinates when building the trips
     const auto number_of_locations = parameters.coordinates.size();
+    for (const auto &precedence : parameters.precedences)
+    {
+        if (precedence.first >= number_of_locations || precedence.second >= number_of_locations ||
+            precedence.first == precedence.second)
+        {
+            return Error("InvalidOptions",
+                         "Precedences need to be pairs of two different coordinate indices.",
+                         json_result);
+        }
+    }
+
+    BOOST_ASSERT(parameters.IsValid());
 
     std::size_t source_id = INVALID_INDEX;
     std::size_t destination_id = INVALID_INDEX;
@@ -233,21 +256,53 @@ Status TripPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
         return Error("NoTrips", "No trip visiting all destinations possible.", json_result);
     }
 
-    if (fixed_start && fixed_end)
-    {
-        ManipulateTableForFSE(source_id, destination_id, result_table);
-    }
-
     std::vector<NodeID> trip;
     trip.reserve(number_of_locations);
-    // get an optimized order in which the destinations should be visited
-    if (number_of_locations < BF_MAX_FEASABLE)
+    if (parameters.IsConstrained())
     {
-        trip = trip::BruteForceTrip(number_of_locations, result_table);
+        // the trip is searched in the order it is returned in, see the rotation below
+        const NodeID start =
+            fixed_end && !fixed_start && parameters.roundtrip ? destination_id : 0;
+        const NodeID end = fixed_start && fixed_end ? destination_id : SPECIAL_NODEID;
+        // durations in the table are in deciseconds
+        const auto max_duration =
+            parameters.max_duration
+                ? static_cast<EdgeWeight>(std::min<double>(*parameters.max_duration * 10.,
+                                                           INVALID_EDGE_WEIGHT))
+                : INVALID_EDGE_WEIGHT;
+
+        trip = trip::ConstrainedTrip(number_of_locations,
+                                     result_table,
+                                     start,
+                                     end,
+                                     parameters.roundtrip,
+                                     parameters.precedences,
+                                     max_duration,
+                                     max_search_time);
+        if (trip.empty())
+        {
+            return Error("NoTrips",
+                         "No trip satisfies the precedences and the maximum duration.",
+                         json_result);
+        }
     }
     else
     {
-        trip = trip::FarthestInsertionTrip(number_of_locations, result_table);
+        if (fixed_start && fixed_end)
+        {
+            ManipulateTableForFSE(source_id, destination_id, result_table);
+        }
+
+        // get an optimized order in which the destinations should be visited
+        if (number_of_locations < BF_MAX_FEASABLE)
+        {
+            trip = trip::BruteForceTrip(number_of_locations, result_table);
+        }
+        else
+        {
+            trip = trip::FarthestInsertionTrip(number_of_locations, result_table);
+            trip = trip::LocalSearchTrip(std::move(trip), result_table, max_search_time);
+        }
     }
 
     // rotate result such that roundtrip starts at node with index 0
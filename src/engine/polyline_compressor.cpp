@@ -14,48 +14,49 @@ namespace engine
 namespace detail // anonymous to keep TU local
 {
 
-std::string encode(int number_to_encode)
-{
-    std::string output;
-    while (number_to_encode >= 0x20)
-    {
-        const int next_value = (0x20 | (number_to_encode & 0x1f)) + 63;
-        output += static_cast<char>(next_value);
-        number_to_encode >>= 5;
-    }
-
-    number_to_encode += 63;
-    output += static_cast<char>(number_to_encode);
-    return output;
-}
-
 std::string encode(std::vector<int> &numbers)
 {
-    std::string output;
+    // varint coding parameters
+    const std::uint32_t bits_in_chunk = 5;
+    const std::uint32_t continuation_bit = 1 << bits_in_chunk;
+    const std::uint32_t chunk_mask = (1 << bits_in_chunk) - 1;
+
+    // Change two's complement to "zig-zag" sign coding and count the characters needed for
+    // every number. There are no branches in here so that the loop can be vectorized.
+    std::size_t size = 0;
     for (auto &number : numbers)
     {
-        if (number < 0)
-        {
-            const unsigned binary = std::llabs(number);
-            const unsigned twos = (~binary) + 1u;
-            const unsigned shl = twos << 1u;
-            number = static_cast<int>(~shl);
-        }
-        else
-        {
-            number <<= 1u;
-        }
+        const auto value = static_cast<std::uint32_t>(number);
+        const auto zigzag = (value << 1) ^ (0u - (value >> 31));
+        number = static_cast<int>(zigzag);
+        size += 1 + (zigzag >= (1u << 5)) + (zigzag >= (1u << 10)) + (zigzag >= (1u << 15)) +
+                (zigzag >= (1u << 20)) + (zigzag >= (1u << 25)) + (zigzag >= (1u << 30));
     }
+
+    std::string output(size, '\0');
+    auto *out = &output[0];
     for (const int number : numbers)
     {
-        output += encode(number);
+        auto value = static_cast<std::uint32_t>(number);
+        while (value >= continuation_bit)
+        {
+            *out++ = static_cast<char>((continuation_bit | (value & chunk_mask)) + 63);
+            value >>= bits_in_chunk;
+        }
+        *out++ = static_cast<char>(value + 63);
     }
+    BOOST_ASSERT(out == output.data() + output.size());
     return output;
 }
 
+std::size_t count_polyline_integers(const char *first, const char *last)
+{
+    // the last chunk of every integer has no continuation bit, [?.._]
+    return std::count_if(first, last, [](const char value) { return value - 63 < 0x20; });
+}
+
 // https://developers.google.com/maps/documentation/utilities/polylinealgorithm
-std::int32_t decode_polyline_integer(std::string::const_iterator &first,
-                                     std::string::const_iterator last)
+std::int32_t decode_polyline_integer(const char *&first, const char *last)
 {
     // varint coding parameters
     const std::uint32_t bits_in_chunk = 5;
@@ -5,9 +5,11 @@
 #include "engine/map_matching/hidden_markov_model.hpp"
 #include "engine/map_matching/matching_confidence.hpp"
 #include "engine/map_matching/sub_matching.hpp"
+#include "engine/map_matching/transition_cache.hpp"
 
 #include "util/coordinate_calculation.hpp"
 #include "util/for_each_pair.hpp"
+#include "util/log.hpp"
 
 #include <algorithm>
 #include <cstddef>
@@ -46,6 +48,42 @@ unsigned getMedianSampleTime(const std::vector<unsigned> &timestamps)
     std::nth_element(first_elem, median, sample_times.end());
     return *median;
 }
+
+// Returns the latest timestamp at which the paths to all candidates of the given timestamp
+// go through a single candidate, or INVALID_STATE if they only meet before first_timestamp.
+std::size_t getConvergedTimestamp(const HMM &model,
+                                  const std::size_t first_timestamp,
+                                  std::size_t timestamp)
+{
+    std::vector<std::size_t> frontier;
+    for (const auto s : util::irange<std::size_t>(0UL, model.viterbi[timestamp].size()))
+    {
+        if (!model.pruned[timestamp][s])
+        {
+            frontier.push_back(s);
+        }
+    }
+
+    while (frontier.size() > 1 && timestamp > first_timestamp)
+    {
+        // all candidates of a timestamp share the same parent timestamp
+        const auto parent_timestamp = model.parents[timestamp][frontier.front()].first;
+        if (parent_timestamp == timestamp)
+        {
+            break;
+        }
+
+        for (auto &s : frontier)
+        {
+            s = model.parents[timestamp][s].second;
+        }
+        std::sort(frontier.begin(), frontier.end());
+        frontier.erase(std::unique(frontier.begin(), frontier.end()), frontier.end());
+        timestamp = parent_timestamp;
+    }
+
+    return frontier.size() == 1 ? timestamp : map_matching::INVALID_STATE;
+}
 }
 
 template <typename Algorithm>
@@ -137,6 +175,8 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
     auto &forward_heap = *engine_working_data.forward_heap_1;
     auto &reverse_heap = *engine_working_data.reverse_heap_1;
 
+    map_matching::TransitionCache transition_cache;
+
     std::size_t breakage_begin = map_matching::INVALID_STATE;
     std::vector<std::size_t> split_points;
     std::vector<std::size_t> prev_unbroken_timestamps;
@@ -203,13 +243,38 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
             const EdgeWeight weight_upper_bound =
                 ((haversine_distance + max_distance_delta) / 4.) * facade.GetWeightMultiplier();
 
-            // compute d_t for this timestamp and the next one
+            std::vector<PhantomNode> target_phantoms;
+            target_phantoms.reserve(current_timestamps_list.size());
+            for (const auto &candidate : current_timestamps_list)
+            {
+                target_phantoms.push_back(candidate.phantom_node);
+            }
+
+            // network distances from all unpruned candidates of the previous timestamp
+            // to all candidates of this one
+            std::vector<std::size_t> prev_candidates;
+            std::vector<PhantomNode> source_phantoms;
             for (const auto s : util::irange<std::size_t>(0UL, prev_viterbi.size()))
             {
-                if (prev_pruned[s])
+                if (!prev_pruned[s])
                 {
-                    continue;
+                    prev_candidates.push_back(s);
+                    source_phantoms.push_back(prev_unbroken_timestamps_list[s].phantom_node);
                 }
+            }
+            const auto network_distances =
+                transition_cache.GetNetworkDistances(engine_working_data,
+                                                     facade,
+                                                     forward_heap,
+                                                     reverse_heap,
+                                                     source_phantoms,
+                                                     target_phantoms,
+                                                     weight_upper_bound);
+
+            // compute d_t for this timestamp and the next one
+            for (const auto row : util::irange<std::size_t>(0UL, prev_candidates.size()))
+            {
+                const auto s = prev_candidates[row];
 
                 for (const auto s_prime : util::irange<std::size_t>(0UL, current_viterbi.size()))
                 {
@@ -220,14 +285,8 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
                         continue;
                     }
 
-                    double network_distance =
-                        getNetworkDistance(engine_working_data,
-                                           facade,
-                                           forward_heap,
-                                           reverse_heap,
-                                           prev_unbroken_timestamps_list[s].phantom_node,
-                                           current_timestamps_list[s_prime].phantom_node,
-                                           weight_upper_bound);
+                    const double network_distance =
+                        network_distances[row * current_viterbi.size() + s_prime];
 
                     // get distance diff between loc1/2 and locs/s_prime
                     const auto d_t = std::abs(network_distance - haversine_distance);
@@ -413,10 +472,34 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
 
         matching.confidence = confidence(trace_distance, matching_distance);
 
+        // Only the last sub-matching can change when more points are appended, and only
+        // after the point where the paths to all of its final candidates meet
+        matching.converged_nodes = matching.nodes.size();
+        if (sub_matching_end == split_points.back())
+        {
+            const auto converged_timestamp =
+                getConvergedTimestamp(model, sub_matching_begin, sub_matching_last_timestamp);
+            matching.converged_nodes =
+                std::count_if(matching.indices.begin(),
+                              matching.indices.end(),
+                              [converged_timestamp](const unsigned index) {
+                                  return converged_timestamp != map_matching::INVALID_STATE &&
+                                         index <= converged_timestamp;
+                              });
+        }
+
         sub_matchings.push_back(matching);
         sub_matching_begin = sub_matching_end;
     }
 
+    util::Log(logDEBUG) << "Map matching transition cache: " << transition_cache.GetHits()
+                        << " of " << transition_cache.GetLookups() << " transitions cached ("
+                        << std::setprecision(3)
+                        << (transition_cache.GetLookups() > 0
+                                ? 100. * transition_cache.GetHits() / transition_cache.GetLookups()
+                                : 0.)
+                        << "%)";
+
     return sub_matchings;
 }
 
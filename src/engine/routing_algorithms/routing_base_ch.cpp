@@ -1,5 +1,12 @@
 #include "engine/routing_algorithms/routing_base_ch.hpp"
 
+#include <boost/range/iterator_range_core.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -190,6 +197,184 @@ double getNetworkDistance(SearchEngineData<Algorithm> &engine_working_data,
 
     return getPathDistance(facade, unpacked_path, source_phantom, target_phantom);
 }
+
+std::vector<double> getNetworkDistances(SearchEngineData<Algorithm> &,
+                                        const DataFacade<Algorithm> &facade,
+                                        SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                                        SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                                        const std::vector<PhantomNode> &source_phantoms,
+                                        const std::vector<PhantomNode> &target_phantoms,
+                                        EdgeWeight weight_upper_bound)
+{
+    // Settled node of a backward search, the parent is kept to retrieve the path
+    struct SearchSpaceEntry
+    {
+        NodeID node;
+        std::size_t column;
+        EdgeWeight weight;
+        NodeID parent;
+
+        bool operator<(const SearchSpaceEntry &rhs) const
+        {
+            return std::tie(node, column) < std::tie(rhs.node, rhs.column);
+        }
+    };
+
+    const auto number_of_targets = target_phantoms.size();
+    std::vector<double> distances(source_phantoms.size() * number_of_targets,
+                                  std::numeric_limits<double>::max());
+
+    // Forward searches start with the negated source offsets, so backward
+    // searches have to go on until the upper bound plus the largest offset.
+    EdgeWeight min_source_weight = 0;
+    for (const auto &source : source_phantoms)
+    {
+        if (source.IsValidForwardSource())
+            min_source_weight = std::min(min_source_weight, -source.GetForwardWeightPlusOffset());
+        if (source.IsValidReverseSource())
+            min_source_weight = std::min(min_source_weight, -source.GetReverseWeightPlusOffset());
+    }
+
+    std::vector<SearchSpaceEntry> search_space;
+    for (std::size_t column = 0; column < number_of_targets; ++column)
+    {
+        const auto &target = target_phantoms[column];
+
+        reverse_heap.Clear();
+        if (target.IsValidForwardTarget())
+            reverse_heap.Insert(target.forward_segment_id.id,
+                                target.GetForwardWeightPlusOffset(),
+                                target.forward_segment_id.id);
+        if (target.IsValidReverseTarget())
+            reverse_heap.Insert(target.reverse_segment_id.id,
+                                target.GetReverseWeightPlusOffset(),
+                                target.reverse_segment_id.id);
+
+        while (!reverse_heap.Empty() &&
+               reverse_heap.MinKey() + min_source_weight < weight_upper_bound)
+        {
+            const auto node = reverse_heap.DeleteMin();
+            const auto weight = reverse_heap.GetKey(node);
+            search_space.push_back({node, column, weight, reverse_heap.GetData(node).parent});
+
+            if (!stallAtNode<REVERSE_DIRECTION>(facade, node, weight, reverse_heap))
+            {
+                relaxOutgoingEdges<REVERSE_DIRECTION>(facade, node, weight, reverse_heap);
+            }
+        }
+    }
+    std::sort(search_space.begin(), search_space.end());
+
+    for (std::size_t row = 0; row < source_phantoms.size(); ++row)
+    {
+        const auto &source = source_phantoms[row];
+
+        forward_heap.Clear();
+        if (source.IsValidForwardSource())
+            forward_heap.Insert(source.forward_segment_id.id,
+                                -source.GetForwardWeightPlusOffset(),
+                                source.forward_segment_id.id);
+        if (source.IsValidReverseSource())
+            forward_heap.Insert(source.reverse_segment_id.id,
+                                -source.GetReverseWeightPlusOffset(),
+                                source.reverse_segment_id.id);
+
+        std::vector<EdgeWeight> weights(number_of_targets, weight_upper_bound);
+        std::vector<NodeID> middles(number_of_targets, SPECIAL_NODEID);
+        std::vector<bool> loops(number_of_targets, false);
+
+        // Backward weights are not negative, the search is done once
+        // the heap passes the weights of all targets
+        auto bound = weight_upper_bound;
+        while (!forward_heap.Empty() && forward_heap.MinKey() < bound)
+        {
+            const auto node = forward_heap.DeleteMin();
+            const auto weight = forward_heap.GetKey(node);
+
+            const auto entries = std::equal_range(search_space.begin(),
+                                                  search_space.end(),
+                                                  SearchSpaceEntry{node, 0, 0, node},
+                                                  [](const auto &lhs, const auto &rhs) {
+                                                      return lhs.node < rhs.node;
+                                                  });
+            for (const auto &entry : boost::make_iterator_range(entries))
+            {
+                auto new_weight = weight + entry.weight;
+                bool is_loop = false;
+                if (new_weight < 0)
+                {
+                    // source and target phantom are on the same edge based node,
+                    // the target is behind the source so we need a loop at the node
+                    const auto loop_weight = getLoopWeight<false>(facade, node);
+                    if (loop_weight == INVALID_EDGE_WEIGHT || new_weight + loop_weight < 0)
+                    {
+                        continue;
+                    }
+                    new_weight += loop_weight;
+                    is_loop = true;
+                }
+
+                if (new_weight < weights[entry.column])
+                {
+                    weights[entry.column] = new_weight;
+                    middles[entry.column] = node;
+                    loops[entry.column] = is_loop;
+                    bound = *std::max_element(weights.begin(), weights.end());
+                }
+            }
+
+            if (!stallAtNode<FORWARD_DIRECTION>(facade, node, weight, forward_heap))
+            {
+                relaxOutgoingEdges<FORWARD_DIRECTION>(facade, node, weight, forward_heap);
+            }
+        }
+
+        for (std::size_t column = 0; column < number_of_targets; ++column)
+        {
+            const auto middle = middles[column];
+            if (middle == SPECIAL_NODEID)
+            {
+                continue;
+            }
+
+            std::vector<NodeID> packed_path;
+            if (loops[column])
+            {
+                // self loop makes up the full path
+                packed_path = {middle, middle};
+            }
+            else
+            {
+                retrievePackedPathFromSingleHeap(forward_heap, middle, packed_path);
+                std::reverse(packed_path.begin(), packed_path.end());
+                packed_path.push_back(middle);
+
+                // follow the parents of the backward search to the target
+                auto entry = std::lower_bound(search_space.begin(),
+                                              search_space.end(),
+                                              SearchSpaceEntry{middle, column, 0, middle});
+                while (entry->parent != entry->node)
+                {
+                    packed_path.push_back(entry->parent);
+                    entry = std::lower_bound(search_space.begin(),
+                                             search_space.end(),
+                                             SearchSpaceEntry{entry->parent, column, 0, middle});
+                    BOOST_ASSERT(entry != search_space.end() && entry->column == column);
+                }
+            }
+
+            const auto &target = target_phantoms[column];
+            std::vector<PathData> unpacked_path;
+            unpackPath(
+                facade, packed_path.begin(), packed_path.end(), {source, target}, unpacked_path);
+
+            distances[row * number_of_targets + column] =
+                getPathDistance(facade, unpacked_path, source, target);
+        }
+    }
+
+    return distances;
+}
 } // namespace ch
 
 } // namespace routing_algorithms
@@ -1,5 +1,13 @@
 #include "engine/routing_algorithms/tile_turns.hpp"
 
+#include "util/integer_range.hpp"
+
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
 namespace osrm
 {
 namespace engine
@@ -9,6 +17,9 @@ namespace routing_algorithms
 
 namespace
 {
+// start nodes whose turns are generated by one task
+const constexpr std::size_t TURN_CHUNK_SIZE = 64;
+
 // Struct to hold info on all the EdgeBasedNodes that are visible in our tile
 // When we create these, we insure that (source, target) and packed_geometry_id
 // are all pointed in the same direction.
@@ -93,137 +104,163 @@ std::vector<TurnData> generateTurns(const datafacade &facade,
                    [](auto const &node) { return node.first; });
     std::sort(sorted_startnodes.begin(), sorted_startnodes.end());
 
-    std::vector<TurnData> all_turn_data;
-
-    // Given a turn:
-    //     u---v
-    //         |
-    //         w
-    //  uv is the "approach"
-    //  vw is the "exit"
-    std::vector<EdgeWeight> approach_weight_vector;
-    std::vector<EdgeWeight> approach_duration_vector;
-
-    // Look at every node in the directed graph we created
-    for (const auto &startnode : sorted_startnodes)
-    {
-        BOOST_ASSERT(directed_graph.find(startnode) != directed_graph.end());
-        const auto &nodedata = directed_graph.find(startnode)->second;
-        // For all the outgoing edges from the node
-        for (const auto &approachedge : nodedata)
+    // The start nodes are split into chunks of fixed size whose turns are generated
+    // concurrently. Concatenating the chunks in order keeps the PBF encoding identical
+    // to a sequential run.
+    const auto number_of_chunks =
+        (sorted_startnodes.size() + TURN_CHUNK_SIZE - 1) / TURN_CHUNK_SIZE;
+    std::vector<std::vector<TurnData>> chunk_turn_data(number_of_chunks);
+
+    tbb::parallel_for(std::size_t{0}, number_of_chunks, [&](const std::size_t chunk) {
+        auto &turn_data = chunk_turn_data[chunk];
+
+        // Given a turn:
+        //     u---v
+        //         |
+        //         w
+        //  uv is the "approach"
+        //  vw is the "exit"
+        std::vector<EdgeWeight> approach_weight_vector;
+        std::vector<EdgeWeight> approach_duration_vector;
+
+        // Look at every node of the chunk in the directed graph we created
+        const auto first = chunk * TURN_CHUNK_SIZE;
+        const auto last = std::min(first + TURN_CHUNK_SIZE, sorted_startnodes.size());
+        for (const auto index : util::irange(first, last))
         {
-            // If the target of this edge doesn't exist in our directed
-            // graph, it's probably outside the tile, so we can skip it
-            if (directed_graph.count(approachedge.target_node) == 0)
-                continue;
-
-            // For each of the outgoing edges from our target coordinate
-            for (const auto &exit_edge : directed_graph.find(approachedge.target_node)->second)
+            const auto startnode = sorted_startnodes[index];
+            BOOST_ASSERT(directed_graph.find(startnode) != directed_graph.end());
+            const auto &nodedata = directed_graph.find(startnode)->second;
+            // For all the outgoing edges from the node
+            for (const auto &approachedge : nodedata)
             {
-                // If the next edge has the same edge_based_node_id, then it's
-                // not a turn, so skip it
-                if (approachedge.edge_based_node_id == exit_edge.edge_based_node_id)
-                    continue;
-
-                // Skip u-turns
-                if (startnode == exit_edge.target_node)
+                // If the target of this edge doesn't exist in our directed
+                // graph, it's probably outside the tile, so we can skip it
+                if (directed_graph.count(approachedge.target_node) == 0)
                     continue;
 
-                // Find the connection between our source road and the target node
-                // Since we only want to find direct edges, we cannot check shortcut edges here.
-                // Otherwise we might find a forward edge even though a shorter backward edge
-                // exists (due to oneways).
-                //
-                // a > - > - > - b
-                // |             |
-                // |------ c ----|
-                //
-                // would offer a backward edge at `b` to `a` (due to the oneway from a to b)
-                // but could also offer a shortcut (b-c-a) from `b` to `a` which is longer.
-                EdgeID edge_based_edge_id =
-                    find_edge(approachedge.edge_based_node_id, exit_edge.edge_based_node_id);
-
-                if (edge_based_edge_id != SPECIAL_EDGEID)
+                // For each of the outgoing edges from our target coordinate
+                for (const auto &exit_edge : directed_graph.find(approachedge.target_node)->second)
                 {
-                    const auto &data = facade.GetEdgeData(edge_based_edge_id);
-
-                    // Now, calculate the sum of the weight of all the segments.
-                    if (edge_based_node_info.find(approachedge.edge_based_node_id)
-                            ->second.is_geometry_forward)
+                    // If the next edge has the same edge_based_node_id, then it's
+                    // not a turn, so skip it
+                    if (approachedge.edge_based_node_id == exit_edge.edge_based_node_id)
+                        continue;
+
+                    // Skip u-turns
+                    if (startnode == exit_edge.target_node)
+                        continue;
+
+                    // Find the connection between our source road and the target node
+                    // Since we only want to find direct edges, we cannot check shortcut edges
+                    // here. Otherwise we might find a forward edge even though a shorter
+                    // backward edge exists (due to oneways).
+                    //
+                    // a > - > - > - b
+                    // |             |
+                    // |------ c ----|
+                    //
+                    // would offer a backward edge at `b` to `a` (due to the oneway from a to b)
+                    // but could also offer a shortcut (b-c-a) from `b` to `a` which is longer.
+                    EdgeID edge_based_edge_id =
+                        find_edge(approachedge.edge_based_node_id, exit_edge.edge_based_node_id);
+
+                    if (edge_based_edge_id != SPECIAL_EDGEID)
                     {
-                        approach_weight_vector = facade.GetUncompressedForwardWeights(
-                            edge_based_node_info.find(approachedge.edge_based_node_id)
-                                ->second.packed_geometry_id);
-                        approach_duration_vector = facade.GetUncompressedForwardDurations(
-                            edge_based_node_info.find(approachedge.edge_based_node_id)
-                                ->second.packed_geometry_id);
-                    }
-                    else
-                    {
-                        approach_weight_vector = facade.GetUncompressedReverseWeights(
-                            edge_based_node_info.find(approachedge.edge_based_node_id)
-                                ->second.packed_geometry_id);
-                        approach_duration_vector = facade.GetUncompressedReverseDurations(
-                            edge_based_node_info.find(approachedge.edge_based_node_id)
-                                ->second.packed_geometry_id);
-                    }
-                    const auto sum_node_weight = std::accumulate(approach_weight_vector.begin(),
-                                                                 approach_weight_vector.end(),
-                                                                 EdgeWeight{0});
-                    const auto sum_node_duration = std::accumulate(approach_duration_vector.begin(),
-                                                                   approach_duration_vector.end(),
-                                                                   EdgeWeight{0});
-
-                    // The edge.weight is the whole edge weight, which includes the turn
-                    // cost.
-                    // The turn cost is the edge.weight minus the sum of the individual road
-                    // segment weights.  This might not be 100% accurate, because some
-                    // intersections include stop signs, traffic signals and other
-                    // penalties, but at this stage, we can't divide those out, so we just
-                    // treat the whole lot as the "turn cost" that we'll stick on the map.
-                    const auto turn_weight = data.weight - sum_node_weight;
-                    const auto turn_duration = data.duration - sum_node_duration;
-                    const auto turn_instruction = facade.GetTurnInstructionForEdgeID(data.turn_id);
-
-                    // Find the three nodes that make up the turn movement)
-                    const auto node_from = startnode;
-                    const auto node_via = approachedge.target_node;
-                    const auto node_to = exit_edge.target_node;
-
-                    const auto coord_from = facade.GetCoordinateOfNode(node_from);
-                    const auto coord_via = facade.GetCoordinateOfNode(node_via);
-                    const auto coord_to = facade.GetCoordinateOfNode(node_to);
-
-                    // Calculate the bearing that we approach the intersection at
-                    const auto angle_in = static_cast<int>(
-                        util::coordinate_calculation::bearing(coord_from, coord_via));
-
-                    const auto exit_bearing = static_cast<int>(
-                        util::coordinate_calculation::bearing(coord_via, coord_to));
-
-                    // Figure out the angle of the turn
-                    auto turn_angle = exit_bearing - angle_in;
-                    while (turn_angle > 180)
-                    {
-                        turn_angle -= 360;
-                    }
-                    while (turn_angle < -180)
-                    {
-                        turn_angle += 360;
-                    }
-
-                    // Save everything we need to later add all the points to the tile.
-                    // We need the coordinate of the intersection, the angle in, the turn
-                    // angle and the turn cost.
-                    all_turn_data.push_back(TurnData{coord_via,
+                        const auto &data = facade.GetEdgeData(edge_based_edge_id);
+
+                        // Now, calculate the sum of the weight of all the segments.
+                        if (edge_based_node_info.find(approachedge.edge_based_node_id)
+                                ->second.is_geometry_forward)
+                        {
+                            approach_weight_vector = facade.GetUncompressedForwardWeights(
+                                edge_based_node_info.find(approachedge.edge_based_node_id)
+                                    ->second.packed_geometry_id);
+                            approach_duration_vector = facade.GetUncompressedForwardDurations(
+                                edge_based_node_info.find(approachedge.edge_based_node_id)
+                                    ->second.packed_geometry_id);
+                        }
+                        else
+                        {
+                            approach_weight_vector = facade.GetUncompressedReverseWeights(
+                                edge_based_node_info.find(approachedge.edge_based_node_id)
+                                    ->second.packed_geometry_id);
+                            approach_duration_vector = facade.GetUncompressedReverseDurations(
+                                edge_based_node_info.find(approachedge.edge_based_node_id)
+                                    ->second.packed_geometry_id);
+                        }
+                        const auto sum_node_weight =
+                            std::accumulate(approach_weight_vector.begin(),
+                                            approach_weight_vector.end(),
+                                            EdgeWeight{0});
+                        const auto sum_node_duration =
+                            std::accumulate(approach_duration_vector.begin(),
+                                            approach_duration_vector.end(),
+                                            EdgeWeight{0});
+
+                        // The edge.weight is the whole edge weight, which includes the turn
+                        // cost.
+                        // The turn cost is the edge.weight minus the sum of the individual road
+                        // segment weights.  This might not be 100% accurate, because some
+                        // intersections include stop signs, traffic signals and other
+                        // penalties, but at this stage, we can't divide those out, so we just
+                        // treat the whole lot as the "turn cost" that we'll stick on the map.
+                        const auto turn_weight = data.weight - sum_node_weight;
+                        const auto turn_duration = data.duration - sum_node_duration;
+                        const auto turn_instruction =
+                            facade.GetTurnInstructionForEdgeID(data.turn_id);
+
+                        // Find the three nodes that make up the turn movement)
+                        const auto node_from = startnode;
+                        const auto node_via = approachedge.target_node;
+                        const auto node_to = exit_edge.target_node;
+
+                        const auto coord_from = facade.GetCoordinateOfNode(node_from);
+                        const auto coord_via = facade.GetCoordinateOfNode(node_via);
+                        const auto coord_to = facade.GetCoordinateOfNode(node_to);
+
+                        // Calculate the bearing that we approach the intersection at
+                        const auto angle_in = static_cast<int>(
+                            util::coordinate_calculation::bearing(coord_from, coord_via));
+
+                        const auto exit_bearing = static_cast<int>(
+                            util::coordinate_calculation::bearing(coord_via, coord_to));
+
+                        // Figure out the angle of the turn
+                        auto turn_angle = exit_bearing - angle_in;
+                        while (turn_angle > 180)
+                        {
+                            turn_angle -= 360;
+                        }
+                        while (turn_angle < -180)
+                        {
+                            turn_angle += 360;
+                        }
+
+                        // Save everything we need to later add all the points to the tile.
+                        // We need the coordinate of the intersection, the angle in, the turn
+                        // angle and the turn cost.
+                        turn_data.push_back(TurnData{coord_via,
                                                      angle_in,
                                                      turn_angle,
                                                      turn_weight,
                                                      turn_duration,
                                                      turn_instruction});
+                    }
                 }
             }
         }
+    });
+
+    std::vector<TurnData> all_turn_data;
+    all_turn_data.reserve(std::accumulate(
+        chunk_turn_data.begin(),
+        chunk_turn_data.end(),
+        std::size_t{0},
+        [](const std::size_t sum, const auto &turn_data) { return sum + turn_data.size(); }));
+    for (const auto &turn_data : chunk_turn_data)
+    {
+        std::copy(turn_data.begin(), turn_data.end(), std::back_inserter(all_turn_data));
     }
 
     return all_turn_data;
@@ -15,6 +15,8 @@
 
 #include "storage/io.hpp"
 
+#include "util/coordinate_calculation.hpp"
+#include "util/douglas_peucker.hpp"
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
 #include "util/graph_loader.hpp"
@@ -28,6 +30,7 @@
 #include "extractor/restriction_index.hpp"
 #include "extractor/way_restriction_map.hpp"
 #include "util/static_graph.hpp"
+#include "util/static_grid.hpp"
 #include "util/static_rtree.hpp"
 
 // Keep debug include to make sure the debug header is in sync with types.
@@ -73,6 +76,50 @@ namespace extractor
 
 namespace
 {
+// Points of a geometry that are kept by the simplification of some overview zoom level.
+// Simplifications of higher zoom levels keep more points, so the first zoom level that
+// keeps a point is the one it is needed at.
+std::vector<RoadOverview::Point>
+simplifyOverviewGeometry(const std::vector<util::Coordinate> &geometry)
+{
+    std::vector<std::uint8_t> min_zoom(geometry.size(), RoadOverview::MAX_ZOOM + 1);
+    for (auto zoom = RoadOverview::MAX_ZOOM; zoom >= RoadOverview::MIN_ZOOM; --zoom)
+    {
+        // the simplified geometry is a subsequence of the geometry
+        auto position = 0u;
+        for (const auto coordinate : util::douglasPeucker(geometry, zoom))
+        {
+            while (geometry[position] != coordinate)
+            {
+                ++position;
+                BOOST_ASSERT(position < geometry.size());
+            }
+            min_zoom[position] = zoom;
+        }
+    }
+    min_zoom.front() = RoadOverview::MIN_ZOOM;
+    min_zoom.back() = RoadOverview::MIN_ZOOM;
+
+    std::vector<RoadOverview::Point> points;
+    double distance = 0;
+    for (const auto position : util::irange<std::size_t>(0, geometry.size()))
+    {
+        if (position > 0)
+        {
+            distance += util::coordinate_calculation::haversineDistance(geometry[position - 1],
+                                                                        geometry[position]);
+        }
+        if (min_zoom[position] <= RoadOverview::MAX_ZOOM)
+        {
+            points.push_back(RoadOverview::Point{geometry[position],
+                                                 static_cast<float>(distance),
+                                                 static_cast<std::uint32_t>(position),
+                                                 min_zoom[position]});
+        }
+    }
+    return points;
+}
+
 // Converts the class name map into a fixed mapping of index to name
 void SetClassNames(const std::vector<std::string> &class_names,
                    ExtractorCallbacks::ClassesMap &classes_map,
@@ -279,6 +326,9 @@ int Extractor::run(ScriptingEnvironment &scripting_environment)
 
     TIMER_STOP(expansion);
 
+    BuildRoadOverview(
+        node_based_graph, node_based_graph_factory.GetCompressedEdges(), coordinates);
+
     // output the geometry of the node-based graph, needs to be done after the last usage, since it
     // destroys internal containers
     files::writeSegmentData(config.GetPath(".osrm.geometry"),
@@ -302,7 +352,10 @@ int Extractor::run(ScriptingEnvironment &scripting_environment)
 
     util::Log() << "Building r-tree ...";
     TIMER_START(rtree);
-    BuildRTree(std::move(edge_based_node_segments), std::move(node_is_startpoint), coordinates);
+    BuildRTree(std::move(edge_based_node_segments),
+               std::move(node_is_startpoint),
+               coordinates,
+               edge_based_nodes_container);
 
     TIMER_STOP(rtree);
 
@@ -745,7 +798,8 @@ EdgeID Extractor::BuildEdgeExpandedGraph(
  */
 void Extractor::BuildRTree(std::vector<EdgeBasedNodeSegment> edge_based_node_segments,
                            std::vector<bool> node_is_startpoint,
-                           const std::vector<util::Coordinate> &coordinates)
+                           const std::vector<util::Coordinate> &coordinates,
+                           const EdgeBasedNodeDataContainer &nodes_container)
 {
     util::Log() << "Constructing r-tree of " << edge_based_node_segments.size()
                 << " segments build on-top of " << coordinates.size() << " coordinates";
@@ -774,14 +828,135 @@ void Extractor::BuildRTree(std::vector<EdgeBasedNodeSegment> edge_based_node_seg
     }
     edge_based_node_segments.resize(new_size);
 
+    // forward and reverse segments are always part of the same component
+    const auto is_big_component = [&nodes_container](const EdgeBasedNodeSegment &segment) {
+        const auto node_id = segment.forward_segment_id.enabled ? segment.forward_segment_id.id
+                                                                : segment.reverse_segment_id.id;
+        return !nodes_container.GetComponentID(node_id).is_tiny;
+    };
+
     TIMER_START(construction);
     util::StaticRTree<EdgeBasedNodeSegment> rtree(edge_based_node_segments,
                                                   config.GetPath(".osrm.ramIndex").string(),
                                                   config.GetPath(".osrm.fileIndex").string(),
-                                                  coordinates);
+                                                  coordinates,
+                                                  is_big_component);
 
     TIMER_STOP(construction);
     util::Log() << "finished r-tree construction in " << TIMER_SEC(construction) << " seconds";
+
+    BuildSpatialGrid(edge_based_node_segments, coordinates);
+}
+
+/**
+    \brief Building the optional grid that answers most snapping queries in dense areas
+
+    Saves the grid into '.grid'. A grid left over from a previous run is removed if
+    no grid was requested, since it would not match the new r-tree.
+ */
+void Extractor::BuildSpatialGrid(const std::vector<EdgeBasedNodeSegment> &edge_based_node_segments,
+                                 const std::vector<util::Coordinate> &coordinates)
+{
+    const auto grid_path = config.GetPath(".osrm.grid");
+    boost::filesystem::remove(grid_path);
+
+    if (config.spatial_grid_cell_size == 0)
+    {
+        return;
+    }
+
+    // Projected coordinates are in degrees, so this is the cell size at the equator
+    const auto meters_per_degree = util::coordinate_calculation::detail::DEGREE_TO_RAD *
+                                   util::coordinate_calculation::detail::EARTH_RADIUS;
+    const auto cell_size = static_cast<std::int32_t>(std::max<double>(
+        1, std::round(config.spatial_grid_cell_size / meters_per_degree * COORDINATE_PRECISION)));
+
+    util::Log() << "Constructing spatial grid with cells of " << config.spatial_grid_cell_size
+                << "m";
+
+    TIMER_START(construction);
+    try
+    {
+        util::StaticGrid<EdgeBasedNodeSegment> grid(
+            edge_based_node_segments, coordinates, cell_size);
+        files::writeSpatialGrid(grid_path, grid);
+    }
+    catch (const util::exception &exception)
+    {
+        util::Log(logWARNING) << "Not writing spatial grid: " << exception.what();
+        return;
+    }
+    TIMER_STOP(construction);
+    util::Log() << "finished spatial grid construction in " << TIMER_SEC(construction)
+                << " seconds";
+}
+
+/**
+    \brief Building the generalised network of major roads for low zoom tiles
+
+    Saves the overview into '.overview'. An overview left over from a previous run is removed
+    if none was requested, since its geometry ids would not match the new data.
+ */
+void Extractor::BuildRoadOverview(const util::NodeBasedDynamicGraph &node_based_graph,
+                                  const CompressedEdgeContainer &compressed_edges,
+                                  const std::vector<util::Coordinate> &coordinates)
+{
+    const auto overview_path = config.GetPath(".osrm.overview");
+    boost::filesystem::remove(overview_path);
+
+    if (!config.generate_road_overview)
+    {
+        return;
+    }
+
+    util::Log() << "Constructing road overview";
+
+    TIMER_START(construction);
+
+    // the overview is only used with the dataset it was built for
+    storage::io::FileReader timestamp_file(config.GetPath(".osrm.timestamp"),
+                                           storage::io::FileReader::VerifyFingerprint);
+    std::string timestamp(timestamp_file.GetSize(), '\0');
+    timestamp_file.ReadInto(&timestamp[0], timestamp.size());
+
+    RoadOverview overview(std::move(timestamp));
+    std::vector<util::Coordinate> geometry;
+    for (const auto node_u : util::irange(0u, node_based_graph.GetNumberOfNodes()))
+    {
+        for (const auto edge : node_based_graph.GetAdjacentEdgeRange(node_u))
+        {
+            const auto &data = node_based_graph.GetEdgeData(edge);
+            // every packed geometry is added once, in the direction it is stored in
+            if (!data.geometry_id.forward || !isOverviewRoad(data.flags.road_classification))
+            {
+                continue;
+            }
+
+            const auto node_v = node_based_graph.GetTarget(edge);
+            const auto reverse_edge = node_based_graph.FindEdge(node_v, node_u);
+            BOOST_ASSERT(reverse_edge != SPECIAL_EDGEID);
+            const auto &reverse_data = node_based_graph.GetEdgeData(reverse_edge);
+
+            geometry.clear();
+            geometry.push_back(coordinates[node_u]);
+            for (const auto &segment : compressed_edges.GetBucketReference(edge))
+            {
+                geometry.push_back(coordinates[segment.node_id]);
+            }
+
+            overview.AddLine(data.geometry_id.id,
+                             !data.reversed,
+                             !reverse_data.reversed,
+                             simplifyOverviewGeometry(geometry));
+        }
+    }
+    overview.BuildIndex();
+
+    files::writeRoadOverview(overview_path, overview);
+
+    TIMER_STOP(construction);
+    util::Log() << "finished road overview construction of " << overview.GetNumberOfLines()
+                << " roads in " << TIMER_SEC(construction) << " seconds";
 }
 
 void Extractor::WriteCompressedNodeBasedGraph(const std::string &path,
@@ -77,7 +77,9 @@ NAN_MODULE_INIT(Engine::Init)
  * @param {Number} [options.max_locations_distance_table] Max. locations supported in distance table query (default: unlimited).
  * @param {Number} [options.max_locations_map_matching] Max. locations supported in map-matching query (default: unlimited).
  * @param {Number} [options.max_results_nearest] Max. results supported in nearest query (default: unlimited).
+ * @param {Number} [options.max_locations_nearest] Max. locations supported in batch nearest query (default: unlimited).
  * @param {Number} [options.max_alternatives] Max.number of alternatives supported in alternative routes query (default: 3).
+ * @param {Number} [options.max_trip_search_time] Max. milliseconds spent improving a trip with local search, 0 disables it (default: 100).
  *
  * @class OSRM
  *
@@ -196,7 +198,7 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
  * *Please note that even if alternative routes are requested, a result cannot be guaranteed.*
  * @param {Boolean} [options.steps=false] Return route steps for each route leg.
  * @param {Array|Boolean} [options.annotations=false] An array with strings of `duration`, `nodes`, `distance`, `weight`, `datasources`, `speed` or boolean for enabling/disabling all.
- * @param {String} [options.geometries=polyline] Returned route geometry format (influences overview and per step). Can also be `geojson`.
+ * @param {String} [options.geometries=polyline] Returned route geometry format (influences overview and per step). Can also be `geojson` or `none`, which can not be combined with `steps`.
  * @param {String} [options.overview=simplified] Add overview geometry either `full`, `simplified` according to highest zoom level it could be display on, or not at all (`false`).
  * @param {Boolean} [options.continue_straight] Forces the route to keep going straight at waypoints and don't do a uturn even if it would be faster. Default value depends on the profile.
  * @param {Array} [options.approaches] Keep waypoints on curb side. Can be `null` (unrestricted, default) or `curb`.
@@ -223,7 +225,8 @@ NAN_METHOD(Engine::route) //
 /**
  * Snaps a coordinate to the street network and returns the nearest n matches.
  *
- * Note: `coordinates` in the general options only supports a single `{longitude},{latitude}` entry.
+ * Note: `coordinates` in the general options only supports a single `{longitude},{latitude}` entry,
+ * unless `batch` is set.
  *
  * @name nearest
  * @memberof OSRM
@@ -236,6 +239,8 @@ NAN_METHOD(Engine::route) //
  * @param {Number} [options.number=1] Number of nearest segments that should be returned.
  * Must be an integer greater than or equal to `1`.
  * @param {Array} [options.approaches] Keep waypoints on curb side. Can be `null` (unrestricted, default) or `curb`.
+ * @param {Boolean} [options.batch=false] Snap all `coordinates` at once. Each entry in `waypoints` is then either `null`
+ *                                        or an array of `[longitude, latitude, distance, from_node, to_node]` arrays.
  * @param {Function} callback
  *
  * @returns {Object} containing `waypoints`.
@@ -355,12 +360,13 @@ NAN_METHOD(Engine::tile)
  * @param {Array} [options.hints] Hints for the coordinate snapping. Array of base64 encoded strings.
  * @param {Boolean} [options.steps=false] Return route steps for each route.
  * @param {Array|Boolean} [options.annotations=false] An array with strings of `duration`, `nodes`, `distance`, `weight`, `datasources`, `speed` or boolean for enabling/disabling all.
- * @param {String} [options.geometries=polyline] Returned route geometry format (influences overview and per step). Can also be `geojson`.
+ * @param {String} [options.geometries=polyline] Returned route geometry format (influences overview and per step). Can also be `geojson` or `none`, which can not be combined with `steps`.
  * @param {String} [options.overview=simplified] Add overview geometry either `full`, `simplified` according to highest zoom level it could be display on, or not at all (`false`).
  * @param {Array<Number>} [options.timestamps] Timestamp of the input location (integers, UNIX-like timestamp).
  * @param {Array} [options.radiuses] Standard deviation of GPS precision used for map matching. If applicable use GPS accuracy. Can be `null` for default value `5` meters or `double >= 0`.
  * @param {String} [options.gaps] Allows the input track splitting based on huge timestamp gaps between points. Either `split` or `ignore` (optional, default `split`).
  * @param {Boolean} [options.tidy] Allows the input track modification to obtain better matching quality for noisy tracks (optional, default `false`).
+ * @param {String} [options.vehicle] Id of a vehicle whose trace is matched live over several requests. The coordinates are appended to the points of the vehicle that are not finally matched yet and a single coordinate is enough. Only the points whose matching can not change anymore are returned. Not supported together with `tidy`, `hints`, `bearings` and `approaches`.
  *
  * @param {Function} callback
  *
@@ -424,12 +430,14 @@ NAN_METHOD(Engine::match) //
  * @param {Array} [options.hints] Hints for the coordinate snapping. Array of base64 encoded strings.
  * @param {Boolean} [options.steps=false] Return route steps for each route.
  * @param {Array|Boolean} [options.annotations=false] An array with strings of `duration`, `nodes`, `distance`, `weight`, `datasources`, `speed` or boolean for enabling/disabling all.
- * @param {String} [options.geometries=polyline] Returned route geometry format (influences overview and per step). Can also be `geojson`.
+ * @param {String} [options.geometries=polyline] Returned route geometry format (influences overview and per step). Can also be `geojson` or `none`, which can not be combined with `steps`.
  * @param {String} [options.overview=simplified] Add overview geometry either `full`, `simplified`
  * @param {Function} callback
  * @param {Boolean} [options.roundtrip=true] Return route is a roundtrip.
  * @param {String} [options.source=any] Return route starts at `any` or `first` coordinate.
  * @param {String} [options.destination=any] Return route ends at `any` or `last` coordinate.
+ * @param {Array} [options.precedences] Array of `[pickup, delivery]` coordinate index pairs, the pickup is visited before the delivery.
+ * @param {Number} [options.max_duration] Max. duration of the returned trip in seconds.
  * @param {Array} [options.approaches] Keep waypoints on curb side. Can be `null` (unrestricted, default) or `curb`.
  *
  * @returns {Object} containing `waypoints` and `trips`.
@@ -126,9 +126,17 @@ engine::Status OSRM::Match(const engine::api::MatchParameters &params, json::Obj
     return engine_->Match(params, result);
 }
 
+void OSRM::Match(const std::vector<engine::api::MatchParameters> &params,
+                 const std::function<void(std::size_t, Status, json::Object &)> &on_result) const
+{
+    engine_->Match(params, on_result);
+}
+
 engine::Status OSRM::Tile(const engine::api::TileParameters &params, std::string &result) const
 {
     return engine_->Tile(params, result);
 }
 
+unsigned OSRM::GetDatasetGeneration() const { return engine_->GetDatasetGeneration(); }
+
 } // ns osrm
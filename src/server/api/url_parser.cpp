@@ -59,18 +59,10 @@ struct URLParser final : qi::grammar<Iterator, Into>
     qi::rule<Iterator, char()> percent_encoding;
 };
 
-} // anon.
-
-namespace osrm
-{
-namespace server
-{
-namespace api
+template <typename It>
+boost::optional<osrm::server::api::ParsedURL> parseURLImpl(It &iter, const It end)
 {
-
-boost::optional<ParsedURL> parseURL(std::string::iterator &iter, const std::string::iterator end)
-{
-    using It = std::decay<decltype(iter)>::type;
+    using osrm::server::api::ParsedURL;
 
     static URLParser<It, ParsedURL(It)> const parser;
     ParsedURL out;
@@ -92,6 +84,26 @@ boost::optional<ParsedURL> parseURL(std::string::iterator &iter, const std::stri
     return boost::none;
 }
 
+} // anon.
+
+namespace osrm
+{
+namespace server
+{
+namespace api
+{
+
+boost::optional<ParsedURL> parseURL(std::string::iterator &iter, const std::string::iterator end)
+{
+    return parseURLImpl(iter, end);
+}
+
+boost::optional<ParsedURL> parseURL(std::string::const_iterator &iter,
+                                    const std::string::const_iterator end)
+{
+    return parseURLImpl(iter, end);
+}
+
 } // api
 } // server
 } // osrm
@@ -1,12 +1,22 @@
 #include "server/connection.hpp"
 #include "server/request_handler.hpp"
 #include "server/request_parser.hpp"
+#include "server/request_scheduler.hpp"
+
+#include "util/exception.hpp"
+#include "util/log.hpp"
+#include "util/string_util.hpp"
 
 #include <boost/assert.hpp>
 #include <boost/bind.hpp>
-#include <boost/iostreams/filter/gzip.hpp>
-#include <boost/iostreams/filtering_stream.hpp>
 
+#ifdef USE_LIBDEFLATE
+#include <libdeflate.h>
+#else
+#include <zlib.h>
+#endif
+
+#include <cstring>
 #include <iterator>
 #include <string>
 #include <vector>
@@ -16,9 +26,161 @@ namespace osrm
 namespace server
 {
 
-Connection::Connection(boost::asio::io_service &io_service, RequestHandler &handler)
-    : strand(io_service), TCP_socket(io_service), request_handler(handler)
+namespace
 {
+// Replies smaller than this fit into a single TCP packet anyway
+const constexpr std::size_t MIN_COMPRESSED_SIZE = 1024;
+
+// HTTP's deflate content coding is zlib data (RFC 1950), not a raw deflate stream (RFC 1951)
+
+#ifdef USE_LIBDEFLATE
+// Compresses whole buffers at once with libdeflate, which is about twice as fast as zlib
+class Compressor
+{
+  public:
+    Compressor() : compressor(libdeflate_alloc_compressor(1))
+    {
+        if (compressor == nullptr)
+        {
+            throw util::exception("Failed to allocate the reply compressor");
+        }
+    }
+
+    ~Compressor() { libdeflate_free_compressor(compressor); }
+
+    Compressor(const Compressor &) = delete;
+    Compressor &operator=(const Compressor &) = delete;
+
+    // returns false if the data could not be compressed
+    bool Compress(const std::vector<char> &uncompressed_data,
+                  const http::compression_type compression_type,
+                  std::vector<char> &compressed_data)
+    {
+        const auto gzip = compression_type == http::gzip_rfc1952;
+        compressed_data.resize(
+            gzip ? libdeflate_gzip_compress_bound(compressor, uncompressed_data.size())
+                 : libdeflate_zlib_compress_bound(compressor, uncompressed_data.size()));
+
+        const auto size = gzip ? libdeflate_gzip_compress(compressor,
+                                                          uncompressed_data.data(),
+                                                          uncompressed_data.size(),
+                                                          compressed_data.data(),
+                                                          compressed_data.size())
+                               : libdeflate_zlib_compress(compressor,
+                                                          uncompressed_data.data(),
+                                                          uncompressed_data.size(),
+                                                          compressed_data.data(),
+                                                          compressed_data.size());
+        // zero means the output did not fit, which the bound rules out
+        compressed_data.resize(size);
+        return size > 0;
+    }
+
+  private:
+    libdeflate_compressor *compressor;
+};
+#else
+// Keeps one zlib stream per format that is reset instead of allocated for every reply
+class Compressor
+{
+  public:
+    Compressor() : gzip_initialized(false), deflate_initialized(false)
+    {
+        std::memset(&gzip_stream, 0, sizeof(gzip_stream));
+        std::memset(&deflate_stream, 0, sizeof(deflate_stream));
+        // same gzip header as boost::iostreams writes: no name, no time and unknown OS
+        std::memset(&gzip_header, 0, sizeof(gzip_header));
+        gzip_header.os = 255;
+    }
+
+    ~Compressor()
+    {
+        if (gzip_initialized)
+            deflateEnd(&gzip_stream);
+        if (deflate_initialized)
+            deflateEnd(&deflate_stream);
+    }
+
+    Compressor(const Compressor &) = delete;
+    Compressor &operator=(const Compressor &) = delete;
+
+    // returns false if the data could not be compressed
+    bool Compress(const std::vector<char> &uncompressed_data,
+                  const http::compression_type compression_type,
+                  std::vector<char> &compressed_data)
+    {
+        auto &stream = GetStream(compression_type);
+
+        // deflateBound is an upper limit, the output is written in a single call
+        compressed_data.resize(deflateBound(&stream, uncompressed_data.size()));
+        stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(uncompressed_data.data()));
+        stream.avail_in = static_cast<uInt>(uncompressed_data.size());
+        stream.next_out = reinterpret_cast<Bytef *>(compressed_data.data());
+        stream.avail_out = static_cast<uInt>(compressed_data.size());
+
+        if (deflate(&stream, Z_FINISH) != Z_STREAM_END)
+        {
+            compressed_data.clear();
+            return false;
+        }
+        compressed_data.resize(stream.total_out);
+        return true;
+    }
+
+  private:
+    z_stream &GetStream(const http::compression_type compression_type)
+    {
+        const auto gzip = compression_type == http::gzip_rfc1952;
+        auto &stream = gzip ? gzip_stream : deflate_stream;
+        auto &initialized = gzip ? gzip_initialized : deflate_initialized;
+
+        if (initialized)
+        {
+            deflateReset(&stream);
+        }
+        else
+        {
+            // there's a trade-off between speed and size. speed wins
+            // window bits above 15 write a gzip wrapper, the others a zlib wrapper
+            if (deflateInit2(&stream,
+                             Z_BEST_SPEED,
+                             Z_DEFLATED,
+                             gzip ? MAX_WBITS + 16 : MAX_WBITS,
+                             8, // default memory level
+                             Z_DEFAULT_STRATEGY) != Z_OK)
+            {
+                throw util::exception("Failed to initialize the reply compressor");
+            }
+            initialized = true;
+        }
+
+        if (gzip)
+        {
+            deflateSetHeader(&stream, &gzip_header);
+        }
+        return stream;
+    }
+
+    z_stream gzip_stream;
+    z_stream deflate_stream;
+    gz_header gzip_header;
+    bool gzip_initialized;
+    bool deflate_initialized;
+};
+#endif
+}
+
+Connection::Connection(boost::asio::io_service &io_service,
+                       RequestHandler &handler,
+                       RequestScheduler &scheduler,
+                       const unsigned keepalive_requests,
+                       const int keepalive_timeout)
+    : strand(io_service), TCP_socket(io_service), timer(io_service), request_handler(handler),
+      request_scheduler(scheduler), unparsed_begin(nullptr), unparsed_end(nullptr),
+      keepalive_requests(keepalive_requests), keepalive_timeout(keepalive_timeout),
+      processed_requests(0), keep_alive(false)
+{
+    BOOST_ASSERT(keepalive_timeout > 0);
 }
 
 boost::asio::ip::tcp::socket &Connection::socket() { return TCP_socket; }
@@ -26,12 +188,8 @@ boost::asio::ip::tcp::socket &Connection::socket() { return TCP_socket; }
 /// Start the first asynchronous operation for the connection.
 void Connection::start()
 {
-    TCP_socket.async_read_some(
-        boost::asio::buffer(incoming_data_buffer),
-        strand.wrap(boost::bind(&Connection::handle_read,
-                                this->shared_from_this(),
-                                boost::asio::placeholders::error,
-                                boost::asio::placeholders::bytes_transferred)));
+    start_timer();
+    read_more();
 }
 
 void Connection::handle_read(const boost::system::error_code &error, std::size_t bytes_transferred)
@@ -41,109 +199,191 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
         return;
     }
 
+    handle_input(incoming_data_buffer.data(), incoming_data_buffer.data() + bytes_transferred);
+}
+
+void Connection::handle_input(char *begin, char *end)
+{
     // no error detected, let's parse the request
     http::compression_type compression_type(http::no_compression);
     RequestParser::RequestStatus result;
-    std::tie(result, compression_type) =
-        request_parser.parse(current_request,
-                             incoming_data_buffer.data(),
-                             incoming_data_buffer.data() + bytes_transferred);
+    std::tie(result, compression_type) = request_parser.parse(current_request, begin, end);
 
     // the request has been parsed
     if (result == RequestParser::RequestStatus::valid)
     {
+        // stops the timer, a timeout that is already queued does not close the connection anymore
+        timer.expires_at(boost::posix_time::pos_infin);
+        unparsed_begin = begin;
+        unparsed_end = end;
+        ++processed_requests;
+        keep_alive = current_request.keep_alive && processed_requests < keepalive_requests;
+
         current_request.endpoint = TCP_socket.remote_endpoint().address();
-        request_handler.HandleRequest(current_request, current_reply);
+        util::URIDecode(current_request.uri, request_string);
 
-        // compress the result w/ gzip/deflate if requested
-        switch (compression_type)
+        const auto dataset = request_handler.GetDataset();
+        if (request_handler.GetCachedReply(
+                current_request, request_string, compression_type, dataset, current_reply))
         {
-        case http::deflate_rfc1951:
-            // use deflate for compression
-            current_reply.headers.insert(current_reply.headers.begin(),
-                                         {"Content-Encoding", "deflate"});
-            compressed_output = compress_buffers(current_reply.content, compression_type);
-            current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = current_reply.headers_to_buffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
-            break;
-        case http::gzip_rfc1952:
-            // use gzip for compression
-            current_reply.headers.insert(current_reply.headers.begin(),
-                                         {"Content-Encoding", "gzip"});
-            compressed_output = compress_buffers(current_reply.content, compression_type);
-            current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = current_reply.headers_to_buffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
-            break;
-        case http::no_compression:
-            // don't use any compression
-            current_reply.set_uncompressed_size();
-            output_buffer = current_reply.to_buffers();
-            break;
+            write_reply();
+            return;
+        }
+
+        // queued requests run on whichever thread frees a slot, the connection waits for them
+        auto self = this->shared_from_this();
+        if (!request_scheduler.Submit(RequestScheduler::Classify(current_request.uri),
+                                      [self, compression_type, dataset] {
+                                          self->handle_request(compression_type, dataset);
+                                      }))
+        {
+            current_reply = http::reply::stock_reply(http::reply::service_unavailable);
+            write_reply();
         }
-        // write result to stream
-        boost::asio::async_write(TCP_socket,
-                                 output_buffer,
-                                 strand.wrap(boost::bind(&Connection::handle_write,
-                                                         this->shared_from_this(),
-                                                         boost::asio::placeholders::error)));
     }
     else if (result == RequestParser::RequestStatus::invalid)
     { // request is not parseable
+        timer.expires_at(boost::posix_time::pos_infin);
+        keep_alive = false;
         current_reply = http::reply::stock_reply(http::reply::bad_request);
-
-        boost::asio::async_write(TCP_socket,
-                                 current_reply.to_buffers(),
-                                 strand.wrap(boost::bind(&Connection::handle_write,
-                                                         this->shared_from_this(),
-                                                         boost::asio::placeholders::error)));
+        write_reply();
     }
     else
     {
         // we don't have a result yet, so continue reading
-        TCP_socket.async_read_some(
-            boost::asio::buffer(incoming_data_buffer),
-            strand.wrap(boost::bind(&Connection::handle_read,
-                                    this->shared_from_this(),
-                                    boost::asio::placeholders::error,
-                                    boost::asio::placeholders::bytes_transferred)));
+        read_more();
     }
 }
 
+void Connection::handle_request(const http::compression_type compression_type,
+                                const unsigned dataset)
+{
+    request_handler.HandleRequest(current_request, request_string, current_reply);
+
+    // compress the result w/ gzip/deflate if requested and worth it
+    const auto reply_compression = current_reply.content.size() < MIN_COMPRESSED_SIZE
+                                       ? http::no_compression
+                                       : compression_type;
+    std::vector<char> compressed_data;
+    if (reply_compression != http::no_compression &&
+        !compress_buffers(current_reply.content, reply_compression, compressed_data))
+    {
+        util::Log(logWARNING) << "[server error] failed to compress the reply, uri: "
+                              << current_request.uri;
+        current_reply = http::reply::stock_reply(http::reply::internal_server_error);
+        write_reply();
+        return;
+    }
+    switch (reply_compression)
+    {
+    case http::deflate_rfc1951:
+        // use deflate for compression
+        current_reply.headers.insert(current_reply.headers.begin(),
+                                     {"Content-Encoding", "deflate"});
+        current_reply.content = std::move(compressed_data);
+        break;
+    case http::gzip_rfc1952:
+        // use gzip for compression
+        current_reply.headers.insert(current_reply.headers.begin(), {"Content-Encoding", "gzip"});
+        current_reply.content = std::move(compressed_data);
+        break;
+    case http::no_compression:
+        // don't use any compression
+        break;
+    }
+    current_reply.set_uncompressed_size();
+
+    request_handler.CacheReply(request_string, compression_type, dataset, current_reply);
+    write_reply();
+}
+
+void Connection::write_reply()
+{
+    current_reply.headers.emplace_back("Connection", keep_alive ? "keep-alive" : "close");
+    output_buffer = current_reply.to_buffers();
+
+    // write result to stream
+    boost::asio::async_write(TCP_socket,
+                             output_buffer,
+                             strand.wrap(boost::bind(&Connection::handle_write,
+                                                     this->shared_from_this(),
+                                                     boost::asio::placeholders::error)));
+}
+
 /// Handle completion of a write operation.
 void Connection::handle_write(const boost::system::error_code &error)
 {
-    if (!error)
+    if (error)
+    {
+        return;
+    }
+
+    if (!keep_alive)
     {
         // Initiate graceful connection closure.
         boost::system::error_code ignore_error;
         TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
+        return;
+    }
+
+    current_request = http::request();
+    current_reply = http::reply();
+    request_parser = RequestParser();
+
+    start_timer();
+    if (unparsed_begin != unparsed_end)
+    {
+        // the client did not wait for the reply before sending the next request
+        handle_input(unparsed_begin, unparsed_end);
+    }
+    else
+    {
+        read_more();
     }
 }
 
-std::vector<char> Connection::compress_buffers(const std::vector<char> &uncompressed_data,
-                                               const http::compression_type compression_type)
+void Connection::handle_timeout(const boost::system::error_code &error)
 {
-    boost::iostreams::gzip_params compression_parameters;
-
-    // there's a trade-off between speed and size. speed wins
-    compression_parameters.level = boost::iostreams::zlib::best_speed;
-    // check which compression flavor is used
-    if (http::deflate_rfc1951 == compression_type)
+    // the timer might have been restarted after this handler was queued
+    if (error != boost::asio::error::operation_aborted &&
+        timer.expires_at() <= boost::asio::deadline_timer::traits_type::now())
     {
-        compression_parameters.noheader = true;
+        close();
     }
+}
 
-    std::vector<char> compressed_data;
-    // plug data into boost's compression stream
-    boost::iostreams::filtering_ostream gzip_stream;
-    gzip_stream.push(boost::iostreams::gzip_compressor(compression_parameters));
-    gzip_stream.push(boost::iostreams::back_inserter(compressed_data));
-    gzip_stream.write(&uncompressed_data[0], uncompressed_data.size());
-    boost::iostreams::close(gzip_stream);
-
-    return compressed_data;
+void Connection::read_more()
+{
+    TCP_socket.async_read_some(
+        boost::asio::buffer(incoming_data_buffer),
+        strand.wrap(boost::bind(&Connection::handle_read,
+                                this->shared_from_this(),
+                                boost::asio::placeholders::error,
+                                boost::asio::placeholders::bytes_transferred)));
+}
+
+void Connection::start_timer()
+{
+    timer.expires_from_now(keepalive_timeout);
+    timer.async_wait(strand.wrap(boost::bind(
+        &Connection::handle_timeout, this->shared_from_this(), boost::asio::placeholders::error)));
+}
+
+void Connection::close()
+{
+    // closing the socket aborts the pending read
+    boost::system::error_code ignore_error;
+    TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
+    TCP_socket.close(ignore_error);
+}
+
+bool Connection::compress_buffers(const std::vector<char> &uncompressed_data,
+                                  const http::compression_type compression_type,
+                                  std::vector<char> &compressed_data)
+{
+    // every thread of the io_service compresses with its own state
+    thread_local Compressor compressor;
+    return compressor.Compress(uncompressed_data, compression_type, compressed_data);
 }
 }
 }
@@ -19,9 +19,11 @@
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
 
+#include <chrono>
 #include <ctime>
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <iterator>
 #include <string>
@@ -32,13 +34,109 @@ namespace osrm
 namespace server
 {
 
+namespace
+{
+// Replies of these services only depend on the URL. Match is not cached as clients usually
+// send every trace once and tiles are cached by the engine already.
+bool isCacheableRequest(const std::string &request_string)
+{
+    for (const auto service : {"/route/", "/table/", "/nearest/", "/trip/"})
+    {
+        if (request_string.compare(0, std::strlen(service), service) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+}
+
 void RequestHandler::RegisterServiceHandler(
     std::unique_ptr<ServiceHandlerInterface> service_handler_)
 {
     service_handler = std::move(service_handler_);
 }
 
-void RequestHandler::HandleRequest(const http::request &current_request, http::reply &current_reply)
+void RequestHandler::RegisterResponseCache(std::unique_ptr<ResponseCache> response_cache_)
+{
+    response_cache = std::move(response_cache_);
+}
+
+unsigned RequestHandler::GetDataset() const
+{
+    return response_cache && service_handler ? service_handler->GetDatasetGeneration() : 0;
+}
+
+bool RequestHandler::GetCachedReply(const http::request &current_request,
+                                    const std::string &request_string,
+                                    const http::compression_type compression_type,
+                                    const unsigned dataset,
+                                    http::reply &current_reply)
+{
+    if (!response_cache || !isCacheableRequest(request_string))
+    {
+        return false;
+    }
+
+    TIMER_START(request_duration);
+    const auto response = response_cache->Get(
+        ResponseKey{request_string, compression_type}, dataset, ResponseCache::Clock::now());
+    if (!response)
+    {
+        return false;
+    }
+
+    current_reply.status = response->status;
+    current_reply.headers.clear();
+    for (const auto &cached_header : response->headers)
+    {
+        current_reply.headers.emplace_back(cached_header.first, cached_header.second);
+    }
+    current_reply.headers.emplace_back("X-Cache", "HIT");
+    current_reply.content = response->content;
+
+    TIMER_STOP(request_duration);
+    LogAccess(current_request, request_string, current_reply, TIMER_MSEC(request_duration));
+    return true;
+}
+
+void RequestHandler::CacheReply(const std::string &request_string,
+                                const http::compression_type compression_type,
+                                const unsigned dataset,
+                                const http::reply &current_reply)
+{
+    if (!response_cache || current_reply.status != http::reply::ok ||
+        !isCacheableRequest(request_string))
+    {
+        return;
+    }
+
+    // The dataset is read before the request runs. If the engine switched to new data in the
+    // meantime the reply may have been computed from either of them.
+    if (GetDataset() != dataset)
+    {
+        return;
+    }
+
+    CachedResponse response{current_reply.status, {}, current_reply.content};
+    response.headers.reserve(current_reply.headers.size());
+    for (const auto &current_header : current_reply.headers)
+    {
+        // cached replies are sent with X-Cache: HIT instead
+        if (current_header.name != "X-Cache")
+        {
+            response.headers.emplace_back(current_header.name, current_header.value);
+        }
+    }
+    response_cache->Put(ResponseKey{request_string, compression_type},
+                        dataset,
+                        ResponseCache::Clock::now(),
+                        std::move(response));
+}
+
+void RequestHandler::HandleRequest(const http::request &current_request,
+                                   const std::string &request_string,
+                                   http::reply &current_reply)
 {
     if (!service_handler)
     {
@@ -53,8 +151,6 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
     try
     {
         TIMER_START(request_duration);
-        std::string request_string;
-        util::URIDecode(current_request.uri, request_string);
 
         util::Log(logDEBUG) << "[req][" << tid << "] " << request_string;
 
@@ -124,40 +220,15 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
         // set headers
         current_reply.headers.emplace_back("Content-Length",
                                            std::to_string(current_reply.content.size()));
-
-        if (!std::getenv("DISABLE_ACCESS_LOGGING"))
+        // the reply is stored in the response cache after compression, see CacheReply
+        if (response_cache && current_reply.status == http::reply::ok &&
+            isCacheableRequest(request_string))
         {
-            // deactivated as GCC apparently does not implement that, not even in 4.9
-            // std::time_t t = std::time(nullptr);
-            // util::Log() << std::put_time(std::localtime(&t), "%m-%d-%Y
-            // %H:%M:%S") <<
-            //     " " << current_request.endpoint.to_string() << " " <<
-            //     current_request.referrer << ( 0 == current_request.referrer.length() ? "- " :" ")
-            //     <<
-            //     current_request.agent << ( 0 == current_request.agent.length() ? "- " :" ") <<
-            //     request;
-
-            time_t ltime;
-            struct tm *time_stamp;
-            TIMER_STOP(request_duration);
-
-            ltime = time(nullptr);
-            time_stamp = localtime(&ltime);
-            // log timestamp
-            util::Log() << (time_stamp->tm_mday < 10 ? "0" : "") << time_stamp->tm_mday << "-"
-                        << (time_stamp->tm_mon + 1 < 10 ? "0" : "") << (time_stamp->tm_mon + 1)
-                        << "-" << 1900 + time_stamp->tm_year << " "
-                        << (time_stamp->tm_hour < 10 ? "0" : "") << time_stamp->tm_hour << ":"
-                        << (time_stamp->tm_min < 10 ? "0" : "") << time_stamp->tm_min << ":"
-                        << (time_stamp->tm_sec < 10 ? "0" : "") << time_stamp->tm_sec << " "
-                        << TIMER_MSEC(request_duration) << "ms "
-                        << current_request.endpoint.to_string() << " " << current_request.referrer
-                        << (0 == current_request.referrer.length() ? "- " : " ")
-                        << current_request.agent
-                        << (0 == current_request.agent.length() ? "- " : " ")
-                        << current_reply.status << " " //
-                        << request_string;
+            current_reply.headers.emplace_back("X-Cache", "MISS");
         }
+
+        TIMER_STOP(request_duration);
+        LogAccess(current_request, request_string, current_reply, TIMER_MSEC(request_duration));
     }
     catch (const std::exception &e)
     {
@@ -166,5 +237,56 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
                               << ", uri: " << current_request.uri;
     }
 }
+
+// Replies served from the cache are logged with HIT, cacheable replies that had to be computed
+// with MISS and all others with "-". The column is left out if there is no response cache.
+void RequestHandler::LogAccess(const http::request &current_request,
+                               const std::string &request_string,
+                               const http::reply &current_reply,
+                               const double milliseconds) const
+{
+    if (std::getenv("DISABLE_ACCESS_LOGGING"))
+    {
+        return;
+    }
+
+    std::string cache_status;
+    if (response_cache)
+    {
+        const auto cache_header = std::find_if(
+            current_reply.headers.begin(),
+            current_reply.headers.end(),
+            [](const http::header &current_header) { return current_header.name == "X-Cache"; });
+        cache_status =
+            cache_header == current_reply.headers.end() ? "- " : cache_header->value + " ";
+    }
+
+    // deactivated as GCC apparently does not implement that, not even in 4.9
+    // std::time_t t = std::time(nullptr);
+    // util::Log() << std::put_time(std::localtime(&t), "%m-%d-%Y
+    // %H:%M:%S") <<
+    //     " " << current_request.endpoint.to_string() << " " <<
+    //     current_request.referrer << ( 0 == current_request.referrer.length() ? "- " :" ")
+    //     <<
+    //     current_request.agent << ( 0 == current_request.agent.length() ? "- " :" ") <<
+    //     request;
+
+    time_t ltime;
+    struct tm *time_stamp;
+
+    ltime = time(nullptr);
+    time_stamp = localtime(&ltime);
+    // log timestamp
+    util::Log() << (time_stamp->tm_mday < 10 ? "0" : "") << time_stamp->tm_mday << "-"
+                << (time_stamp->tm_mon + 1 < 10 ? "0" : "") << (time_stamp->tm_mon + 1) << "-"
+                << 1900 + time_stamp->tm_year << " " << (time_stamp->tm_hour < 10 ? "0" : "")
+                << time_stamp->tm_hour << ":" << (time_stamp->tm_min < 10 ? "0" : "")
+                << time_stamp->tm_min << ":" << (time_stamp->tm_sec < 10 ? "0" : "")
+                << time_stamp->tm_sec << " " << milliseconds << "ms "
+                << current_request.endpoint.to_string() << " " << current_request.referrer
+                << (0 == current_request.referrer.length() ? "- " : " ") << current_request.agent
+                << (0 == current_request.agent.length() ? "- " : " ") << current_reply.status
+                << " " << cache_status << request_string;
+}
 }
 }
@@ -15,12 +15,13 @@ namespace server
 
 RequestParser::RequestParser()
     : state(internal_state::method_start), current_header({"", ""}),
-      selected_compression(http::no_compression), is_post_header(false), content_length(0)
+      selected_compression(http::no_compression), is_post_header(false), content_length(0),
+      http_version_major(0), http_version_minor(0)
 {
 }
 
 std::tuple<RequestParser::RequestStatus, http::compression_type>
-RequestParser::parse(http::request &current_request, char *begin, char *end)
+RequestParser::parse(http::request &current_request, char *&begin, char *end)
 {
     while (begin != end)
     {
@@ -30,14 +31,7 @@ RequestParser::parse(http::request &current_request, char *begin, char *end)
             return std::make_tuple(result, selected_compression);
         }
     }
-    RequestStatus result = RequestStatus::indeterminate;
-
-    if (state == internal_state::post_request && content_length <= 0)
-    {
-        result = RequestStatus::valid;
-    }
-
-    return std::make_tuple(result, selected_compression);
+    return std::make_tuple(RequestStatus::indeterminate, selected_compression);
 }
 
 RequestParser::RequestStatus RequestParser::consume(http::request &current_request,
@@ -82,7 +76,8 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
     case internal_state::post_request:
         current_request.uri.push_back(input);
         --content_length;
-        return RequestStatus::indeterminate;    
+        // the body ends after content length bytes, anything after it is the next request
+        return content_length > 0 ? RequestStatus::indeterminate : RequestStatus::valid;
     case internal_state::method:
         if (input == ' ')
         {
@@ -152,6 +147,7 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
     case internal_state::http_version_major_start:
         if (is_digit(input))
         {
+            http_version_major = input - '0';
             state = internal_state::http_version_major;
             return RequestStatus::indeterminate;
         }
@@ -164,12 +160,14 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
         }
         if (is_digit(input))
         {
+            http_version_major = http_version_major * 10 + (input - '0');
             return RequestStatus::indeterminate;
         }
         return RequestStatus::invalid;
     case internal_state::http_version_minor_start:
         if (is_digit(input))
         {
+            http_version_minor = input - '0';
             state = internal_state::http_version_minor;
             return RequestStatus::indeterminate;
         }
@@ -177,11 +175,15 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
     case internal_state::http_version_minor:
         if (input == '\r')
         {
+            // HTTP/1.1 connections are persistent unless the client closes them
+            current_request.keep_alive =
+                http_version_major > 1 || (http_version_major == 1 && http_version_minor >= 1);
             state = internal_state::expecting_newline_1;
             return RequestStatus::indeterminate;
         }
         if (is_digit(input))
         {
+            http_version_minor = http_version_minor * 10 + (input - '0');
             return RequestStatus::indeterminate;
         }
         return RequestStatus::invalid;
@@ -216,6 +218,18 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
             current_request.agent = current_header.value;
         }
 
+        if (boost::iequals(current_header.name, "Connection"))
+        {
+            if (boost::icontains(current_header.value, "close"))
+            {
+                current_request.keep_alive = false;
+            }
+            else if (boost::icontains(current_header.value, "keep-alive"))
+            {
+                current_request.keep_alive = true;
+            }
+        }
+
 	if (boost::iequals(current_header.name, "Content-Length"))
         {
             try
@@ -305,7 +319,7 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
     case internal_state::expecting_newline_3:
         if (input == '\n')
         {
-            if (is_post_header)
+            if (is_post_header && content_length > 0)
             {
                 state = internal_state::post_request;
                 return RequestStatus::indeterminate;
@@ -0,0 +1,102 @@
+#include "server/request_scheduler.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace osrm
+{
+namespace server
+{
+
+RequestScheduler::RequestScheduler(boost::asio::io_service &io_service,
+                                   const Limits interactive_limits,
+                                   const Limits batch_limits)
+    : io_service(io_service)
+{
+    queues[static_cast<std::size_t>(ServiceClass::Interactive)] =
+        Queue{interactive_limits, 0, 0, {}};
+    queues[static_cast<std::size_t>(ServiceClass::Batch)] = Queue{batch_limits, 0, 0, {}};
+    // a class without slots would never run anything
+    for (auto &queue : queues)
+    {
+        queue.limits.concurrency = std::max(1u, queue.limits.concurrency);
+    }
+}
+
+RequestScheduler::ServiceClass RequestScheduler::Classify(const std::string &uri)
+{
+    // requests with many coordinates or long search times
+    for (const auto service : {"/table/", "/matrix/", "/journey/", "/match/", "/trip/"})
+    {
+        if (uri.compare(0, std::strlen(service), service) == 0)
+        {
+            return ServiceClass::Batch;
+        }
+    }
+    return ServiceClass::Interactive;
+}
+
+bool RequestScheduler::Submit(const ServiceClass service_class, Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto &queue = queues[static_cast<std::size_t>(service_class)];
+        if (queue.running >= queue.limits.concurrency)
+        {
+            if (queue.waiting.size() >= queue.limits.queue_size)
+            {
+                ++queue.rejected;
+                return false;
+            }
+            queue.waiting.push_back(std::move(task));
+            return true;
+        }
+        ++queue.running;
+    }
+
+    Run(service_class, task);
+    return true;
+}
+
+RequestScheduler::Statistics RequestScheduler::GetStatistics(const ServiceClass service_class) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto &queue = queues[static_cast<std::size_t>(service_class)];
+    return Statistics{queue.running, queue.waiting.size(), queue.rejected};
+}
+
+void RequestScheduler::Run(const ServiceClass service_class, const Task &task)
+{
+    try
+    {
+        task();
+    }
+    catch (...)
+    {
+        Release(service_class);
+        throw;
+    }
+    Release(service_class);
+}
+
+void RequestScheduler::Release(const ServiceClass service_class)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &queue = queues[static_cast<std::size_t>(service_class)];
+    BOOST_ASSERT(queue.running > 0);
+    if (queue.waiting.empty())
+    {
+        --queue.running;
+        return;
+    }
+
+    // the slot is handed over to the oldest waiting request
+    auto next = std::move(queue.waiting.front());
+    queue.waiting.pop_front();
+    io_service.post([this, service_class, next] { Run(service_class, next); });
+}
+}
+}
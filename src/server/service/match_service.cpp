@@ -32,11 +32,28 @@ std::string getWrongOptionHelp(const engine::api::MatchParameters &parameters)
         constrainParamSize(
             PARAMETER_SIZE_MISMATCH_MSG, "timestamps", parameters.timestamps, coord_size, help);
 
-    if (!param_size_mismatch && parameters.coordinates.size() < 2)
+    if (!param_size_mismatch && !parameters.vehicle.empty())
+    {
+        if (parameters.coordinates.empty())
+        {
+            help = "Number of coordinates needs to be at least one.";
+        }
+        else if (parameters.tidy)
+        {
+            help = "Tidying is not supported for live traces.";
+        }
+    }
+    else if (!param_size_mismatch && parameters.coordinates.size() < 2)
     {
         help = "Number of coordinates needs to be at least two.";
     }
 
+    if (help.empty() && parameters.steps &&
+        parameters.geometries == engine::api::RouteParameters::GeometriesType::None)
+    {
+        help = "Steps can not be returned without geometries.";
+    }
+
     return help;
 }
 } // anon. ns
@@ -35,6 +35,12 @@ std::string getWrongOptionHelp(const engine::api::RouteParameters &parameters)
         help = "Number of coordinates needs to be at least two.";
     }
 
+    if (help.empty() && parameters.steps &&
+        parameters.geometries == engine::api::RouteParameters::GeometriesType::None)
+    {
+        help = "Steps can not be returned without geometries.";
+    }
+
     return help;
 }
 } // anon. ns
@@ -37,14 +37,24 @@ engine::Status TileService::RunQuery(std::size_t prefix_length, std::string &que
         result = util::json::Object();
         auto &json_result = result.get<util::json::Object>();
         json_result.values["code"] = "InvalidOptions";
-        json_result.values["message"] = "Invalid coodinates. Only zoomlevel 12+ is supported";
+        json_result.values["message"] = "Invalid coodinates. Only zoomlevel 8+ is supported";
         return engine::Status::Error;
     }
     BOOST_ASSERT(parameters->IsValid());
 
     result = std::string();
     auto &string_result = result.get<std::string>();
-    return BaseService::routing_machine.Tile(*parameters, string_result);
+    const auto status = BaseService::routing_machine.Tile(*parameters, string_result);
+    if (status == engine::Status::Error)
+    {
+        // failed tiles hand back the reason instead of the tile
+        auto message = std::move(string_result);
+        result = util::json::Object();
+        auto &json_result = result.get<util::json::Object>();
+        json_result.values["code"] = "InvalidOptions";
+        json_result.values["message"] = std::move(message);
+    }
+    return status;
 }
 }
 }
@@ -8,6 +8,8 @@
 
 #include <boost/format.hpp>
 
+#include <algorithm>
+
 namespace osrm
 {
 namespace server
@@ -37,6 +39,28 @@ std::string getWrongOptionHelp(const engine::api::TripParameters &parameters)
         help = "Number of coordinates needs to be at least two.";
     }
 
+    if (help.empty() && parameters.steps &&
+        parameters.geometries == engine::api::RouteParameters::GeometriesType::None)
+    {
+        help = "Steps can not be returned without geometries.";
+    }
+
+    if (help.empty() &&
+        std::any_of(parameters.precedences.begin(),
+                    parameters.precedences.end(),
+                    [coord_size](const auto &precedence) {
+                        return precedence.first >= coord_size || precedence.second >= coord_size ||
+                               precedence.first == precedence.second;
+                    }))
+    {
+        help = "Precedences need to refer to two different coordinates.";
+    }
+
+    if (help.empty() && parameters.max_duration && !(*parameters.max_duration >= 0))
+    {
+        help = "Max. duration needs to be a non-negative number of seconds.";
+    }
+
     return help;
 }
 } // anon. ns
@@ -55,5 +55,10 @@ engine::Status ServiceHandler::RunQuery(api::ParsedURL parsed_url,
 
     return service->RunQuery(parsed_url.prefix_length, parsed_url.query, result);
 }
+
+unsigned ServiceHandler::GetDatasetGeneration() const
+{
+    return routing_machine.GetDatasetGeneration();
+}
 }
 }
@@ -39,6 +39,7 @@
 #include "util/packed_vector.hpp"
 #include "util/range_table.hpp"
 #include "util/static_graph.hpp"
+#include "util/static_grid.hpp"
 #include "util/static_rtree.hpp"
 #include "util/typedefs.hpp"
 #include "util/vector_view.hpp"
@@ -69,13 +70,18 @@ namespace storage
 static constexpr std::size_t NUM_METRICS = 8;
 
 using RTreeLeaf = engine::datafacade::BaseDataFacade::RTreeLeaf;
-using RTreeNode = util::StaticRTree<RTreeLeaf, storage::Ownership::View>::TreeNode;
+using RTree = util::StaticRTree<RTreeLeaf, storage::Ownership::View>;
+using RTreeNode = RTree::TreeNode;
+using SpatialGrid = util::StaticGridView<RTreeLeaf>;
 using QueryGraph = util::StaticGraph<contractor::QueryEdge::EdgeData>;
 using EdgeBasedGraph = util::StaticGraph<extractor::EdgeBasedEdge::EdgeData>;
 
 using Monitor = SharedMonitor<SharedDataTimestamp>;
 
-Storage::Storage(StorageConfig config_) : config(std::move(config_)) {}
+Storage::Storage(StorageConfig config_, const bool embed_rtree_leaves_)
+    : config(std::move(config_)), embed_rtree_leaves(embed_rtree_leaves_)
+{
+}
 
 int Storage::Run(int max_wait)
 {
@@ -311,6 +317,7 @@ void Storage::PopulateLayout(DataLayout &layout)
     {
         io::FileReader tree_node_file(config.GetPath(".osrm.ramIndex"),
                                       io::FileReader::VerifyFingerprint);
+        RTree::ReadFileFormat(tree_node_file, config.GetPath(".osrm.ramIndex"));
 
         const auto tree_size = tree_node_file.ReadElementCount64();
         layout.SetBlockSize<RTreeNode>(DataLayout::R_SEARCH_TREE, tree_size);
@@ -319,6 +326,38 @@ void Storage::PopulateLayout(DataLayout &layout)
         layout.SetBlockSize<std::uint64_t>(DataLayout::R_SEARCH_TREE_LEVELS, tree_levels_size);
     }
 
+    // load rsearch tree leaves size, by default the leaves are mmap'ed from the .fileIndex
+    // file by every process using the dataset and take no space here
+    if (embed_rtree_leaves)
+    {
+        io::FileReader leaf_node_file(config.GetPath(".osrm.fileIndex"),
+                                      io::FileReader::HasNoFingerprint);
+        const auto number_of_leaves = leaf_node_file.GetSize() / sizeof(RTreeLeaf);
+        layout.SetBlockSize<RTreeLeaf>(DataLayout::R_SEARCH_TREE_LEAVES, number_of_leaves);
+    }
+    else
+    {
+        layout.SetBlockSize<RTreeLeaf>(DataLayout::R_SEARCH_TREE_LEAVES, 0);
+    }
+
+    // load the optional spatial grid sizes
+    if (boost::filesystem::exists(config.GetPath(".osrm.grid")))
+    {
+        io::FileReader grid_file(config.GetPath(".osrm.grid"), io::FileReader::VerifyFingerprint);
+        grid_file.Skip<SpatialGrid::Header>(1);
+        const auto num_offsets = grid_file.ReadVectorSize<std::uint32_t>();
+        const auto num_entries = grid_file.ReadVectorSize<SpatialGrid::Entry>();
+        layout.SetBlockSize<SpatialGrid::Header>(DataLayout::SPATIAL_GRID_HEADER, 1);
+        layout.SetBlockSize<std::uint32_t>(DataLayout::SPATIAL_GRID_CELL_OFFSETS, num_offsets);
+        layout.SetBlockSize<SpatialGrid::Entry>(DataLayout::SPATIAL_GRID_ENTRIES, num_entries);
+    }
+    else
+    {
+        layout.SetBlockSize<SpatialGrid::Header>(DataLayout::SPATIAL_GRID_HEADER, 0);
+        layout.SetBlockSize<std::uint32_t>(DataLayout::SPATIAL_GRID_CELL_OFFSETS, 0);
+        layout.SetBlockSize<SpatialGrid::Entry>(DataLayout::SPATIAL_GRID_ENTRIES, 0);
+    }
+
     {
         layout.SetBlockSize<extractor::ProfileProperties>(DataLayout::PROPERTIES, 1);
     }
@@ -897,8 +936,9 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
     {
         io::FileReader tree_node_file(config.GetPath(".osrm.ramIndex"),
                                       io::FileReader::VerifyFingerprint);
-        // perform this read so that we're at the right stream position for the next
+        // perform these reads so that we're at the right stream position for the next
         // read.
+        RTree::ReadFileFormat(tree_node_file, config.GetPath(".osrm.ramIndex"));
         tree_node_file.Skip<std::uint64_t>(1);
         const auto rtree_ptr =
             layout.GetBlockPtr<RTreeNode, true>(memory_ptr, DataLayout::R_SEARCH_TREE);
@@ -913,6 +953,38 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
                                 layout.num_entries[DataLayout::R_SEARCH_TREE_LEVELS]);
     }
 
+    // store the leaves of the rtree
+    if (layout.num_entries[DataLayout::R_SEARCH_TREE_LEAVES] > 0)
+    {
+        io::FileReader leaf_node_file(config.GetPath(".osrm.fileIndex"),
+                                      io::FileReader::HasNoFingerprint);
+        const auto rtree_leaves_ptr =
+            layout.GetBlockPtr<RTreeLeaf, true>(memory_ptr, DataLayout::R_SEARCH_TREE_LEAVES);
+
+        leaf_node_file.ReadInto(rtree_leaves_ptr,
+                                layout.num_entries[DataLayout::R_SEARCH_TREE_LEAVES]);
+    }
+
+    // store the optional spatial grid
+    if (boost::filesystem::exists(config.GetPath(".osrm.grid")))
+    {
+        const auto header_ptr = layout.GetBlockPtr<SpatialGrid::Header, true>(
+            memory_ptr, DataLayout::SPATIAL_GRID_HEADER);
+        const auto offsets_ptr = layout.GetBlockPtr<std::uint32_t, true>(
+            memory_ptr, DataLayout::SPATIAL_GRID_CELL_OFFSETS);
+        const auto entries_ptr = layout.GetBlockPtr<SpatialGrid::Entry, true>(
+            memory_ptr, DataLayout::SPATIAL_GRID_ENTRIES);
+
+        util::vector_view<std::uint32_t> cell_offsets(
+            offsets_ptr, layout.num_entries[DataLayout::SPATIAL_GRID_CELL_OFFSETS]);
+        util::vector_view<SpatialGrid::Entry> entries(
+            entries_ptr, layout.num_entries[DataLayout::SPATIAL_GRID_ENTRIES]);
+
+        SpatialGrid grid{{}, std::move(cell_offsets), std::move(entries)};
+        extractor::files::readSpatialGrid(config.GetPath(".osrm.grid"), grid);
+        *header_ptr = grid.GetHeader();
+    }
+
     // load profile properties
     {
         const auto profile_properties_ptr = layout.GetBlockPtr<extractor::ProfileProperties, true>(
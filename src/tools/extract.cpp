@@ -52,6 +52,17 @@ return_code parseArguments(int argc,
             ->default_value(1000),
         "Number of nodes required before a strongly-connected-componennt is considered big "
         "(affects nearest neighbor snapping)")(
+        "spatial-grid-cell-size",
+        boost::program_options::value<unsigned int>(&extractor_config.spatial_grid_cell_size)
+            ->default_value(0),
+        "Cell size in meters of an additional grid that speeds up snapping in dense areas. "
+        "0 disables the grid")(
+        "road-overview",
+        boost::program_options::bool_switch(&extractor_config.generate_road_overview)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Build a simplified network of the major roads that tiles of zoom levels 8 to 11 "
+        "are rendered from")(
         "with-osm-metadata",
         boost::program_options::bool_switch(&extractor_config.use_metadata)
             ->implicit_value(true)
@@ -1,3 +1,4 @@
+#include "engine/engine_config_options.hpp"
 #include "server/server.hpp"
 #include "util/exception_utils.hpp"
 #include "util/log.hpp"
@@ -9,7 +10,6 @@
 #include "osrm/osrm.hpp"
 #include "osrm/storage_config.hpp"
 
-#include <boost/algorithm/string/case_conv.hpp>
 #include <boost/any.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
@@ -52,27 +52,6 @@ const static unsigned INIT_OK_START_ENGINE = 0;
 const static unsigned INIT_OK_DO_NOT_START_ENGINE = 1;
 const static unsigned INIT_FAILED = -1;
 
-namespace osrm
-{
-namespace engine
-{
-std::istream &operator>>(std::istream &in, EngineConfig::Algorithm &algorithm)
-{
-    std::string token;
-    in >> token;
-    boost::to_lower(token);
-
-    if (token == "ch" || token == "corech")
-        algorithm = EngineConfig::Algorithm::CH;
-    else if (token == "mld")
-        algorithm = EngineConfig::Algorithm::MLD;
-    else
-        throw util::RuntimeError(token, ErrorCode::UnknownAlgorithm, SOURCE_REF);
-    return in;
-}
-}
-}
-
 // generate boost::program_options object for the routing part
 inline unsigned generateServerProgramOptions(const int argc,
                                              const char *argv[],
@@ -81,7 +60,15 @@ inline unsigned generateServerProgramOptions(const int argc,
                                              int &ip_port,
                                              bool &trial,
                                              EngineConfig &config,
-                                             int &requested_thread_num)
+                                             int &requested_thread_num,
+                                             int &max_response_cache_size,
+                                             int &response_cache_ttl,
+                                             int &keepalive_requests,
+                                             int &keepalive_timeout,
+                                             int &interactive_concurrency,
+                                             int &interactive_queue_size,
+                                             int &batch_concurrency,
+                                             int &batch_queue_size)
 {
     using boost::program_options::value;
     using boost::filesystem::path;
@@ -109,6 +96,26 @@ inline unsigned generateServerProgramOptions(const int argc,
         ("threads,t",
          value<int>(&requested_thread_num)->default_value(hardware_threads),
          "Number of threads to use") //
+        ("keepalive-requests",
+         value<int>(&keepalive_requests)->default_value(512),
+         "Max. requests answered over one HTTP connection, 0 closes every connection after the "
+         "first reply") //
+        ("keepalive-timeout",
+         value<int>(&keepalive_timeout)->default_value(5),
+         "Seconds an HTTP connection is kept open while waiting for a request, must be "
+         "positive") //
+        ("interactive-concurrency",
+         value<int>(&interactive_concurrency)->default_value(0),
+         "Max. route, nearest and tile requests computed at the same time, 0 uses all threads") //
+        ("interactive-queue-size",
+         value<int>(&interactive_queue_size)->default_value(256),
+         "Max. route, nearest and tile requests waiting, further ones are rejected with 503") //
+        ("batch-concurrency",
+         value<int>(&batch_concurrency)->default_value(0),
+         "Max. table, match and trip requests computed at the same time, 0 uses all threads") //
+        ("batch-queue-size",
+         value<int>(&batch_queue_size)->default_value(256),
+         "Max. table, match and trip requests waiting, further ones are rejected with 503") //
         ("shared-memory,s",
          value<bool>(&config.use_shared_memory)->implicit_value(true)->default_value(false),
          "Load data from shared memory") //
@@ -122,6 +129,9 @@ inline unsigned generateServerProgramOptions(const int argc,
         ("max-trip-size",
          value<int>(&config.max_locations_trip)->default_value(100),
          "Max. locations supported in trip query") //
+        ("max-trip-search-time",
+         value<int>(&config.max_trip_search_time)->default_value(100),
+         "Max. milliseconds spent improving a trip with local search, 0 disables it") //
         ("max-table-size",
          value<int>(&config.max_locations_distance_table)->default_value(-1),
          "Max. locations supported in distance table query") //
@@ -131,9 +141,40 @@ inline unsigned generateServerProgramOptions(const int argc,
         ("max-nearest-size",
          value<int>(&config.max_results_nearest)->default_value(100),
          "Max. results supported in nearest query") //
+        ("max-nearest-batch-size",
+         value<int>(&config.max_locations_nearest)->default_value(10000),
+         "Max. locations supported in batch nearest query") //
         ("max-alternatives",
          value<int>(&config.max_alternatives)->default_value(3),
-         "Max. number of alternatives supported in the MLD route query");
+         "Max. number of alternatives supported in the MLD route query") //
+        ("rtree-populate",
+         value<bool>(&config.rtree_leaf_advice.populate)
+             ->implicit_value(true)
+             ->default_value(false),
+         "Load all r-tree leaves (.fileIndex) into memory on startup") //
+        ("rtree-huge-pages",
+         value<bool>(&config.rtree_leaf_advice.huge_pages)
+             ->implicit_value(true)
+             ->default_value(false),
+         "Use transparent huge pages for the r-tree leaves if the kernel supports it") //
+        ("rtree-prefetch",
+         value<bool>(&config.rtree_leaf_advice.prefetch)
+             ->implicit_value(true)
+             ->default_value(false),
+         "Read ahead sibling r-tree leaves during nearest neighbour queries") //
+        ("max-tile-cache-size",
+         value<int>(&config.max_tile_cache_size)->default_value(32),
+         "Max. megabytes of encoded tiles cached, 0 disables the cache") //
+        ("tile-archive",
+         value<boost::filesystem::path>(&config.tile_archive),
+         "Serve tiles pre-rendered by osrm-tiles for this dataset from the given file") //
+        ("max-response-cache-size",
+         value<int>(&max_response_cache_size)->default_value(0),
+         "Max. megabytes of compressed route, table, nearest and trip replies cached, "
+         "0 disables the cache") //
+        ("response-cache-ttl",
+         value<int>(&response_cache_ttl)->default_value(10),
+         "Seconds a cached reply is served for");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -183,6 +224,13 @@ inline unsigned generateServerProgramOptions(const int argc,
 
     boost::program_options::notify(option_variables);
 
+    if (keepalive_timeout <= 0)
+    {
+        util::Log(logERROR) << "--keepalive-timeout needs to be a positive number of seconds, "
+                               "use --keepalive-requests 0 to disable keep-alive";
+        return INIT_FAILED;
+    }
+
     if (!config.use_shared_memory && option_variables.count("base"))
     {
         return INIT_OK_START_ENGINE;
@@ -215,8 +263,30 @@ int main(int argc, const char *argv[]) try
     boost::filesystem::path base_path;
 
     int requested_thread_num = 1;
-    const unsigned init_result = generateServerProgramOptions(
-        argc, argv, base_path, ip_address, ip_port, trial_run, config, requested_thread_num);
+    int max_response_cache_size = 0;
+    int response_cache_ttl = 10;
+    int keepalive_requests = 512;
+    int keepalive_timeout = 5;
+    int interactive_concurrency = 0;
+    int interactive_queue_size = 256;
+    int batch_concurrency = 0;
+    int batch_queue_size = 256;
+    const unsigned init_result = generateServerProgramOptions(argc,
+                                                              argv,
+                                                              base_path,
+                                                              ip_address,
+                                                              ip_port,
+                                                              trial_run,
+                                                              config,
+                                                              requested_thread_num,
+                                                              max_response_cache_size,
+                                                              response_cache_ttl,
+                                                              keepalive_requests,
+                                                              keepalive_timeout,
+                                                              interactive_concurrency,
+                                                              interactive_queue_size,
+                                                              batch_concurrency,
+                                                              batch_queue_size);
     if (init_result == INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -266,10 +336,33 @@ int main(int argc, const char *argv[]) try
 #endif
 
     auto service_handler = std::make_unique<server::ServiceHandler>(config);
-    auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num);
+    // without limits every thread may compute requests of either class
+    const auto getLimits = [&](const int concurrency, const int queue_size) {
+        return server::RequestScheduler::Limits{
+            static_cast<unsigned>(concurrency > 0 ? concurrency : requested_thread_num),
+            static_cast<std::size_t>(std::max(0, queue_size))};
+    };
+    auto routing_server =
+        server::Server::CreateServer(ip_address,
+                                     ip_port,
+                                     requested_thread_num,
+                                     std::max(0, keepalive_requests),
+                                     keepalive_timeout,
+                                     getLimits(interactive_concurrency, interactive_queue_size),
+                                     getLimits(batch_concurrency, batch_queue_size));
 
     routing_server->RegisterServiceHandler(std::move(service_handler));
 
+    if (max_response_cache_size > 0)
+    {
+        util::Log() << "Response cache: " << max_response_cache_size << " MB, "
+                    << response_cache_ttl << " s";
+        auto response_cache = std::make_unique<server::ResponseCache>(
+            static_cast<std::size_t>(max_response_cache_size) * 1024 * 1024,
+            std::chrono::seconds(response_cache_ttl));
+        routing_server->RegisterResponseCache(std::move(response_cache));
+    }
+
     if (trial_run)
     {
         util::Log() << "trial run, quitting after successful initialization";
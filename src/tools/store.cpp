@@ -54,7 +54,8 @@ bool generateDataStoreOptions(const int argc,
                               const char *argv[],
                               std::string &verbosity,
                               boost::filesystem::path &base_path,
-                              int &max_wait)
+                              int &max_wait,
+                              bool &embed_rtree_leaves)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
@@ -71,7 +72,11 @@ bool generateDataStoreOptions(const int argc,
     config_options.add_options()("max-wait",
                                  boost::program_options::value<int>(&max_wait)->default_value(-1),
                                  "Maximum number of seconds to wait on a running data update "
-                                 "before aquiring the lock by force.");
+                                 "before aquiring the lock by force.")(
+        "embed-rtree-leaves",
+        boost::program_options::bool_switch(&embed_rtree_leaves)->default_value(false),
+        "Load the r-tree leaves (.fileIndex) into shared memory instead of letting every "
+        "process mmap the file. Swaps the leaves together with the rest of the dataset.");
 
     // hidden options, will be allowed on command line but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -164,7 +169,9 @@ int main(const int argc, const char *argv[]) try
     std::string verbosity;
     boost::filesystem::path base_path;
     int max_wait = -1;
-    if (!generateDataStoreOptions(argc, argv, verbosity, base_path, max_wait))
+    bool embed_rtree_leaves = false;
+    if (!generateDataStoreOptions(
+            argc, argv, verbosity, base_path, max_wait, embed_rtree_leaves))
     {
         return EXIT_SUCCESS;
     }
@@ -177,7 +184,7 @@ int main(const int argc, const char *argv[]) try
         util::Log(logERROR) << "Config contains invalid file paths. Exiting!";
         return EXIT_FAILURE;
     }
-    storage::Storage storage(std::move(config));
+    storage::Storage storage(std::move(config), embed_rtree_leaves);
 
     return storage.Run(max_wait);
 }
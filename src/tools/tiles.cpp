@@ -0,0 +1,339 @@
+#include "engine/engine_config_options.hpp"
+#include "engine/tile_archive.hpp"
+#include "storage/io.hpp"
+#include "storage/shared_datatype.hpp"
+#include "storage/shared_monitor.hpp"
+#include "util/exception_utils.hpp"
+#include "util/log.hpp"
+#include "util/meminfo.hpp"
+#include "util/version.hpp"
+#include "util/web_mercator.hpp"
+
+#include "osrm/engine_config.hpp"
+#include "osrm/exception.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+#include "osrm/storage_config.hpp"
+#include "osrm/tile_parameters.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/program_options.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/task_scheduler_init.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace osrm;
+
+enum class return_code : unsigned
+{
+    ok,
+    fail,
+    exit
+};
+
+struct TileRange
+{
+    unsigned min_zoom = 12;
+    unsigned max_zoom = 16;
+    double min_lon = 0;
+    double min_lat = 0;
+    double max_lon = 0;
+    double max_lat = 0;
+};
+
+return_code parseArguments(int argc,
+                           char *argv[],
+                           std::string &verbosity,
+                           boost::filesystem::path &base_path,
+                           boost::filesystem::path &output_path,
+                           EngineConfig &config,
+                           TileRange &range,
+                           int &requested_num_threads)
+{
+    using boost::program_options::value;
+
+    std::string bbox;
+
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h",
+                                                                "Show this help message")(
+        "verbosity,l",
+        value<std::string>(&verbosity)->default_value("INFO"),
+        std::string("Log verbosity level: " + util::LogPolicy::GetLevels()).c_str());
+
+    // declare a group of options that will be allowed on command line
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options() //
+        ("output,o",
+         value<boost::filesystem::path>(&output_path),
+         "Tile archive to write, <base.osrm>.tiles by default") //
+        ("shared-memory,s",
+         value<bool>(&config.use_shared_memory)->implicit_value(true)->default_value(false),
+         "Render from the dataset loaded by osrm-datastore for <base.osrm>, so that the "
+         "tiles are served until the next weight update") //
+        ("algorithm,a",
+         value<EngineConfig::Algorithm>(&config.algorithm)
+             ->default_value(EngineConfig::Algorithm::CH, "CH"),
+         "Algorithm to use for the data. Can be CH, CoreCH, MLD.") //
+        ("bbox",
+         value<std::string>(&bbox)->required(),
+         "Area to render as min_lon,min_lat,max_lon,max_lat") //
+        ("min-zoom",
+         value<unsigned>(&range.min_zoom)->default_value(12),
+         "Lowest zoom level to render, at least 12") //
+        ("max-zoom",
+         value<unsigned>(&range.max_zoom)->default_value(16),
+         "Highest zoom level to render, at most 19") //
+        ("threads,t",
+         value<int>(&requested_num_threads)
+             ->default_value(std::max<int>(1, std::thread::hardware_concurrency())),
+         "Number of threads to use");
+
+    // hidden options, will be allowed on command line, but will not be shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()(
+        "base,b", value<boost::filesystem::path>(&base_path), "base path to .osrm file");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("base", 1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        boost::filesystem::path(executable).filename().string() + " <base.osrm> [<options>]");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    try
+    {
+        boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                          .options(cmdline_options)
+                                          .positional(positional_options)
+                                          .run(),
+                                      option_variables);
+    }
+    catch (const boost::program_options::error &e)
+    {
+        util::Log(logERROR) << e.what();
+        return return_code::fail;
+    }
+
+    if (option_variables.count("version"))
+    {
+        std::cout << OSRM_VERSION << std::endl;
+        return return_code::exit;
+    }
+
+    if (option_variables.count("help"))
+    {
+        std::cout << visible_options;
+        return return_code::exit;
+    }
+
+    if (!option_variables.count("base"))
+    {
+        std::cout << visible_options;
+        return return_code::exit;
+    }
+
+    try
+    {
+        boost::program_options::notify(option_variables);
+    }
+    catch (const boost::program_options::error &e)
+    {
+        util::Log(logERROR) << e.what();
+        return return_code::fail;
+    }
+
+    std::replace(bbox.begin(), bbox.end(), ',', ' ');
+    std::istringstream bbox_stream(bbox);
+    if (!(bbox_stream >> range.min_lon >> range.min_lat >> range.max_lon >> range.max_lat) ||
+        range.min_lon >= range.max_lon || range.min_lat >= range.max_lat)
+    {
+        util::Log(logERROR) << "--bbox needs to be min_lon,min_lat,max_lon,max_lat";
+        return return_code::fail;
+    }
+
+    if (range.min_zoom < 12 || range.max_zoom > 19 || range.min_zoom > range.max_zoom)
+    {
+        util::Log(logERROR) << "Zoom levels need to be between 12 and 19";
+        return return_code::fail;
+    }
+
+    return return_code::ok;
+}
+
+// all tiles of the range in the order of the archive index
+std::vector<TileParameters> getTiles(const TileRange &range)
+{
+    std::vector<TileParameters> tiles;
+    for (auto z = range.min_zoom; z <= range.max_zoom; ++z)
+    {
+        const auto tile_index = [z](const double pixel) {
+            const auto index = std::max(0., pixel / util::web_mercator::TILE_SIZE);
+            return std::min<unsigned>((1u << z) - 1, static_cast<unsigned>(index));
+        };
+        const auto min_x = tile_index(util::web_mercator::degreeToPixel(
+            util::web_mercator::clamp(util::FloatLongitude{range.min_lon}), z));
+        const auto max_x = tile_index(util::web_mercator::degreeToPixel(
+            util::web_mercator::clamp(util::FloatLongitude{range.max_lon}), z));
+        // the y axis of tiles points south
+        const auto min_y = tile_index(util::web_mercator::degreeToPixel(
+            util::web_mercator::clamp(util::FloatLatitude{range.max_lat}), z));
+        const auto max_y = tile_index(util::web_mercator::degreeToPixel(
+            util::web_mercator::clamp(util::FloatLatitude{range.min_lat}), z));
+
+        for (auto x = min_x; x <= max_x; ++x)
+        {
+            for (auto y = min_y; y <= max_y; ++y)
+            {
+                tiles.push_back(TileParameters{x, y, z});
+            }
+        }
+    }
+    return tiles;
+}
+
+int main(int argc, char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    std::string verbosity;
+    boost::filesystem::path base_path;
+    boost::filesystem::path output_path;
+    EngineConfig config;
+    TileRange range;
+    int requested_num_threads = 1;
+    const auto result = parseArguments(argc,
+                                       argv,
+                                       verbosity,
+                                       base_path,
+                                       output_path,
+                                       config,
+                                       range,
+                                       requested_num_threads);
+    if (return_code::fail == result)
+    {
+        return EXIT_FAILURE;
+    }
+    if (return_code::exit == result)
+    {
+        return EXIT_SUCCESS;
+    }
+
+    util::LogPolicy::GetInstance().SetLevel(verbosity);
+
+    config.storage_config = storage::StorageConfig(base_path);
+    // every tile is rendered once, caching them would only cost memory
+    config.max_tile_cache_size = 0;
+    if (!config.storage_config.IsValid())
+    {
+        util::Log(logERROR) << "Required files are missing, cannot continue";
+        return EXIT_FAILURE;
+    }
+    if (output_path.empty())
+    {
+        output_path = base_path.string() + ".tiles";
+    }
+
+    // tiles are only served for the dataset they were rendered from
+    storage::io::FileReader timestamp_file(config.storage_config.GetPath(".osrm.timestamp"),
+                                           storage::io::FileReader::VerifyFingerprint);
+    std::string timestamp(timestamp_file.GetSize(), '\0');
+    timestamp_file.ReadInto(&timestamp[0], timestamp.size());
+
+    // The generation tells datasets with the same OSM data but different weights apart. It is
+    // the timestamp osrm-datastore gives to the loaded data and 0 when reading the files.
+    std::function<std::uint32_t()> get_generation = [] { return 0u; };
+    if (config.use_shared_memory)
+    {
+        auto barrier = std::make_shared<storage::SharedMonitor<storage::SharedDataTimestamp>>();
+        get_generation = [barrier] {
+            using mutex_type = storage::SharedMonitor<storage::SharedDataTimestamp>::mutex_type;
+            boost::interprocess::scoped_lock<mutex_type> current_region_lock(
+                barrier->get_mutex());
+            return barrier->data().timestamp;
+        };
+    }
+    const auto generation = get_generation();
+
+    const OSRM osrm{config};
+
+    const auto tiles = getTiles(range);
+    util::Log() << "Rendering " << tiles.size() << " tiles of zoom levels " << range.min_zoom
+                << " to " << range.max_zoom << " with " << requested_num_threads << " threads";
+
+    tbb::task_scheduler_init init(requested_num_threads);
+
+    // finished tiles go straight to disk so that large areas do not need to fit into memory
+    engine::TileArchiveWriter archive(
+        output_path, timestamp, generation, engine::getWeightsFingerprint(config.storage_config));
+    std::atomic<std::size_t> failed_tiles{0};
+    tbb::parallel_for(std::size_t{0}, tiles.size(), [&](const std::size_t index) {
+        std::string encoded_tile;
+        if (osrm.Tile(tiles[index], encoded_tile) != Status::Ok)
+        {
+            ++failed_tiles;
+            return;
+        }
+        archive.Add(tiles[index].z, tiles[index].x, tiles[index].y, encoded_tile);
+    });
+
+    if (failed_tiles > 0)
+    {
+        util::Log(logERROR) << failed_tiles << " tiles could not be rendered";
+        return EXIT_FAILURE;
+    }
+    if (get_generation() != generation)
+    {
+        util::Log(logERROR) << "osrm-datastore loaded new data while rendering, run osrm-tiles "
+                               "again";
+        return EXIT_FAILURE;
+    }
+
+    const auto num_tiles = archive.Finish();
+    util::Log() << "Wrote " << num_tiles << " tiles to " << output_path.string();
+
+    return EXIT_SUCCESS;
+}
+catch (const osrm::RuntimeError &e)
+{
+    util::Log(logERROR) << e.what();
+    return e.GetCode();
+}
+catch (const std::bad_alloc &e)
+{
+    util::DumpMemoryStats();
+    util::Log(logWARNING) << "[exception] " << e.what();
+    util::Log(logWARNING) << "Please provide more memory or consider using a larger swapfile";
+    return EXIT_FAILURE;
+}
+#ifdef _WIN32
+catch (const std::exception &e)
+{
+    util::Log(logERROR) << "[exception] " << e.what();
+    return EXIT_FAILURE;
+}
+#endif
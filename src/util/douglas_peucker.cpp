@@ -1,4 +1,4 @@
-#include "engine/douglas_peucker.hpp"
+#include "util/douglas_peucker.hpp"
 #include "util/coordinate.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/integer_range.hpp"
@@ -14,7 +14,7 @@
 
 namespace osrm
 {
-namespace engine
+namespace util
 {
 
 // Normed to the thresholds table
@@ -77,7 +77,6 @@ std::vector<util::Coordinate> douglasPeucker(std::vector<util::Coordinate>::cons
         // sweep over range to find the maximum
         for (auto idx = pair.first + 1; idx != pair.second; ++idx)
         {
-            using namespace util::coordinate_calculation;
             const auto distance = fastPerpendicularDistance(projected_coordinates[pair.first],
                                                             projected_coordinates[pair.second],
                                                             projected_coordinates[idx]);
@@ -119,5 +118,5 @@ std::vector<util::Coordinate> douglasPeucker(std::vector<util::Coordinate>::cons
 
     return simplified_geometry;
 }
-} // ns engine
+} // ns util
 } // ns osrm
@@ -100,4 +100,40 @@ BOOST_AUTO_TEST_CASE(trim_short_segments)
     BOOST_CHECK_EQUAL(geometry.osm_node_ids.size(), 2);
 }
 
+BOOST_AUTO_TEST_CASE(append_leg_node_ids)
+{
+    using namespace osrm::engine::guidance;
+    using namespace osrm::util;
+
+    const auto ids = [](const std::vector<std::uint64_t> &values) {
+        std::vector<OSMNodeID> node_ids;
+        for (const auto value : values)
+        {
+            node_ids.push_back(OSMNodeID{value});
+        }
+        return node_ids;
+    };
+
+    // a leg starts and ends with the nodes of the segments of its waypoints in driving direction
+    std::vector<OSMNodeID> node_ids;
+    appendLegNodeIds(node_ids, ids({1, 2, 3}), false, false);
+    BOOST_CHECK(node_ids == ids({1, 2, 3}));
+
+    // leaves in the direction it arrived in and comes back to the same segment
+    appendLegNodeIds(node_ids, ids({2, 3, 4, 2, 3}), false, false);
+    BOOST_CHECK(node_ids == ids({1, 2, 3, 4, 2, 3}));
+
+    // U-turn at the waypoint
+    appendLegNodeIds(node_ids, ids({3, 2, 1, 4}), false, true);
+    BOOST_CHECK(node_ids == ids({1, 2, 3, 4, 2, 3, 2, 1, 4}));
+
+    // U-turn on a segment that is traversed in reverse
+    appendLegNodeIds(node_ids, ids({4, 1, 2}), true, false);
+    BOOST_CHECK(node_ids == ids({1, 2, 3, 4, 2, 3, 2, 1, 4, 1, 2}));
+
+    // both waypoints of the leg are on the same segment
+    appendLegNodeIds(node_ids, ids({1, 2}), false, false);
+    BOOST_CHECK(node_ids == ids({1, 2, 3, 4, 2, 3, 2, 1, 4, 1, 2}));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
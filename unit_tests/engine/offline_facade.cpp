@@ -243,6 +243,14 @@ class ContiguousInternalMemoryDataFacade<routing_algorithms::offline::Algorithm>
         return {};
     }
 
+    std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodesInRange(const std::vector<util::Coordinate> &input_coordinates,
+                               const std::vector<double> & /*max_distances*/,
+                               const std::vector<Approach> & /*approaches*/) const override
+    {
+        return std::vector<std::vector<PhantomNodeWithDistance>>(input_coordinates.size());
+    }
+
     std::vector<PhantomNodeWithDistance>
     NearestPhantomNodes(const util::Coordinate /*input_coordinate*/,
                         const unsigned /*max_results*/,
@@ -334,6 +342,7 @@ class ContiguousInternalMemoryDataFacade<routing_algorithms::offline::Algorithm>
     StringView GetDestinationsForID(const NameID /*id*/) const override { return StringView{}; }
     StringView GetExitsForID(const NameID /*id*/) const override { return StringView{}; }
     std::string GetTimestamp() const override { return std::string(); }
+    unsigned GetDatasetGeneration() const override { return 0; }
     bool GetContinueStraightDefault() const override { return false; }
     double GetMapMatchingMaxSpeed() const override { return 0; }
     const char *GetWeightName() const override { return ""; }
@@ -46,4 +46,26 @@ BOOST_AUTO_TEST_CASE(polyline6_test_case)
         decodePolyline<1000000>(encodePolyline<1000000>(coords.begin(), coords.end())).begin()));
 }
 
+BOOST_AUTO_TEST_CASE(polyline_large_deltas_test_case)
+{
+    using namespace osrm::engine;
+    using namespace osrm::util;
+
+    // deltas from one end of the world to the other need the longest encodings
+    const std::vector<Coordinate> coords({{FixedLongitude{-180000000}, FixedLatitude{-85000000}},
+                                          {FixedLongitude{180000000}, FixedLatitude{85000000}},
+                                          {FixedLongitude{0}, FixedLatitude{0}},
+                                          {FixedLongitude{-1}, FixedLatitude{1}},
+                                          {FixedLongitude{-180000000}, FixedLatitude{85000000}}});
+
+    BOOST_CHECK_EQUAL(encodePolyline<1000000>(coords.begin(), coords.end()),
+                      "~r~baD~niivI_g~fcI__tsmT~r~baD~niivIA@}r~baD|niivI");
+    BOOST_CHECK(std::equal(
+        coords.begin(),
+        coords.end(),
+        decodePolyline<1000000>(encodePolyline<1000000>(coords.begin(), coords.end())).begin()));
+    BOOST_CHECK(encodePolyline(coords.begin(), coords.begin()).empty());
+    BOOST_CHECK(decodePolyline("").empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,136 @@
+#include "engine/tile_archive.hpp"
+#include "engine/tile_cache.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(tile_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+BOOST_AUTO_TEST_CASE(get_put)
+{
+    TileCache cache(100);
+
+    const TileKey key{14, 1, 2};
+    BOOST_CHECK(!cache.Get(key, 7));
+
+    cache.Put(key, 7, "tile");
+    BOOST_CHECK_EQUAL(*cache.Get(key, 7), "tile");
+    BOOST_CHECK(!cache.Get(TileKey{14, 2, 1}, 7));
+}
+
+BOOST_AUTO_TEST_CASE(flush_on_new_generation)
+{
+    TileCache cache(100);
+
+    cache.Put(TileKey{14, 1, 2}, 0, "old");
+    BOOST_CHECK_EQUAL(cache.Size(), 1);
+
+    // e.g. osrm-datastore loaded new weights
+    BOOST_CHECK(!cache.Get(TileKey{14, 1, 2}, 1));
+    BOOST_CHECK_EQUAL(cache.Size(), 0);
+
+    // tiles of a request that still ran on the old data are not stored
+    cache.Put(TileKey{14, 1, 2}, 0, "old");
+    BOOST_CHECK_EQUAL(cache.Size(), 0);
+
+    cache.Put(TileKey{14, 1, 2}, 1, "new");
+    BOOST_CHECK_EQUAL(*cache.Get(TileKey{14, 1, 2}, 1), "new");
+}
+
+BOOST_AUTO_TEST_CASE(evict_least_recently_used)
+{
+    TileCache cache(10);
+
+    const TileKey a{14, 0, 0};
+    const TileKey b{14, 0, 1};
+    const TileKey c{14, 0, 2};
+    cache.Put(a, 0, "aaaa");
+    cache.Put(b, 0, "bbbb");
+
+    // reading "a" makes "b" the least recently used tile
+    BOOST_CHECK(cache.Get(a, 0));
+    cache.Put(c, 0, "cccc");
+
+    BOOST_CHECK_EQUAL(cache.Size(), 2);
+    BOOST_CHECK(!cache.Get(b, 0));
+    BOOST_CHECK(cache.Get(a, 0));
+    BOOST_CHECK(cache.Get(c, 0));
+
+    // tiles bigger than the whole cache are not stored
+    cache.Put(b, 0, "bbbbbbbbbbb");
+    BOOST_CHECK(!cache.Get(b, 0));
+    BOOST_CHECK_EQUAL(cache.Size(), 2);
+
+    TileCache disabled(0);
+    disabled.Put(a, 0, "aaaa");
+    BOOST_CHECK_EQUAL(disabled.Size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(archive_round_trip)
+{
+    const auto path =
+        boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    {
+        // tiles are added in the order they finish rendering
+        TileArchiveWriter writer(path, "2017-10-01", 42, 7);
+        writer.Add(13, 1, 2, "second");
+        writer.Add(12, 5, 6, "first");
+        writer.Add(13, 1, 1, "");
+        BOOST_CHECK_EQUAL(writer.Finish(), 3);
+    }
+    BOOST_CHECK(!boost::filesystem::exists(path.string() + ".data"));
+
+    {
+        TileArchive archive;
+        readTileArchive(path, archive);
+
+        BOOST_CHECK_EQUAL(archive.GetTimestamp(), "2017-10-01");
+        BOOST_CHECK_EQUAL(archive.GetDatasetGeneration(), 42);
+        BOOST_CHECK_EQUAL(archive.GetWeightsFingerprint(), 7);
+        BOOST_CHECK_EQUAL(archive.Size(), 3);
+        BOOST_CHECK_EQUAL(*archive.Find(12, 5, 6), "first");
+        BOOST_CHECK_EQUAL(*archive.Find(13, 1, 1), "");
+        BOOST_CHECK_EQUAL(*archive.Find(13, 1, 2), "second");
+        BOOST_CHECK(!archive.Find(13, 2, 1));
+        BOOST_CHECK(!archive.Find(12, 5, 7));
+    }
+    boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(weights_fingerprint)
+{
+    const auto directory =
+        boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    boost::filesystem::create_directory(directory);
+    const storage::StorageConfig config{directory / "data.osrm"};
+
+    const auto write = [&](const std::string &extension, const std::string &content) {
+        std::ofstream file(config.GetPath(extension).string(), std::ios::app);
+        file << content;
+    };
+
+    write(".osrm.geometry", "geometry");
+    const auto fingerprint = getWeightsFingerprint(config);
+    BOOST_CHECK_EQUAL(getWeightsFingerprint(config), fingerprint);
+
+    // files that do not carry weights are ignored
+    write(".osrm.names", "names");
+    BOOST_CHECK_EQUAL(getWeightsFingerprint(config), fingerprint);
+
+    // osrm-customize writes new metrics, osrm-contract updates the segment weights
+    write(".osrm.cell_metrics", "metrics");
+    const auto customized_fingerprint = getWeightsFingerprint(config);
+    BOOST_CHECK_NE(customized_fingerprint, fingerprint);
+    write(".osrm.geometry", "updated");
+    BOOST_CHECK_NE(getWeightsFingerprint(config), customized_fingerprint);
+
+    boost::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
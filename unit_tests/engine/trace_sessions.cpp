@@ -0,0 +1,103 @@
+#include "engine/map_matching/trace_sessions.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(trace_sessions)
+
+using namespace osrm;
+using namespace osrm::engine::map_matching;
+
+namespace
+{
+void addPoint(TraceSession &session, const unsigned timestamp)
+{
+    session.coordinates.push_back(
+        util::Coordinate{util::FloatLongitude{1}, util::FloatLatitude{2}});
+    session.timestamps.push_back(timestamp);
+}
+}
+
+BOOST_AUTO_TEST_CASE(take_put)
+{
+    TraceSessions sessions(2);
+
+    {
+        auto session = sessions.Take("a");
+        BOOST_CHECK(session->coordinates.empty());
+        BOOST_CHECK(!session->anchor);
+
+        addPoint(*session, 5);
+
+        // taken sessions are gone until they are put back
+        BOOST_CHECK_EQUAL(sessions.Size(), 0);
+    }
+    BOOST_CHECK_EQUAL(sessions.Size(), 1);
+
+    auto session = sessions.Take("a");
+    BOOST_CHECK_EQUAL(sessions.Size(), 0);
+    BOOST_CHECK_EQUAL(session->coordinates.size(), 1);
+    BOOST_CHECK_EQUAL(session->timestamps.front(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(drop_empty_sessions)
+{
+    TraceSessions sessions(2);
+
+    addPoint(*sessions.Take("a"), 1);
+    BOOST_CHECK_EQUAL(sessions.Size(), 1);
+
+    // everything was finalised and there is no anchor to continue from
+    sessions.Take("a")->coordinates.clear();
+    BOOST_CHECK_EQUAL(sessions.Size(), 0);
+
+    // looking up an unknown id does not add a session
+    sessions.Take("b");
+    BOOST_CHECK_EQUAL(sessions.Size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(evict_least_recently_used)
+{
+    TraceSessions sessions(2);
+
+    addPoint(*sessions.Take("a"), 1);
+    addPoint(*sessions.Take("b"), 2);
+
+    // touching "a" makes "b" the least recently used session
+    sessions.Take("a");
+    addPoint(*sessions.Take("c"), 3);
+
+    BOOST_CHECK_EQUAL(sessions.Size(), 2);
+    BOOST_CHECK(sessions.Take("b")->timestamps.empty());
+    BOOST_CHECK_EQUAL(sessions.Take("a")->timestamps.front(), 1);
+    BOOST_CHECK_EQUAL(sessions.Take("c")->timestamps.front(), 3);
+}
+
+// Requests of the same vehicle must not overwrite each other's points
+BOOST_AUTO_TEST_CASE(concurrent_takes_are_serialised)
+{
+    TraceSessions sessions(10);
+
+    std::vector<std::thread> threads;
+    for (unsigned thread = 0; thread < 8; ++thread)
+    {
+        threads.emplace_back([&sessions, thread] {
+            for (unsigned index = 0; index < 100; ++index)
+            {
+                auto session = sessions.Take("a");
+                addPoint(*session, thread * 100 + index);
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    BOOST_CHECK_EQUAL(sessions.Take("a")->timestamps.size(), 800);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
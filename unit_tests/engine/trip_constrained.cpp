@@ -0,0 +1,94 @@
+#include "engine/trip/trip_constrained.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(trip_constrained)
+
+using namespace osrm;
+using namespace osrm::engine::trip;
+
+namespace
+{
+// locations on a line, driving left takes twice as long as driving right
+util::DistTableWrapper<EdgeWeight> makeTable(const std::vector<int> &locations)
+{
+    std::vector<EdgeWeight> table;
+    for (const auto from : locations)
+    {
+        for (const auto to : locations)
+        {
+            table.push_back(to >= from ? to - from : 2 * (from - to));
+        }
+    }
+    return util::DistTableWrapper<EdgeWeight>(std::move(table), locations.size());
+}
+
+std::size_t position(const std::vector<NodeID> &trip, const NodeID node)
+{
+    return std::distance(trip.begin(), std::find(trip.begin(), trip.end(), node));
+}
+
+const auto UNLIMITED = std::numeric_limits<EdgeWeight>::max();
+const auto SEARCH_TIME = std::chrono::seconds(1);
+}
+
+BOOST_AUTO_TEST_CASE(unconstrained_one_way)
+{
+    const auto table = makeTable({0, 30, 10, 20, 40});
+
+    const auto trip =
+        ConstrainedTrip(5, table, 0, SPECIAL_NODEID, false, {}, UNLIMITED, SEARCH_TIME);
+
+    const std::vector<NodeID> reference = {0, 2, 3, 1, 4};
+    BOOST_CHECK_EQUAL_COLLECTIONS(trip.begin(), trip.end(), reference.begin(), reference.end());
+}
+
+BOOST_AUTO_TEST_CASE(precedences)
+{
+    const auto table = makeTable({0, 10, 20, 30, 40, 50});
+
+    // deliver 4 to 1 and 5 to 2, which makes the trip drive back
+    const std::vector<Precedence> precedences = {{4, 1}, {5, 2}};
+    const auto trip =
+        ConstrainedTrip(6, table, 0, SPECIAL_NODEID, false, precedences, UNLIMITED, SEARCH_TIME);
+
+    BOOST_REQUIRE_EQUAL(trip.size(), 6);
+    BOOST_CHECK_EQUAL(trip.front(), 0);
+    BOOST_CHECK_LT(position(trip, 4), position(trip, 1));
+    BOOST_CHECK_LT(position(trip, 5), position(trip, 2));
+
+    // the end is visited last even if that is longer
+    const auto fixed_end =
+        ConstrainedTrip(6, table, 0, 3, false, precedences, UNLIMITED, SEARCH_TIME);
+    BOOST_REQUIRE_EQUAL(fixed_end.size(), 6);
+    BOOST_CHECK_EQUAL(fixed_end.back(), 3);
+    BOOST_CHECK_LT(position(fixed_end, 4), position(fixed_end, 1));
+    BOOST_CHECK_LT(position(fixed_end, 5), position(fixed_end, 2));
+}
+
+BOOST_AUTO_TEST_CASE(infeasible)
+{
+    const auto table = makeTable({0, 10, 20, 30});
+
+    // cyclic precedences
+    const std::vector<Precedence> cycle = {{1, 2}, {2, 3}, {3, 1}};
+    BOOST_CHECK(
+        ConstrainedTrip(4, table, 0, SPECIAL_NODEID, true, cycle, UNLIMITED, SEARCH_TIME).empty());
+    // deliveries at the start and pickups at the end
+    BOOST_CHECK(ConstrainedTrip(4, table, 0, SPECIAL_NODEID, true, {{1, 0}}, UNLIMITED, SEARCH_TIME)
+                    .empty());
+    BOOST_CHECK(ConstrainedTrip(4, table, 0, 3, false, {{3, 1}}, UNLIMITED, SEARCH_TIME).empty());
+
+    // the shortest roundtrip takes 30 + 60
+    BOOST_CHECK_EQUAL(
+        ConstrainedTrip(4, table, 0, SPECIAL_NODEID, true, {}, 90, SEARCH_TIME).size(), 4);
+    BOOST_CHECK(ConstrainedTrip(4, table, 0, SPECIAL_NODEID, true, {}, 89, SEARCH_TIME).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
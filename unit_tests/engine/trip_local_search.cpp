@@ -0,0 +1,95 @@
+#include "engine/trip/trip_local_search.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(trip_local_search)
+
+using namespace osrm;
+using namespace osrm::engine::trip;
+
+namespace
+{
+util::DistTableWrapper<EdgeWeight> makeTable(const std::vector<std::pair<int, int>> &locations)
+{
+    std::vector<EdgeWeight> table;
+    for (const auto &from : locations)
+    {
+        for (const auto &to : locations)
+        {
+            table.push_back(std::abs(from.first - to.first) + std::abs(from.second - to.second));
+        }
+    }
+    return util::DistTableWrapper<EdgeWeight>(std::move(table), locations.size());
+}
+
+EdgeWeight tripDuration(const std::vector<NodeID> &trip,
+                        const util::DistTableWrapper<EdgeWeight> &table)
+{
+    EdgeWeight duration = 0;
+    for (std::size_t position = 0; position < trip.size(); ++position)
+    {
+        duration += table(trip[position], trip[(position + 1) % trip.size()]);
+    }
+    return duration;
+}
+}
+
+BOOST_AUTO_TEST_CASE(uncross_square)
+{
+    // corners and edge midpoints of a square, visited in a crossing order
+    const auto table = makeTable({{0, 0}, {1, 0}, {2, 0}, {2, 1}, {2, 2}, {1, 2}, {0, 2}, {0, 1}});
+    const std::vector<NodeID> crossing = {0, 4, 1, 5, 2, 6, 3, 7};
+
+    const auto trip = LocalSearchTrip(crossing, table, std::chrono::seconds(1));
+
+    BOOST_CHECK_EQUAL(tripDuration(trip, table), 8);
+    auto sorted = trip;
+    std::sort(sorted.begin(), sorted.end());
+    const std::vector<NodeID> all = {0, 1, 2, 3, 4, 5, 6, 7};
+    BOOST_CHECK_EQUAL_COLLECTIONS(sorted.begin(), sorted.end(), all.begin(), all.end());
+
+    // without search time the trip is returned unchanged
+    const auto unchanged = LocalSearchTrip(crossing, table, std::chrono::milliseconds(0));
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        unchanged.begin(), unchanged.end(), crossing.begin(), crossing.end());
+}
+
+BOOST_AUTO_TEST_CASE(keep_invalid_edges_out)
+{
+    std::mt19937 g(42);
+    std::uniform_int_distribution<int> coordinate(0, 100);
+    std::vector<std::pair<int, int>> locations;
+    for (int location = 0; location < 30; ++location)
+    {
+        locations.emplace_back(coordinate(g), coordinate(g));
+    }
+    auto table = makeTable(locations);
+
+    // like a trip with fixed start 0 and end 29: the end can only return to the start
+    for (NodeID location = 1; location < 30; ++location)
+    {
+        table.SetValue(location, 0, INVALID_EDGE_WEIGHT);
+        table.SetValue(29, location - 1, INVALID_EDGE_WEIGHT);
+    }
+    table.SetValue(29, 0, 0);
+
+    std::vector<NodeID> start(30);
+    std::iota(start.begin(), start.end(), 0);
+    std::shuffle(start.begin() + 1, start.end() - 1, g);
+
+    const auto trip = LocalSearchTrip(start, table, std::chrono::seconds(1));
+
+    BOOST_CHECK_LE(tripDuration(trip, table), tripDuration(start, table));
+    const auto end = std::find(trip.begin(), trip.end(), 29);
+    BOOST_REQUIRE(end != trip.end());
+    BOOST_CHECK_EQUAL(std::next(end) == trip.end() ? trip.front() : *std::next(end), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+#include "extractor/files.hpp"
+#include "extractor/road_overview.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(road_overview)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+RoadOverview::Point makePoint(const double lon,
+                              const double lat,
+                              const float distance,
+                              const std::uint32_t position,
+                              const std::uint8_t min_zoom)
+{
+    return RoadOverview::Point{
+        util::Coordinate{util::FloatLongitude{lon}, util::FloatLatitude{lat}},
+        distance,
+        position,
+        min_zoom};
+}
+
+// Lines in tile 512,338 of zoom level 10 and in tile 514,338 next to it
+RoadOverview makeOverview()
+{
+    RoadOverview overview("2017-10-01");
+    overview.AddLine(7,
+                     true,
+                     false,
+                     {makePoint(0.01, 52.01, 0, 0, 8),
+                      makePoint(0.02, 52.02, 100, 3, 11),
+                      makePoint(0.03, 52.03, 200, 5, 8)});
+    overview.AddLine(
+        3, true, true, {makePoint(1.01, 52.01, 0, 0, 8), makePoint(1.02, 52.02, 150, 1, 8)});
+    // crosses the border of both tiles
+    overview.AddLine(
+        5, true, true, {makePoint(0.3, 52.01, 0, 0, 8), makePoint(0.4, 52.02, 500, 8, 8)});
+    overview.BuildIndex();
+    return overview;
+}
+}
+
+BOOST_AUTO_TEST_CASE(get_lines)
+{
+    const auto overview = makeOverview();
+    BOOST_CHECK_EQUAL(overview.GetNumberOfLines(), 3);
+    BOOST_CHECK_EQUAL(overview.GetPoints(0).size(), 3);
+    BOOST_CHECK_EQUAL(overview.GetPoints(2).size(), 2);
+
+    using Lines = std::vector<std::uint32_t>;
+    const auto check_lines = [&](const unsigned x, const unsigned y, const unsigned z, Lines ref) {
+        const auto lines = overview.GetLines(x, y, z);
+        BOOST_CHECK_EQUAL_COLLECTIONS(lines.begin(), lines.end(), ref.begin(), ref.end());
+    };
+
+    check_lines(512, 338, 10, {0, 2});
+    check_lines(513, 338, 10, {2});
+    check_lines(514, 338, 10, {1});
+    check_lines(512, 339, 10, {});
+    // lines that are in several cells are listed once
+    check_lines(128, 84, 8, {0, 1, 2});
+    check_lines(129, 84, 8, {});
+    // tiles of higher zoom levels get all lines of their cell
+    check_lines(1024, 676, 11, {0, 2});
+    check_lines(1029, 676, 11, {1});
+}
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+    const auto path =
+        boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    files::writeRoadOverview(path, makeOverview());
+
+    RoadOverview overview;
+    files::readRoadOverview(path, overview);
+    boost::filesystem::remove(path);
+
+    BOOST_CHECK_EQUAL(overview.GetTimestamp(), "2017-10-01");
+    BOOST_REQUIRE_EQUAL(overview.GetNumberOfLines(), 3);
+    BOOST_CHECK_EQUAL(overview.GetLine(1).geometry_id, 3);
+    BOOST_CHECK(!overview.GetLine(0).reverse_enabled);
+
+    const auto points = overview.GetPoints(0);
+    BOOST_REQUIRE_EQUAL(points.size(), 3);
+    BOOST_CHECK_EQUAL(points[1].position, 3);
+    BOOST_CHECK_EQUAL(points[1].min_zoom, 11);
+    BOOST_CHECK_EQUAL(points[2].distance, 200);
+
+    const auto lines = overview.GetLines(128, 84, 8);
+    BOOST_CHECK_EQUAL(lines.size(), 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -13,6 +13,9 @@
 #include "osrm/osrm.hpp"
 #include "osrm/status.hpp"
 
+#include <algorithm>
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(match)
 
 BOOST_AUTO_TEST_CASE(test_match)
@@ -64,4 +67,266 @@ BOOST_AUTO_TEST_CASE(test_match)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_match_batch)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    MatchParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+
+    json::Object expected;
+    const auto expected_rc = osrm.Match(params, expected);
+
+    std::vector<MatchParameters> batch(16, params);
+    std::vector<int> seen(batch.size(), 0);
+
+    osrm.Match(batch, [&](const std::size_t index, const Status rc, json::Object &result) {
+        BOOST_REQUIRE_LT(index, batch.size());
+        seen[index]++;
+
+        BOOST_CHECK(rc == expected_rc);
+        BOOST_CHECK_EQUAL(result.values.at("code").get<json::String>().value,
+                          expected.values.at("code").get<json::String>().value);
+        BOOST_CHECK_EQUAL(result.values.at("tracepoints").get<json::Array>().values.size(),
+                          params.coordinates.size());
+    });
+
+    for (const auto count : seen)
+    {
+        BOOST_CHECK_EQUAL(count, 1);
+    }
+}
+
+namespace
+{
+// A trace along the street of the other match tests, one point per second
+std::vector<osrm::util::Coordinate> getLiveTrace()
+{
+    using namespace osrm;
+
+    const std::vector<std::pair<double, double>> waypoints = {
+        {7.41337, 43.72956}, {7.41546, 43.73077}, {7.41862, 43.73216}};
+    std::vector<util::Coordinate> trace;
+    for (std::size_t leg = 0; leg + 1 < waypoints.size(); ++leg)
+    {
+        for (int step = 0; step < 4; ++step)
+        {
+            const auto ratio = step / 4.;
+            trace.push_back(
+                {util::FloatLongitude{waypoints[leg].first * (1 - ratio) +
+                                      waypoints[leg + 1].first * ratio},
+                 util::FloatLatitude{waypoints[leg].second * (1 - ratio) +
+                                     waypoints[leg + 1].second * ratio}});
+        }
+    }
+    trace.push_back({util::FloatLongitude{waypoints.back().first},
+                     util::FloatLatitude{waypoints.back().second}});
+    return trace;
+}
+
+const osrm::json::Array &getLocation(const osrm::json::Value &tracepoint)
+{
+    return tracepoint.get<osrm::json::Object>().values.at("location").get<osrm::json::Array>();
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_match_live_trace)
+{
+    using namespace osrm;
+
+    // finalise the window after a few points to see every step within one short trace
+    const std::size_t max_points = 5;
+    EngineConfig config;
+    config.storage_config = {OSRM_TEST_DATA_DIR "/ch/monaco.osrm"};
+    config.use_shared_memory = false;
+    config.max_locations_map_matching = max_points;
+    const OSRM osrm{config};
+
+    const auto trace = getLiveTrace();
+
+    MatchParameters params;
+    params.vehicle = "test-vehicle";
+
+    std::size_t finalised = 0;
+    bool has_anchor = false;
+    json::Array anchor_location;
+    for (std::size_t index = 0; index < trace.size(); ++index)
+    {
+        params.coordinates = {trace[index]};
+        params.timestamps = {1424684612 + static_cast<unsigned>(index)};
+
+        json::Object result;
+        const auto rc = osrm.Match(params, result);
+        BOOST_REQUIRE(rc == Status::Ok);
+        BOOST_CHECK_EQUAL(result.values.at("code").get<json::String>().value, "Ok");
+
+        const auto &tracepoints = result.values.at("tracepoints").get<json::Array>().values;
+        if (index == 0)
+        {
+            // a single point can not be matched yet
+            BOOST_CHECK(tracepoints.empty());
+        }
+        if (tracepoints.empty())
+        {
+            continue;
+        }
+
+        // consecutive responses connect at the last finalised point of the previous one
+        if (has_anchor)
+        {
+            BOOST_REQUIRE(tracepoints.front().is<util::json::Object>() ==
+                          !anchor_location.values.empty());
+            if (!anchor_location.values.empty())
+            {
+                const auto &location = getLocation(tracepoints.front());
+                BOOST_CHECK_EQUAL(location.values[0].get<json::Number>().value,
+                                  anchor_location.values[0].get<json::Number>().value);
+                BOOST_CHECK_EQUAL(location.values[1].get<json::Number>().value,
+                                  anchor_location.values[1].get<json::Number>().value);
+            }
+        }
+        finalised += tracepoints.size() - (has_anchor ? 1 : 0);
+
+        has_anchor = true;
+        anchor_location = tracepoints.back().is<util::json::Object>()
+                              ? getLocation(tracepoints.back())
+                              : json::Array{};
+
+        // points are finalised in order and never ahead of the request
+        BOOST_CHECK_LE(finalised, index + 1);
+    }
+
+    // a full window is finalised, so only the last few points can still be pending
+    BOOST_CHECK_GT(finalised, 0);
+    BOOST_CHECK_LT(trace.size() - finalised, max_points);
+}
+
+BOOST_AUTO_TEST_CASE(test_match_live_trace_batch)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    const auto trace = getLiveTrace();
+
+    // all points of one vehicle in one batch need to be appended in input order, otherwise
+    // the timestamps of later requests would go backwards
+    std::vector<MatchParameters> batch(trace.size());
+    for (std::size_t index = 0; index < trace.size(); ++index)
+    {
+        batch[index].vehicle = "test-batch-vehicle";
+        batch[index].coordinates = {trace[index]};
+        batch[index].timestamps = {1424684612 + static_cast<unsigned>(index)};
+    }
+
+    std::vector<std::size_t> order;
+    osrm.Match(batch, [&](const std::size_t index, const Status rc, json::Object &result) {
+        order.push_back(index);
+        BOOST_CHECK(rc == Status::Ok);
+        BOOST_CHECK_EQUAL(result.values.at("code").get<json::String>().value, "Ok");
+    });
+
+    BOOST_REQUIRE_EQUAL(order.size(), trace.size());
+    for (std::size_t index = 0; index < order.size(); ++index)
+    {
+        BOOST_CHECK_EQUAL(order[index], index);
+    }
+}
+
+// The compact response lists the annotated nodes of all legs. Consecutive legs share the nodes of
+// the segment of their trace point, two of them if the matching goes on in the same direction and
+// one after a U-turn, so every leg has to start exactly one or two nodes before the end of the
+// previous ones.
+BOOST_AUTO_TEST_CASE(test_match_compact_nodes)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    MatchParameters params;
+    params.coordinates = getLiveTrace();
+    for (std::size_t index = 0; index < params.coordinates.size(); ++index)
+    {
+        params.timestamps.push_back(1424684612 + static_cast<unsigned>(index));
+    }
+    params.annotations_type = RouteParameters::AnnotationsType::Nodes;
+
+    json::Object full_result;
+    BOOST_REQUIRE(osrm.Match(params, full_result) == Status::Ok);
+
+    params.geometries = RouteParameters::GeometriesType::None;
+    json::Object compact_result;
+    BOOST_REQUIRE(osrm.Match(params, compact_result) == Status::Ok);
+
+    const auto &full_matchings = full_result.values.at("matchings").get<json::Array>().values;
+    const auto &compact_matchings =
+        compact_result.values.at("matchings").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(compact_matchings.size(), full_matchings.size());
+    BOOST_REQUIRE(!compact_matchings.empty());
+
+    std::size_t boundaries = 0;
+    for (std::size_t index = 0; index < full_matchings.size(); ++index)
+    {
+        const auto &compact = compact_matchings[index].get<json::Object>();
+        BOOST_CHECK_EQUAL(compact.values.count("legs"), 0);
+        BOOST_CHECK_EQUAL(compact.values.count("geometry"), 0);
+        BOOST_CHECK_EQUAL(compact.values.at("confidence").get<json::Number>().value,
+                          full_matchings[index]
+                              .get<json::Object>()
+                              .values.at("confidence")
+                              .get<json::Number>()
+                              .value);
+
+        const auto &compact_nodes = compact.values.at("nodes").get<json::Array>().values;
+        std::vector<double> nodes;
+        for (const auto &node : compact_nodes)
+        {
+            nodes.push_back(node.get<json::Number>().value);
+        }
+
+        const auto &legs =
+            full_matchings[index].get<json::Object>().values.at("legs").get<json::Array>().values;
+        std::size_t end = 0;
+        for (const auto &leg : legs)
+        {
+            const auto &annotated_nodes = leg.get<json::Object>()
+                                              .values.at("annotation")
+                                              .get<json::Object>()
+                                              .values.at("nodes")
+                                              .get<json::Array>()
+                                              .values;
+            std::vector<double> leg_nodes;
+            for (const auto &node : annotated_nodes)
+            {
+                leg_nodes.push_back(node.get<json::Number>().value);
+            }
+            BOOST_REQUIRE_GE(leg_nodes.size(), 2);
+
+            const auto starts_at = [&](const std::size_t begin) {
+                return begin + leg_nodes.size() <= nodes.size() &&
+                       std::equal(leg_nodes.begin(), leg_nodes.end(), nodes.begin() + begin);
+            };
+            if (end == 0)
+            {
+                BOOST_REQUIRE(starts_at(0));
+            }
+            else
+            {
+                const auto same_direction = starts_at(end - 2);
+                const auto u_turn = starts_at(end - 1);
+                BOOST_REQUIRE(same_direction != u_turn);
+                end -= same_direction ? 2 : 1;
+                ++boundaries;
+            }
+            end += leg_nodes.size();
+        }
+        BOOST_CHECK_EQUAL(end, nodes.size());
+    }
+    BOOST_CHECK_GT(boundaries, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
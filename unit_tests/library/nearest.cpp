@@ -12,6 +12,11 @@
 #include "osrm/osrm.hpp"
 #include "osrm/status.hpp"
 
+#include "util/hilbert_value.hpp"
+
+#include <algorithm>
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(nearest)
 
 BOOST_AUTO_TEST_CASE(test_nearest_response)
@@ -113,4 +118,133 @@ BOOST_AUTO_TEST_CASE(test_nearest_response_for_location_in_small_component)
     }
 }
 
+namespace
+{
+// Returns the compact batch entries, one per coordinate
+std::vector<osrm::json::Value> getBatchWaypoints(const osrm::OSRM &osrm,
+                                                 const osrm::NearestParameters &params)
+{
+    using namespace osrm;
+
+    json::Object result;
+    const auto rc = osrm.Nearest(params, result);
+    BOOST_REQUIRE(rc == Status::Ok);
+    BOOST_CHECK_EQUAL(result.values.at("code").get<json::String>().value, "Ok");
+
+    const auto &waypoints = result.values.at("waypoints").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(waypoints.size(), params.coordinates.size());
+    return waypoints;
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_nearest_batch_response_order)
+{
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    using namespace osrm;
+
+    // a grid over Monaco in a scrambled order, the batch is snapped in Hilbert order
+    NearestParameters params;
+    params.batch = true;
+    params.number_of_results = 2;
+    for (int index = 0; index < 25; ++index)
+    {
+        const auto cell = (index * 7) % 25;
+        params.coordinates.push_back(
+            {Longitude{7.4150 + (cell % 5) * 0.003}, Latitude{43.7300 + (cell / 5) * 0.003}});
+    }
+    std::vector<std::uint64_t> hilbert_codes;
+    for (const auto &coordinate : params.coordinates)
+    {
+        hilbert_codes.push_back(util::GetHilbertCode(coordinate));
+    }
+    BOOST_REQUIRE(!std::is_sorted(hilbert_codes.begin(), hilbert_codes.end()));
+
+    const auto waypoints = getBatchWaypoints(osrm, params);
+
+    // every entry belongs to the coordinate at its position
+    for (std::size_t index = 0; index < params.coordinates.size(); ++index)
+    {
+        NearestParameters single_params;
+        single_params.coordinates.push_back(params.coordinates[index]);
+        single_params.number_of_results = 2;
+
+        json::Object single_result;
+        BOOST_REQUIRE(osrm.Nearest(single_params, single_result) == Status::Ok);
+        const auto &expected = single_result.values.at("waypoints").get<json::Array>().values;
+
+        const auto &candidates = waypoints[index].get<json::Array>().values;
+        BOOST_REQUIRE_EQUAL(candidates.size(), expected.size());
+        for (std::size_t candidate = 0; candidate < candidates.size(); ++candidate)
+        {
+            // [longitude, latitude, distance, from node, to node]
+            const auto &compact = candidates[candidate].get<json::Array>().values;
+            BOOST_REQUIRE_EQUAL(compact.size(), 5);
+
+            const auto &waypoint = expected[candidate].get<json::Object>().values;
+            const auto &location = waypoint.at("location").get<json::Array>().values;
+            const auto &nodes = waypoint.at("nodes").get<json::Array>().values;
+            BOOST_CHECK_CLOSE(compact[0].get<json::Number>().value,
+                              location[0].get<json::Number>().value,
+                              1e-4);
+            BOOST_CHECK_CLOSE(compact[1].get<json::Number>().value,
+                              location[1].get<json::Number>().value,
+                              1e-4);
+            BOOST_CHECK_CLOSE(compact[2].get<json::Number>().value,
+                              waypoint.at("distance").get<json::Number>().value,
+                              1e-4);
+            BOOST_CHECK_EQUAL(compact[3].get<json::Number>().value,
+                              nodes[0].get<json::Number>().value);
+            BOOST_CHECK_EQUAL(compact[4].get<json::Number>().value,
+                              nodes[1].get<json::Number>().value);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_nearest_batch_unsnappable_coordinates)
+{
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    using namespace osrm;
+
+    // the second coordinate is far away from any road within its radius
+    NearestParameters params;
+    params.batch = true;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back({Longitude{0}, Latitude{0}});
+    params.coordinates.push_back(get_locations_in_big_component().at(0));
+    params.radiuses = {boost::none, 10., boost::none};
+
+    const auto waypoints = getBatchWaypoints(osrm, params);
+    BOOST_CHECK(!waypoints[0].get<json::Array>().values.empty());
+    BOOST_CHECK(waypoints[1].is<json::Null>());
+    BOOST_CHECK(!waypoints[2].get<json::Array>().values.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_nearest_batch_limits)
+{
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {OSRM_TEST_DATA_DIR "/ch/monaco.osrm"};
+    config.use_shared_memory = false;
+    config.max_locations_nearest = 2;
+
+    OSRM osrm{config};
+
+    NearestParameters params;
+    params.batch = true;
+    params.coordinates = get_locations_in_big_component();
+
+    json::Object result;
+    const auto rc = osrm.Nearest(params, result);
+    BOOST_CHECK(rc == Status::Error);
+    BOOST_CHECK_EQUAL(result.values.at("code").get<json::String>().value, "TooBig");
+
+    // within the limit
+    params.coordinates.pop_back();
+    result = json::Object();
+    BOOST_CHECK(osrm.Nearest(params, result) == Status::Ok);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,145 @@
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "coordinates.hpp"
+
+#include "engine/api/base_parameters.hpp"
+#include "engine/datafacade_provider.hpp"
+#include "engine/routing_algorithms/routing_base_ch.hpp"
+#include "engine/routing_algorithms/routing_base_mld.hpp"
+#include "engine/search_engine_data.hpp"
+#include "storage/storage_config.hpp"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(network_distances)
+
+using namespace osrm;
+
+namespace
+{
+
+// Candidates for a dense grid and for points along a street. Snapping the street points yields
+// several candidates on the same segment, so some targets lie behind their source on one node.
+template <typename Facade> std::vector<engine::PhantomNode> getPhantomNodes(const Facade &facade)
+{
+    Locations locations;
+    for (int x = 0; x < 6; ++x)
+    {
+        for (int y = 0; y < 6; ++y)
+        {
+            locations.push_back({Longitude{7.4150 + x * 0.0008}, Latitude{43.7330 + y * 0.0008}});
+        }
+    }
+    const auto street = get_locations_in_big_component();
+    const auto from_lon = static_cast<double>(toFloating(street[0].lon));
+    const auto from_lat = static_cast<double>(toFloating(street[0].lat));
+    const auto to_lon = static_cast<double>(toFloating(street[1].lon));
+    const auto to_lat = static_cast<double>(toFloating(street[1].lat));
+    for (int step = 0; step <= 10; ++step)
+    {
+        const auto ratio = step / 10.;
+        locations.push_back({Longitude{from_lon + (to_lon - from_lon) * ratio},
+                             Latitude{from_lat + (to_lat - from_lat) * ratio}});
+    }
+
+    std::vector<engine::PhantomNode> phantoms;
+    for (const auto &location : locations)
+    {
+        for (const auto &candidate :
+             facade.NearestPhantomNodes(location, 2, 50., engine::Approach::UNRESTRICTED))
+        {
+            phantoms.push_back(candidate.phantom_node);
+        }
+    }
+    return phantoms;
+}
+
+// Pairs that can only be connected by leaving the source node and coming back to it
+std::size_t countLoops(const std::vector<engine::PhantomNode> &phantoms)
+{
+    std::size_t loops = 0;
+    for (const auto &source : phantoms)
+    {
+        for (const auto &target : phantoms)
+        {
+            if (source.IsValidForwardSource() && target.IsValidForwardTarget() &&
+                source.forward_segment_id.id == target.forward_segment_id.id &&
+                target.GetForwardWeightPlusOffset() < source.GetForwardWeightPlusOffset())
+            {
+                ++loops;
+            }
+        }
+    }
+    return loops;
+}
+
+template <typename Algorithm> void testNetworkDistances(const std::string &base_path)
+{
+    using namespace engine::routing_algorithms;
+
+    const engine::ImmutableProvider<Algorithm> provider{storage::StorageConfig{base_path}};
+    const auto facade = provider.Get(engine::api::BaseParameters{});
+
+    const auto phantoms = getPhantomNodes(*facade);
+    BOOST_REQUIRE(!phantoms.empty());
+    BOOST_CHECK_GT(countLoops(phantoms), 0);
+
+    engine::SearchEngineData<Algorithm> engine_working_data;
+    engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade->GetNumberOfNodes());
+    auto &forward_heap = *engine_working_data.forward_heap_1;
+    auto &reverse_heap = *engine_working_data.reverse_heap_1;
+
+    // Without a bound and with one that prunes part of the pairs, as map matching does
+    for (const auto weight_upper_bound : {INVALID_EDGE_WEIGHT, EdgeWeight{600}})
+    {
+        const auto distances = getNetworkDistances(engine_working_data,
+                                                   *facade,
+                                                   forward_heap,
+                                                   reverse_heap,
+                                                   phantoms,
+                                                   phantoms,
+                                                   weight_upper_bound);
+        BOOST_REQUIRE_EQUAL(distances.size(), phantoms.size() * phantoms.size());
+
+        for (std::size_t row = 0; row < phantoms.size(); ++row)
+        {
+            for (std::size_t column = 0; column < phantoms.size(); ++column)
+            {
+                const auto expected = getNetworkDistance(engine_working_data,
+                                                         *facade,
+                                                         forward_heap,
+                                                         reverse_heap,
+                                                         phantoms[row],
+                                                         phantoms[column],
+                                                         weight_upper_bound);
+                const auto actual = distances[row * phantoms.size() + column];
+                if (expected == std::numeric_limits<double>::max())
+                {
+                    BOOST_CHECK_EQUAL(actual, expected);
+                }
+                else
+                {
+                    BOOST_CHECK_CLOSE(actual, expected, 1e-6);
+                }
+            }
+        }
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_one_to_many_matches_pairwise_ch)
+{
+    testNetworkDistances<engine::routing_algorithms::ch::Algorithm>(OSRM_TEST_DATA_DIR
+                                                                    "/ch/monaco.osrm");
+}
+
+BOOST_AUTO_TEST_CASE(test_one_to_many_matches_pairwise_mld)
+{
+    testNetworkDistances<engine::routing_algorithms::mld::Algorithm>(OSRM_TEST_DATA_DIR
+                                                                     "/mld/monaco.osrm");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,87 @@
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "coordinates.hpp"
+
+#include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
+#include "engine/datafacade/process_memory_allocator.hpp"
+#include "engine/routing_algorithms/routing_base_ch.hpp"
+#include "engine/routing_algorithms/routing_base_mld.hpp"
+#include "storage/storage_config.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(rtree_leaves)
+
+using namespace osrm;
+
+namespace
+{
+
+void checkEqual(const std::vector<engine::PhantomNodeWithDistance> &mapped,
+                const std::vector<engine::PhantomNodeWithDistance> &embedded)
+{
+    BOOST_REQUIRE_EQUAL(mapped.size(), embedded.size());
+    for (std::size_t index = 0; index < mapped.size(); ++index)
+    {
+        BOOST_CHECK_EQUAL(mapped[index].phantom_node.forward_segment_id.id,
+                          embedded[index].phantom_node.forward_segment_id.id);
+        BOOST_CHECK_EQUAL(mapped[index].phantom_node.reverse_segment_id.id,
+                          embedded[index].phantom_node.reverse_segment_id.id);
+        BOOST_CHECK_EQUAL(mapped[index].phantom_node.location,
+                          embedded[index].phantom_node.location);
+    }
+}
+
+// The leaves loaded into the data block by osrm-datastore --embed-rtree-leaves have to answer
+// the same as the ones mapped from the .fileIndex
+template <typename Algorithm> void testEmbeddedLeaves(const std::string &base_path)
+{
+    using Facade = engine::datafacade::ContiguousInternalMemoryDataFacade<Algorithm>;
+    using engine::datafacade::ProcessMemoryAllocator;
+
+    const storage::StorageConfig config{base_path};
+    const auto mapped_allocator = std::make_shared<ProcessMemoryAllocator>(config);
+    const auto embedded_allocator = std::make_shared<ProcessMemoryAllocator>(config, true);
+    BOOST_CHECK_EQUAL(
+        mapped_allocator->GetLayout().num_entries[storage::DataLayout::R_SEARCH_TREE_LEAVES], 0);
+    BOOST_CHECK_GT(
+        embedded_allocator->GetLayout().num_entries[storage::DataLayout::R_SEARCH_TREE_LEAVES],
+        0);
+
+    const Facade mapped{mapped_allocator, 0};
+    const Facade embedded{embedded_allocator, 0};
+
+    // a grid over Monaco, some of the points are in the sea
+    for (int x = 0; x < 10; ++x)
+    {
+        for (int y = 0; y < 10; ++y)
+        {
+            const util::Coordinate location{Longitude{7.4100 + x * 0.0015},
+                                            Latitude{43.7250 + y * 0.0015}};
+            checkEqual(mapped.NearestPhantomNodes(location, 5, engine::Approach::UNRESTRICTED),
+                       embedded.NearestPhantomNodes(location, 5, engine::Approach::UNRESTRICTED));
+            checkEqual(
+                mapped.NearestPhantomNodesInRange(location, 100., engine::Approach::UNRESTRICTED),
+                embedded.NearestPhantomNodesInRange(
+                    location, 100., engine::Approach::UNRESTRICTED));
+        }
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_embedded_leaves_ch)
+{
+    testEmbeddedLeaves<engine::routing_algorithms::ch::Algorithm>(OSRM_TEST_DATA_DIR
+                                                                  "/ch/monaco.osrm");
+}
+
+BOOST_AUTO_TEST_CASE(test_embedded_leaves_mld)
+{
+    testEmbeddedLeaves<engine::routing_algorithms::mld::Algorithm>(OSRM_TEST_DATA_DIR
+                                                                   "/mld/monaco.osrm");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
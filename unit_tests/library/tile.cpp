@@ -317,6 +317,89 @@ BOOST_AUTO_TEST_CASE(test_tile_mld)
     validate_tile(osrm);
 }
 
+// Monaco is extracted without --road-overview, so tiles that only show it can not be rendered
+void test_tile_overview_missing(const osrm::OSRM &osrm)
+{
+    using namespace osrm;
+
+    for (const unsigned z : {8, 11})
+    {
+        TileParameters params{17059u >> (15 - z), 11948u >> (15 - z), z};
+
+        std::string result;
+        const auto rc = osrm.Tile(params, result);
+        BOOST_CHECK(rc == Status::Error);
+        BOOST_CHECK(result.find("road overview") != std::string::npos);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_tile_overview_missing_ch)
+{
+    using namespace osrm;
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm", osrm::EngineConfig::Algorithm::CH);
+    test_tile_overview_missing(osrm);
+}
+
+BOOST_AUTO_TEST_CASE(test_tile_overview_missing_mld)
+{
+    using namespace osrm;
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/mld/monaco.osrm", osrm::EngineConfig::Algorithm::MLD);
+    test_tile_overview_missing(osrm);
+}
+
+// Only tiles of z>=15 have a turns layer, the other layers are in every tile
+void test_tile_layers(const osrm::OSRM &osrm)
+{
+    using namespace osrm;
+
+    for (const unsigned z : {12, 13, 14, 15})
+    {
+        // the tiles of validate_tile and the tiles containing it
+        TileParameters params{17059u >> (15 - z), 11948u >> (15 - z), z};
+
+        std::string result;
+        const auto rc = osrm.Tile(params, result);
+        BOOST_CHECK(rc == Status::Ok);
+
+        std::vector<std::string> layer_names;
+        protozero::pbf_reader tile_message(result);
+        while (tile_message.next(util::vector_tile::LAYER_TAG))
+        {
+            protozero::pbf_reader layer_message = tile_message.get_message();
+            while (layer_message.next())
+            {
+                switch (layer_message.tag())
+                {
+                case util::vector_tile::NAME_TAG:
+                    layer_names.push_back(layer_message.get_string());
+                    break;
+                default:
+                    layer_message.skip();
+                }
+            }
+        }
+
+        const auto expected_layer_names =
+            z < 15 ? std::vector<std::string>{"speeds", "osmnodes"}
+                   : std::vector<std::string>{"speeds", "turns", "osmnodes"};
+        CHECK_EQUAL_RANGE(layer_names, expected_layer_names);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_tile_layers_ch)
+{
+    using namespace osrm;
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm", osrm::EngineConfig::Algorithm::CH);
+    test_tile_layers(osrm);
+}
+
+BOOST_AUTO_TEST_CASE(test_tile_layers_mld)
+{
+    using namespace osrm;
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/mld/monaco.osrm", osrm::EngineConfig::Algorithm::MLD);
+    test_tile_layers(osrm);
+}
+
 void test_tile_turns(const osrm::OSRM &osrm)
 {
     using namespace osrm;
@@ -0,0 +1,137 @@
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "coordinates.hpp"
+
+#include "engine/api/base_parameters.hpp"
+#include "engine/datafacade_provider.hpp"
+#include "engine/map_matching/transition_cache.hpp"
+#include "engine/routing_algorithms/routing_base_ch.hpp"
+#include "engine/routing_algorithms/routing_base_mld.hpp"
+#include "engine/search_engine_data.hpp"
+#include "storage/storage_config.hpp"
+#include "util/coordinate_calculation.hpp"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(transition_cache)
+
+using namespace osrm;
+
+namespace
+{
+
+// Compares the transitions of a trace of a vehicle that stands at every point for five samples
+// with the same transitions searched without the cache, the way map matching asks for them
+template <typename Algorithm> void testTransitionCache(const std::string &base_path)
+{
+    using namespace engine::routing_algorithms;
+
+    const engine::ImmutableProvider<Algorithm> provider{storage::StorageConfig{base_path}};
+    const auto facade = provider.Get(engine::api::BaseParameters{});
+
+    const auto street = get_locations_in_big_component();
+    const auto from_lon = static_cast<double>(toFloating(street[0].lon));
+    const auto from_lat = static_cast<double>(toFloating(street[0].lat));
+    const auto to_lon = static_cast<double>(toFloating(street[1].lon));
+    const auto to_lat = static_cast<double>(toFloating(street[1].lat));
+
+    Locations trace;
+    std::vector<std::vector<engine::PhantomNode>> candidates;
+    for (int step = 0; step <= 5; ++step)
+    {
+        const auto ratio = step / 5.;
+        const util::Coordinate location{Longitude{from_lon + (to_lon - from_lon) * ratio},
+                                        Latitude{from_lat + (to_lat - from_lat) * ratio}};
+
+        std::vector<engine::PhantomNode> phantoms;
+        for (const auto &candidate :
+             facade->NearestPhantomNodes(location, 3, 50., engine::Approach::UNRESTRICTED))
+        {
+            phantoms.push_back(candidate.phantom_node);
+        }
+        BOOST_REQUIRE(!phantoms.empty());
+
+        for (int sample = 0; sample < 5; ++sample)
+        {
+            trace.push_back(location);
+            candidates.push_back(phantoms);
+        }
+    }
+
+    engine::SearchEngineData<Algorithm> engine_working_data;
+    engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade->GetNumberOfNodes());
+    auto &forward_heap = *engine_working_data.forward_heap_1;
+    auto &reverse_heap = *engine_working_data.reverse_heap_1;
+
+    engine::map_matching::TransitionCache cache;
+    std::size_t lookups = 0;
+    std::size_t repeated_transitions = 0;
+    for (std::size_t t = 1; t < trace.size(); ++t)
+    {
+        // changing sample times give a smaller bound for the third sample at a point, it can
+        // only reuse the transitions that were out of reach with the larger bound before
+        const auto max_distance_delta = t % 5 == 2 ? 200. : 2000.;
+        const auto haversine_distance =
+            util::coordinate_calculation::haversineDistance(trace[t - 1], trace[t]);
+        const EdgeWeight weight_upper_bound =
+            ((haversine_distance + max_distance_delta) / 4.) * facade->GetWeightMultiplier();
+
+        const auto &sources = candidates[t - 1];
+        const auto &targets = candidates[t];
+        const auto expected = getNetworkDistances(engine_working_data,
+                                                  *facade,
+                                                  forward_heap,
+                                                  reverse_heap,
+                                                  sources,
+                                                  targets,
+                                                  weight_upper_bound);
+        const auto actual = cache.GetNetworkDistances(engine_working_data,
+                                                      *facade,
+                                                      forward_heap,
+                                                      reverse_heap,
+                                                      sources,
+                                                      targets,
+                                                      weight_upper_bound);
+        BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+        for (std::size_t index = 0; index < expected.size(); ++index)
+        {
+            if (expected[index] == std::numeric_limits<double>::max())
+            {
+                BOOST_CHECK_EQUAL(actual[index], expected[index]);
+            }
+            else
+            {
+                BOOST_CHECK_CLOSE(actual[index], expected[index], 1e-6);
+            }
+        }
+
+        lookups += sources.size() * targets.size();
+        // the fifth sample at a point repeats the transitions of the fourth with the same bound
+        if (t % 5 == 4)
+        {
+            repeated_transitions += sources.size() * targets.size();
+        }
+    }
+
+    BOOST_CHECK_EQUAL(cache.GetLookups(), lookups);
+    BOOST_CHECK_GE(cache.GetHits(), repeated_transitions);
+    BOOST_CHECK_LT(cache.GetHits(), lookups);
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_cached_transitions_ch)
+{
+    testTransitionCache<engine::routing_algorithms::ch::Algorithm>(OSRM_TEST_DATA_DIR
+                                                                   "/ch/monaco.osrm");
+}
+
+BOOST_AUTO_TEST_CASE(test_cached_transitions_mld)
+{
+    testTransitionCache<engine::routing_algorithms::mld::Algorithm>(OSRM_TEST_DATA_DIR
+                                                                    "/mld/monaco.osrm");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
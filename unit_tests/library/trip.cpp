@@ -261,6 +261,48 @@ void CheckOk(const osrm::OSRM &osrm, osrm::TripParameters &params)
     BOOST_CHECK_EQUAL(code, "Ok");
 }
 
+BOOST_AUTO_TEST_CASE(test_negative_max_duration)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+    const auto locations = get_locations_in_big_component();
+
+    TripParameters params;
+    params.coordinates = locations;
+    params.max_duration = -60.;
+
+    json::Object result;
+    const auto rc = osrm.Trip(params, result);
+    BOOST_CHECK(rc == Status::Error);
+    BOOST_CHECK_EQUAL(result.values.at("code").get<json::String>().value, "InvalidOptions");
+    BOOST_CHECK_EQUAL(result.values.at("message").get<json::String>().value,
+                      "Max. duration needs to be a non-negative number of seconds.");
+}
+
+BOOST_AUTO_TEST_CASE(test_invalid_precedences)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+    const auto locations = get_locations_in_big_component();
+
+    // library users do not pass through the service's validation
+    for (const auto precedence : {std::make_pair<std::size_t, std::size_t>(0, 3),
+                                  std::make_pair<std::size_t, std::size_t>(3, 0),
+                                  std::make_pair<std::size_t, std::size_t>(1, 1)})
+    {
+        TripParameters params;
+        ResetParams(locations, params);
+        params.precedences.push_back(precedence);
+
+        json::Object result;
+        const auto rc = osrm.Trip(params, result);
+        BOOST_CHECK(rc == Status::Error);
+        BOOST_CHECK_EQUAL(result.values.at("code").get<json::String>().value, "InvalidOptions");
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_tfse_illegal_parameters)
 {
     using namespace osrm;
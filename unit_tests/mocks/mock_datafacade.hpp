@@ -119,6 +119,15 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
         return {};
     }
 
+    std::vector<std::vector<engine::PhantomNodeWithDistance>>
+    NearestPhantomNodesInRange(const std::vector<util::Coordinate> &input_coordinates,
+                               const std::vector<double> & /*max_distances*/,
+                               const std::vector<engine::Approach> & /*approaches*/) const override
+    {
+        return std::vector<std::vector<engine::PhantomNodeWithDistance>>(
+            input_coordinates.size());
+    }
+
     std::vector<engine::PhantomNodeWithDistance>
     NearestPhantomNodes(const util::Coordinate /*input_coordinate*/,
                         const unsigned /*max_results*/,
@@ -218,6 +227,7 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
     StringView GetExitsForID(const NameID) const override final { return {}; }
 
     std::string GetTimestamp() const override { return ""; }
+    unsigned GetDatasetGeneration() const override { return 0; }
     bool GetContinueStraightDefault() const override { return true; }
     double GetMapMatchingMaxSpeed() const override { return 180 / 3.6; }
     const char *GetWeightName() const override final { return "duration"; }
@@ -0,0 +1,172 @@
+#include "server/connection.hpp"
+#include "server/api/parsed_url.hpp"
+#include "server/request_handler.hpp"
+#include "server/request_scheduler.hpp"
+
+#include "util/json_container.hpp"
+
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(connection)
+
+using namespace osrm;
+using namespace osrm::server;
+using boost::asio::ip::tcp;
+
+namespace
+{
+// Answers every query with its coordinates and options
+class EchoServiceHandler final : public ServiceHandlerInterface
+{
+  public:
+    engine::Status RunQuery(api::ParsedURL parsed_url,
+                            service::BaseService::ResultT &result) override
+    {
+        util::json::Object json_result;
+        json_result.values["query"] = parsed_url.query;
+        result = std::move(json_result);
+        return engine::Status::Ok;
+    }
+
+    unsigned GetDatasetGeneration() const override { return 0; }
+};
+
+// Accepts a single connection on a local port and serves it from a background thread
+struct ConnectionFixture
+{
+    ConnectionFixture()
+        : acceptor(io_service, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)),
+          scheduler(io_service, {1, 1}, {1, 1}), client(client_io_service)
+    {
+        handler.RegisterServiceHandler(std::make_unique<EchoServiceHandler>());
+
+        auto connection = std::make_shared<Connection>(io_service, handler, scheduler, 512, 5);
+        acceptor.async_accept(connection->socket(),
+                              [connection](const boost::system::error_code &error) {
+                                  if (!error)
+                                  {
+                                      connection->start();
+                                  }
+                              });
+        server_thread = std::thread([this] { io_service.run(); });
+
+        client.connect(acceptor.local_endpoint());
+    }
+
+    ~ConnectionFixture()
+    {
+        io_service.stop();
+        server_thread.join();
+    }
+
+    void Send(const std::string &data) { boost::asio::write(client, boost::asio::buffer(data)); }
+
+    // reads until the server closes the connection
+    std::string Receive()
+    {
+        boost::asio::streambuf buffer;
+        boost::system::error_code error;
+        boost::asio::read(client, buffer, error);
+        BOOST_CHECK(error == boost::asio::error::eof);
+        return std::string(boost::asio::buffers_begin(buffer.data()),
+                           boost::asio::buffers_end(buffer.data()));
+    }
+
+    boost::asio::io_service io_service;
+    tcp::acceptor acceptor;
+    RequestHandler handler;
+    RequestScheduler scheduler;
+    std::thread server_thread;
+
+    boost::asio::io_service client_io_service;
+    tcp::socket client;
+};
+
+// Requests a reply that is big enough to be compressed and checks its decompressed content
+template <typename Decompressor>
+void checkCompressedReply(ConnectionFixture &fixture,
+                          const std::string &encoding,
+                          Decompressor decompressor)
+{
+    std::string query;
+    for (int coordinate = 0; coordinate < 200; ++coordinate)
+    {
+        query += (coordinate == 0 ? "" : ";") + std::to_string(coordinate) + ",2";
+    }
+    fixture.Send("GET /route/v1/driving/" + query + " HTTP/1.1\r\nAccept-Encoding: " + encoding +
+                 "\r\nConnection: close\r\n\r\n");
+    const auto reply = fixture.Receive();
+
+    const auto header_end = reply.find("\r\n\r\n");
+    BOOST_REQUIRE(header_end != std::string::npos);
+    const auto headers = reply.substr(0, header_end);
+    BOOST_CHECK(headers.find("Content-Encoding: " + encoding) != std::string::npos);
+
+    boost::iostreams::filtering_istream stream;
+    stream.push(decompressor);
+    std::istringstream compressed(reply.substr(header_end + 4));
+    stream.push(compressed);
+    std::ostringstream content;
+    boost::iostreams::copy(stream, content);
+
+    BOOST_CHECK(content.str().find("\"query\":\"" + query + "\"") != std::string::npos);
+}
+}
+
+BOOST_FIXTURE_TEST_CASE(pipelined_requests, ConnectionFixture)
+{
+    // both requests arrive in one read and are answered in order
+    Send("GET /route/v1/driving/1,2;3,4 HTTP/1.1\r\n\r\n"
+         "GET /nearest/v1/driving/5,6 HTTP/1.1\r\nConnection: close\r\n\r\n");
+    const auto replies = Receive();
+
+    const auto first = replies.find("\"query\":\"1,2;3,4\"");
+    const auto second = replies.find("\"query\":\"5,6\"");
+    BOOST_REQUIRE(first != std::string::npos);
+    BOOST_REQUIRE(second != std::string::npos);
+    BOOST_CHECK_LT(first, second);
+
+    // the connection is kept open for the second request only
+    const auto keep_alive = replies.find("Connection: keep-alive");
+    const auto close = replies.find("Connection: close");
+    BOOST_CHECK_LT(keep_alive, first);
+    BOOST_CHECK_LT(first, close);
+    BOOST_CHECK_EQUAL(replies.find("Connection: keep-alive", keep_alive + 1), std::string::npos);
+}
+
+BOOST_FIXTURE_TEST_CASE(post_body_split_across_reads, ConnectionFixture)
+{
+    const std::string body = "?alternatives=true";
+    Send("POST /route/v1/driving/1,2;3,4 HTTP/1.1\r\nConnection: close\r\nContent-Length: " +
+         std::to_string(body.size()) + "\r\n\r\n" + body.substr(0, 5));
+    // gives the server time to parse the incomplete request before the rest arrives
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    Send(body.substr(5));
+
+    const auto reply = Receive();
+    BOOST_CHECK(reply.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+    BOOST_CHECK(reply.find("\"query\":\"1,2;3,4?alternatives=true\"") != std::string::npos);
+}
+
+BOOST_FIXTURE_TEST_CASE(gzip_replies, ConnectionFixture)
+{
+    checkCompressedReply(*this, "gzip", boost::iostreams::gzip_decompressor());
+}
+
+// HTTP's deflate is zlib wrapped, raw deflate streams are rejected by the zlib header check
+BOOST_FIXTURE_TEST_CASE(deflate_replies, ConnectionFixture)
+{
+    checkCompressedReply(*this, "deflate", boost::iostreams::zlib_decompressor());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -557,6 +557,31 @@ BOOST_AUTO_TEST_CASE(valid_match_urls)
     CHECK_EQUAL_RANGE(reference_2.radiuses, result_2->radiuses);
     CHECK_EQUAL_RANGE(reference_2.approaches, result_2->approaches);
     CHECK_EQUAL_RANGE(reference_2.coordinates, result_2->coordinates);
+
+    std::vector<util::Coordinate> coords_3 = {{util::FloatLongitude{1}, util::FloatLatitude{2}}};
+
+    MatchParameters reference_3{};
+    reference_3.coordinates = coords_3;
+    reference_3.timestamps = {5};
+    reference_3.vehicle = "bus-42.a_1";
+    auto result_3 = parseParameters<MatchParameters>("1,2?vehicle=bus-42.a_1&timestamps=5");
+    BOOST_CHECK(result_3);
+    BOOST_CHECK(result_3->IsValid());
+    BOOST_CHECK_EQUAL(reference_3.vehicle, result_3->vehicle);
+    CHECK_EQUAL_RANGE(reference_3.timestamps, result_3->timestamps);
+    CHECK_EQUAL_RANGE(reference_3.coordinates, result_3->coordinates);
+
+    auto result_4 =
+        parseParameters<MatchParameters>("1,2;3,4?geometries=none&annotations=nodes");
+    BOOST_CHECK(result_4);
+    BOOST_CHECK(result_4->IsValid());
+    BOOST_CHECK(result_4->geometries == MatchParameters::GeometriesType::None);
+    BOOST_CHECK(result_4->annotations_type == MatchParameters::AnnotationsType::Nodes);
+
+    // steps need geometries
+    auto result_5 = parseParameters<MatchParameters>("1,2;3,4?geometries=none&steps=true");
+    BOOST_CHECK(result_5);
+    BOOST_CHECK(!result_5->IsValid());
 }
 
 BOOST_AUTO_TEST_CASE(valid_nearest_urls)
@@ -583,6 +608,19 @@ BOOST_AUTO_TEST_CASE(valid_nearest_urls)
     CHECK_EQUAL_RANGE(reference_2.radiuses, result_2->radiuses);
     CHECK_EQUAL_RANGE(reference_2.approaches, result_2->approaches);
     CHECK_EQUAL_RANGE(reference_2.coordinates, result_2->coordinates);
+
+    std::vector<util::Coordinate> coords_3 = {{util::FloatLongitude{1}, util::FloatLatitude{2}},
+                                              {util::FloatLongitude{3}, util::FloatLatitude{4}}};
+
+    NearestParameters reference_3{};
+    reference_3.coordinates = coords_3;
+    reference_3.number_of_results = 2;
+    reference_3.batch = true;
+    auto result_3 = parseParameters<NearestParameters>("1,2;3,4?batch=true&number=2");
+    BOOST_CHECK(result_3);
+    BOOST_CHECK_EQUAL(reference_3.batch, result_3->batch);
+    BOOST_CHECK_EQUAL(reference_3.number_of_results, result_3->number_of_results);
+    CHECK_EQUAL_RANGE(reference_3.coordinates, result_3->coordinates);
 }
 
 BOOST_AUTO_TEST_CASE(invalid_tile_urls)
@@ -653,6 +691,30 @@ BOOST_AUTO_TEST_CASE(valid_trip_urls)
     BOOST_CHECK_EQUAL(param_fail_1, 15UL);
     auto param_fail_2 = testInvalidOptions<TripParameters>("1,2;3,4?source=first&destination=nah");
     BOOST_CHECK_EQUAL(param_fail_2, 33UL);
+
+    auto param_constrained =
+        parseParameters<TripParameters>("1,2;3,4;5,6?precedences=0,2;1,2&max_duration=3600.5");
+    BOOST_CHECK(param_constrained);
+    BOOST_CHECK(param_constrained->IsValid());
+    BOOST_CHECK(param_constrained->IsConstrained());
+    BOOST_CHECK_EQUAL(param_constrained->precedences.size(), 2);
+    BOOST_CHECK_EQUAL(param_constrained->precedences[1].first, 1);
+    BOOST_CHECK_EQUAL(param_constrained->precedences[1].second, 2);
+    BOOST_CHECK_EQUAL(*param_constrained->max_duration, 3600.5);
+    BOOST_CHECK(!parseParameters<TripParameters>("1,2;3,4")->IsConstrained());
+
+    auto param_out_of_range = parseParameters<TripParameters>("1,2;3,4?precedences=0,2");
+    BOOST_CHECK(param_out_of_range);
+    BOOST_CHECK(!param_out_of_range->IsValid());
+    auto param_self = parseParameters<TripParameters>("1,2;3,4?precedences=1,1");
+    BOOST_CHECK(!param_self->IsValid());
+    auto param_fail_3 = testInvalidOptions<TripParameters>("1,2;3,4?precedences=0;1");
+    BOOST_CHECK_EQUAL(param_fail_3, 21UL);
+
+    auto param_negative_duration = parseParameters<TripParameters>("1,2;3,4?max_duration=-60");
+    BOOST_CHECK(param_negative_duration);
+    BOOST_CHECK(!param_negative_duration->IsValid());
+    BOOST_CHECK(parseParameters<TripParameters>("1,2;3,4?max_duration=0")->IsValid());
 }
 
 BOOST_AUTO_TEST_SUITE_END()
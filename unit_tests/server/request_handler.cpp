@@ -0,0 +1,125 @@
+#include "server/request_handler.hpp"
+#include "server/api/parsed_url.hpp"
+#include "server/http/reply.hpp"
+#include "server/http/request.hpp"
+
+#include "util/json_container.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(request_handler)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+// Answers every query with the number of queries it ran. The generation can be switched while
+// a query runs, like the engine does when osrm-datastore loaded new data.
+class CountingServiceHandler final : public ServiceHandlerInterface
+{
+  public:
+    CountingServiceHandler(unsigned &queries, unsigned &generation, bool &switch_generation)
+        : queries(queries), generation(generation), switch_generation(switch_generation)
+    {
+    }
+
+    engine::Status RunQuery(api::ParsedURL, service::BaseService::ResultT &result) override
+    {
+        if (switch_generation)
+        {
+            ++generation;
+        }
+        util::json::Object json_result;
+        json_result.values["queries"] = util::json::Number(++queries);
+        result = std::move(json_result);
+        return engine::Status::Ok;
+    }
+
+    unsigned GetDatasetGeneration() const override { return generation; }
+
+  private:
+    unsigned &queries;
+    unsigned &generation;
+    bool &switch_generation;
+};
+
+std::string getCacheStatus(const http::reply &reply)
+{
+    const auto header =
+        std::find_if(reply.headers.begin(), reply.headers.end(), [](const http::header &header) {
+            return header.name == "X-Cache";
+        });
+    return header == reply.headers.end() ? "" : header->value;
+}
+
+struct RequestHandlerFixture
+{
+    RequestHandlerFixture()
+    {
+        handler.RegisterServiceHandler(
+            std::make_unique<CountingServiceHandler>(queries, generation, switch_generation));
+        handler.RegisterResponseCache(
+            std::make_unique<ResponseCache>(1024 * 1024, std::chrono::seconds(60)));
+    }
+
+    // runs the request like a connection does, returns the X-Cache header of the reply
+    std::string Request(const std::string &uri)
+    {
+        http::request request;
+        request.uri = uri;
+        http::reply reply;
+
+        const auto dataset = handler.GetDataset();
+        if (handler.GetCachedReply(request, uri, http::no_compression, dataset, reply))
+        {
+            return getCacheStatus(reply);
+        }
+        handler.HandleRequest(request, uri, reply);
+        handler.CacheReply(uri, http::no_compression, dataset, reply);
+        return getCacheStatus(reply);
+    }
+
+    unsigned queries = 0;
+    unsigned generation = 0;
+    bool switch_generation = false;
+    RequestHandler handler;
+};
+}
+
+BOOST_FIXTURE_TEST_CASE(cache_identical_requests, RequestHandlerFixture)
+{
+    const std::string uri = "/route/v1/driving/1,2;3,4";
+    BOOST_CHECK_EQUAL(Request(uri), "MISS");
+    BOOST_CHECK_EQUAL(Request(uri), "HIT");
+    BOOST_CHECK_EQUAL(queries, 1);
+
+    // tiles are cached by the engine
+    BOOST_CHECK_EQUAL(Request("/tile/v1/driving/tile(1,2,14).mvt"), "");
+    BOOST_CHECK_EQUAL(queries, 2);
+}
+
+BOOST_FIXTURE_TEST_CASE(do_not_cache_replies_across_generations, RequestHandlerFixture)
+{
+    const std::string uri = "/route/v1/driving/1,2;3,4";
+
+    // The engine switched to new data while the request ran, so the reply may have been
+    // computed from the old data and must not be stored for the new generation
+    switch_generation = true;
+    BOOST_CHECK_EQUAL(Request(uri), "MISS");
+    switch_generation = false;
+    BOOST_CHECK_EQUAL(Request(uri), "MISS");
+    BOOST_CHECK_EQUAL(Request(uri), "HIT");
+    BOOST_CHECK_EQUAL(queries, 2);
+
+    // a new generation flushes the cache
+    ++generation;
+    BOOST_CHECK_EQUAL(Request(uri), "MISS");
+    BOOST_CHECK_EQUAL(queries, 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
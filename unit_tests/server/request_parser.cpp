@@ -0,0 +1,76 @@
+#include "server/http/request.hpp"
+#include "server/request_parser.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <tuple>
+
+BOOST_AUTO_TEST_SUITE(request_parser)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+// Parses the first request of the input and returns the unparsed rest
+std::string parse(std::string &input,
+                  http::request &request,
+                  RequestParser::RequestStatus &status,
+                  http::compression_type &compression)
+{
+    RequestParser parser;
+    char *begin = &input[0];
+    char *end = begin + input.size();
+    std::tie(status, compression) = parser.parse(request, begin, end);
+    return std::string(begin, end);
+}
+}
+
+BOOST_AUTO_TEST_CASE(keep_alive)
+{
+    RequestParser::RequestStatus status;
+    http::compression_type compression;
+
+    const auto check = [&](std::string input, const bool keep_alive) {
+        http::request request;
+        parse(input, request, status, compression);
+        BOOST_CHECK(status == RequestParser::RequestStatus::valid);
+        BOOST_CHECK_EQUAL(request.keep_alive, keep_alive);
+    };
+
+    check("GET /route HTTP/1.1\r\n\r\n", true);
+    check("GET /route HTTP/1.1\r\nConnection: close\r\n\r\n", false);
+    check("GET /route HTTP/1.0\r\n\r\n", false);
+    check("GET /route HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n", true);
+}
+
+BOOST_AUTO_TEST_CASE(pipelined_requests)
+{
+    RequestParser::RequestStatus status;
+    http::compression_type compression;
+    http::request request;
+
+    std::string input = "GET /nearest HTTP/1.1\r\nAccept-Encoding: gzip\r\n\r\n"
+                        "POST /route HTTP/1.1\r\nContent-Length: 4\r\n\r\n?a=1"
+                        "GET /table";
+
+    auto rest = parse(input, request, status, compression);
+    BOOST_CHECK(status == RequestParser::RequestStatus::valid);
+    BOOST_CHECK(compression == http::gzip_rfc1952);
+    BOOST_CHECK_EQUAL(request.uri, "/nearest");
+
+    // the body ends after content length bytes
+    request = http::request();
+    rest = parse(rest, request, status, compression);
+    BOOST_CHECK(status == RequestParser::RequestStatus::valid);
+    BOOST_CHECK(compression == http::no_compression);
+    BOOST_CHECK_EQUAL(request.uri, "/route?a=1");
+
+    request = http::request();
+    rest = parse(rest, request, status, compression);
+    BOOST_CHECK(status == RequestParser::RequestStatus::indeterminate);
+    BOOST_CHECK_EQUAL(rest, "");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,70 @@
+#include "server/request_scheduler.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(request_scheduler)
+
+using namespace osrm;
+using namespace osrm::server;
+
+BOOST_AUTO_TEST_CASE(classify)
+{
+    BOOST_CHECK(RequestScheduler::Classify("/route/v1/driving/1,2;3,4") ==
+                RequestScheduler::ServiceClass::Interactive);
+    BOOST_CHECK(RequestScheduler::Classify("/nearest/v1/driving/1,2") ==
+                RequestScheduler::ServiceClass::Interactive);
+    BOOST_CHECK(RequestScheduler::Classify("/table/v1/driving/1,2;3,4") ==
+                RequestScheduler::ServiceClass::Batch);
+    BOOST_CHECK(RequestScheduler::Classify("/match/v1/driving/1,2;3,4") ==
+                RequestScheduler::ServiceClass::Batch);
+    BOOST_CHECK(RequestScheduler::Classify("/trip/v1/driving/1,2;3,4") ==
+                RequestScheduler::ServiceClass::Batch);
+}
+
+BOOST_AUTO_TEST_CASE(queue_and_reject)
+{
+    boost::asio::io_service io_service;
+    RequestScheduler scheduler(io_service, {2, 0}, {1, 1});
+    const auto batch = RequestScheduler::ServiceClass::Batch;
+    const auto interactive = RequestScheduler::ServiceClass::Interactive;
+
+    std::vector<std::string> order;
+    BOOST_CHECK(scheduler.Submit(batch, [&] {
+        // the only batch slot is taken while this request runs
+        BOOST_CHECK(scheduler.Submit(batch, [&] { order.push_back("queued"); }));
+        BOOST_CHECK(!scheduler.Submit(batch, [&] { order.push_back("rejected"); }));
+
+        const auto statistics = scheduler.GetStatistics(batch);
+        BOOST_CHECK_EQUAL(statistics.running, 1);
+        BOOST_CHECK_EQUAL(statistics.queued, 1);
+        BOOST_CHECK_EQUAL(statistics.rejected, 1);
+
+        // other classes are not affected
+        BOOST_CHECK(scheduler.Submit(interactive, [&] { order.push_back("interactive"); }));
+        order.push_back("first");
+    }));
+
+    // the waiting request is run once the first one finished
+    io_service.run();
+    BOOST_REQUIRE_EQUAL(order.size(), 3);
+    BOOST_CHECK_EQUAL(order[0], "interactive");
+    BOOST_CHECK_EQUAL(order[1], "first");
+    BOOST_CHECK_EQUAL(order[2], "queued");
+
+    const auto statistics = scheduler.GetStatistics(batch);
+    BOOST_CHECK_EQUAL(statistics.running, 0);
+    BOOST_CHECK_EQUAL(statistics.queued, 0);
+
+    // without a queue requests are rejected as soon as all slots are taken
+    BOOST_CHECK(scheduler.Submit(interactive, [&] {
+        BOOST_CHECK(scheduler.Submit(interactive, [&] {
+            BOOST_CHECK(!scheduler.Submit(interactive, [] {}));
+        }));
+    }));
+    BOOST_CHECK_EQUAL(scheduler.GetStatistics(interactive).rejected, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,110 @@
+#include "server/response_cache.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(response_cache)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+CachedResponse makeResponse(const std::string &content)
+{
+    return CachedResponse{http::reply::ok,
+                          {{"Content-Encoding", "gzip"},
+                           {"Content-Length", std::to_string(content.size())}},
+                          std::vector<char>(content.begin(), content.end())};
+}
+
+std::string getContent(const std::shared_ptr<const CachedResponse> &response)
+{
+    return std::string(response->content.begin(), response->content.end());
+}
+}
+
+BOOST_AUTO_TEST_CASE(get_put)
+{
+    ResponseCache cache(100, std::chrono::seconds(10));
+    const auto now = ResponseCache::Clock::now();
+
+    const ResponseKey key{"/route/v1/driving/1,2;3,4", http::gzip_rfc1952};
+    BOOST_CHECK(!cache.Get(key, 0, now));
+
+    cache.Put(key, 0, now, makeResponse("route"));
+    const auto response = cache.Get(key, 0, now);
+    BOOST_REQUIRE(response);
+    BOOST_CHECK_EQUAL(getContent(response), "route");
+    BOOST_CHECK_EQUAL(response->headers.size(), 2);
+    BOOST_CHECK_EQUAL(response->headers[0].second, "gzip");
+
+    // replies are not shared between encodings
+    BOOST_CHECK(!cache.Get(ResponseKey{key.url, http::deflate_rfc1951}, 0, now));
+    BOOST_CHECK(!cache.Get(ResponseKey{key.url, http::no_compression}, 0, now));
+}
+
+BOOST_AUTO_TEST_CASE(time_to_live)
+{
+    ResponseCache cache(100, std::chrono::seconds(10));
+    const auto now = ResponseCache::Clock::now();
+
+    const ResponseKey key{"/nearest/v1/driving/1,2", http::no_compression};
+    cache.Put(key, 0, now, makeResponse("nearest"));
+    BOOST_CHECK(cache.Get(key, 0, now + std::chrono::seconds(10)));
+    BOOST_CHECK(!cache.Get(key, 0, now + std::chrono::seconds(11)));
+    BOOST_CHECK_EQUAL(cache.Size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(evict_least_recently_used)
+{
+    // every entry takes the size of its url and content
+    ResponseCache cache(10, std::chrono::seconds(10));
+    const auto now = ResponseCache::Clock::now();
+
+    const ResponseKey a{"a", http::no_compression};
+    const ResponseKey b{"b", http::no_compression};
+    const ResponseKey c{"c", http::no_compression};
+    cache.Put(a, 0, now, makeResponse("aaaa"));
+    cache.Put(b, 0, now, makeResponse("bbbb"));
+
+    // reading "a" makes "b" the least recently used reply
+    BOOST_CHECK(cache.Get(a, 0, now));
+    cache.Put(c, 0, now, makeResponse("cccc"));
+
+    BOOST_CHECK_EQUAL(cache.Size(), 2);
+    BOOST_CHECK(!cache.Get(b, 0, now));
+    BOOST_CHECK(cache.Get(a, 0, now));
+    BOOST_CHECK(cache.Get(c, 0, now));
+
+    // replies bigger than the whole cache are not stored
+    cache.Put(b, 0, now, makeResponse("bbbbbbbbbb"));
+    BOOST_CHECK(!cache.Get(b, 0, now));
+    BOOST_CHECK_EQUAL(cache.Size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(flush_on_new_dataset)
+{
+    ResponseCache cache(100, std::chrono::seconds(10));
+    const auto now = ResponseCache::Clock::now();
+
+    const ResponseKey key{"/table/v1/driving/1,2;3,4", http::gzip_rfc1952};
+    cache.Put(key, 0, now, makeResponse("table"));
+    BOOST_CHECK_EQUAL(cache.Size(), 1);
+
+    // a request for the new data flushes all replies of the old data
+    BOOST_CHECK(!cache.Get(key, 1, now));
+    BOOST_CHECK_EQUAL(cache.Size(), 0);
+
+    // replies computed for the old data are not stored anymore
+    cache.Put(key, 0, now, makeResponse("table"));
+    BOOST_CHECK_EQUAL(cache.Size(), 0);
+
+    cache.Put(key, 1, now, makeResponse("table"));
+    BOOST_CHECK(cache.Get(key, 1, now));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
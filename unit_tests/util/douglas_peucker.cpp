@@ -1,4 +1,4 @@
-#include "engine/douglas_peucker.hpp"
+#include "util/douglas_peucker.hpp"
 #include "util/coordinate_calculation.hpp"
 
 #include <boost/test/test_case_template.hpp>
@@ -11,7 +11,7 @@
 BOOST_AUTO_TEST_SUITE(douglas_peucker_simplification)
 
 using namespace osrm;
-using namespace osrm::engine;
+using namespace osrm::util;
 
 BOOST_AUTO_TEST_CASE(calibrate_thresholds)
 {
@@ -0,0 +1,140 @@
+#include "util/cast.hpp"
+#include "util/json_renderer.hpp"
+#include "util/json_writer.hpp"
+#include "util/string_util.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <limits>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(json_writer)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+std::string writeNumber(const double value)
+{
+    std::vector<char> buffer;
+    json::Writer writer(buffer);
+    writer.Number(value);
+    return std::string(buffer.begin(), buffer.end());
+}
+}
+
+BOOST_AUTO_TEST_CASE(numbers_match_stringstream_formatting)
+{
+    const std::vector<double> values = {0.,
+                                        -0.,
+                                        1.,
+                                        -1.,
+                                        10.,
+                                        100.,
+                                        0.5,
+                                        -0.5,
+                                        13.388798,
+                                        52.517033,
+                                        -122.4194155,
+                                        0.1 + 0.2,
+                                        1e-7,
+                                        -1e-7,
+                                        0.0000005,
+                                        2.0000005,
+                                        123456789.123456789,
+                                        4294967295.,
+                                        9007199254740992.,
+                                        1e20,
+                                        -1e20,
+                                        1.7976931348623157e308,
+                                        std::numeric_limits<double>::infinity(),
+                                        -std::numeric_limits<double>::infinity()};
+    for (const auto value : values)
+    {
+        BOOST_CHECK_EQUAL(writeNumber(value), cast::to_string_with_precision(value));
+    }
+
+    for (int index = -100000; index < 100000; index += 7)
+    {
+        const double value = index / 1000.;
+        BOOST_CHECK_EQUAL(writeNumber(value), cast::to_string_with_precision(value));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(strings_are_escaped)
+{
+    const std::string input = "Aleja \"Solidarnosci\"\\/\b\f\n\r\t";
+
+    std::vector<char> buffer;
+    json::Writer writer(buffer);
+    writer.String(input);
+
+    BOOST_CHECK_EQUAL(std::string(buffer.begin(), buffer.end()), "\"" + escape_JSON(input) + "\"");
+}
+
+BOOST_AUTO_TEST_CASE(nested_values)
+{
+    std::vector<char> buffer;
+    json::Writer writer(buffer);
+    writer.StartObject();
+    writer.Key("code");
+    writer.String("Ok");
+    writer.Key("waypoints");
+    writer.StartArray();
+    writer.StartArray();
+    writer.EndArray();
+    writer.StartObject();
+    writer.EndObject();
+    writer.Number(1.5);
+    writer.Null();
+    writer.EndArray();
+    writer.Key(std::string("valid"));
+    writer.Bool(true);
+    writer.Key("empty");
+    writer.Bool(false);
+    writer.EndObject();
+
+    BOOST_CHECK_EQUAL(std::string(buffer.begin(), buffer.end()),
+                      "{\"code\":\"Ok\",\"waypoints\":[[],{},1.5,null],\"valid\":true,"
+                      "\"empty\":false}");
+}
+
+BOOST_AUTO_TEST_CASE(render_object)
+{
+    json::Object object;
+    object.values["code"] = "Ok";
+    object.values["distance"] = 1234.5678;
+
+    json::Array coordinates;
+    coordinates.values.push_back(13.388798);
+    coordinates.values.push_back(52.517033);
+    coordinates.values.push_back(json::True());
+    coordinates.values.push_back(json::Null());
+    object.values["coordinates"] = std::move(coordinates);
+
+    std::vector<char> buffer;
+    json::render(buffer, object);
+    const std::string rendered(buffer.begin(), buffer.end());
+
+    // keys are written in the iteration order of the object
+    std::string reference = "{";
+    for (const auto &key_value : object.values)
+    {
+        if (reference.size() > 1)
+            reference += ",";
+        reference += "\"" + key_value.first + "\":";
+        if (key_value.first == "code")
+            reference += "\"Ok\"";
+        else if (key_value.first == "distance")
+            reference += "1234.5678";
+        else
+            reference += "[13.388798,52.517033,true,null]";
+    }
+    reference += "}";
+
+    BOOST_CHECK_EQUAL(rendered, reference);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
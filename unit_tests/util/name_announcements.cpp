@@ -0,0 +1,101 @@
+#include "util/guidance/name_announcements.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(name_announcements)
+
+using namespace osrm;
+using namespace osrm::util;
+using namespace osrm::util::guidance;
+
+namespace
+{
+struct TestSuffixTable
+{
+    bool isSuffix(const std::string &possible_suffix) const
+    {
+        return possible_suffix == "north" || possible_suffix == "st";
+    }
+};
+
+// checks that views into a shared buffer and owned strings give the same answer
+bool requiresNameAnnouncedForViews(const std::string &from_name,
+                                   const std::string &from_ref,
+                                   const std::string &to_name,
+                                   const std::string &to_ref)
+{
+    const std::string buffer = from_name + from_ref + to_name + to_ref;
+    const StringView view{buffer};
+    const auto views_result =
+        requiresNameAnnounced(view.substr(0, from_name.size()),
+                              view.substr(from_name.size(), from_ref.size()),
+                              StringView(),
+                              StringView(),
+                              view.substr(from_name.size() + from_ref.size(), to_name.size()),
+                              view.substr(from_name.size() + from_ref.size() + to_name.size()),
+                              StringView(),
+                              StringView());
+    const auto strings_result =
+        requiresNameAnnounced(from_name, from_ref, "", "", to_name, to_ref, "", "");
+    BOOST_CHECK_EQUAL(views_result, strings_result);
+    return views_result;
+}
+}
+
+BOOST_AUTO_TEST_CASE(longest_common_substring_views)
+{
+    BOOST_CHECK_EQUAL(longest_common_substring(StringView("Main Street"), StringView("Main St")),
+                      "Main St");
+    BOOST_CHECK_EQUAL(longest_common_substring(StringView("abc"), StringView("xyz")), "");
+    BOOST_CHECK_EQUAL(longest_common_substring(std::string("xMainy"), std::string("Main")), "Main");
+
+    // names too long for the rows on the stack
+    const std::string long_name(100, 'a');
+    const std::string other_long_name = "b" + long_name;
+    BOOST_CHECK_EQUAL(
+        longest_common_substring(StringView(other_long_name), StringView(long_name)), long_name);
+}
+
+BOOST_AUTO_TEST_CASE(decompose_views)
+{
+    StringView lhs_prefix, lhs_suffix, rhs_prefix, rhs_suffix;
+    std::tie(lhs_prefix, lhs_suffix, rhs_prefix, rhs_suffix) =
+        decompose(StringView("West Main St"), StringView("Main St North "));
+    BOOST_CHECK_EQUAL(lhs_prefix, "West");
+    BOOST_CHECK_EQUAL(lhs_suffix, "");
+    BOOST_CHECK_EQUAL(rhs_prefix, "");
+    BOOST_CHECK_EQUAL(rhs_suffix, "North");
+}
+
+BOOST_AUTO_TEST_CASE(announce_name_changes)
+{
+    BOOST_CHECK(!requiresNameAnnouncedForViews("Main Street", "", "Main Street", ""));
+    BOOST_CHECK(!requiresNameAnnouncedForViews("Main Street", "", "Main", ""));
+    BOOST_CHECK(!requiresNameAnnouncedForViews("", "", "", ""));
+    BOOST_CHECK(requiresNameAnnouncedForViews("", "", "Main Street", ""));
+    BOOST_CHECK(requiresNameAnnouncedForViews("Main Street", "", "Broadway", ""));
+    BOOST_CHECK(!requiresNameAnnouncedForViews("Main Street", "A1", "Main Street", "A1;B2"));
+    BOOST_CHECK(requiresNameAnnouncedForViews("", "A1", "Main Street", ""));
+
+    const std::string long_name(100, 'a');
+    BOOST_CHECK(!requiresNameAnnouncedForViews(long_name, "", long_name, ""));
+    BOOST_CHECK(requiresNameAnnouncedForViews(long_name + "b", "", "c" + long_name, ""));
+}
+
+BOOST_AUTO_TEST_CASE(suffix_changes)
+{
+    const TestSuffixTable suffix_table;
+    const auto announce = [&](const std::string &from_name, const std::string &to_name) {
+        return requiresNameAnnounced(from_name, "", "", "", to_name, "", "", "", suffix_table);
+    };
+
+    // the suffix table is looked up in lower case
+    BOOST_CHECK(!announce("North Main St", "Main St"));
+    BOOST_CHECK(!announce("Main Ave", "NORTH Main Ave"));
+    BOOST_CHECK(announce("South Main St", "Main St"));
+    BOOST_CHECK(announce("Main St", "Main Ave"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,7 @@
 #include "util/coordinate_calculation.hpp"
 #include "util/exception.hpp"
 #include "util/rectangle.hpp"
+#include "util/static_grid.hpp"
 #include "util/typedefs.hpp"
 
 #include "mocks/mock_datafacade.hpp"
@@ -300,6 +301,30 @@ BOOST_FIXTURE_TEST_CASE(construct_multiple_levels_test, TestRandomGraphFixture_M
     construction_test("test_5", this);
 }
 
+BOOST_FIXTURE_TEST_CASE(construct_with_leaf_advice_test, TestRandomGraphFixture_MultipleLevels)
+{
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<TestRandomGraphFixture_MultipleLevels>("test_6", this, leaves_path, nodes_path);
+
+    MMapAdvice advice;
+    advice.populate = true;
+    advice.huge_pages = true;
+    advice.prefetch = true;
+    TestStaticRTree rtree(nodes_path, leaves_path, coords, advice);
+    LinearSearchNN<TestData> lsnn(coords, edges);
+
+    simple_verify_rtree(rtree, coords, edges);
+    sampling_verify_rtree(rtree, lsnn, coords, 100);
+
+    // leaves are only prefetched if they are not populated on load
+    MMapAdvice prefetch_advice;
+    prefetch_advice.prefetch = true;
+    TestStaticRTree prefetching_rtree(nodes_path, leaves_path, coords, prefetch_advice);
+    simple_verify_rtree(prefetching_rtree, coords, edges);
+    sampling_verify_rtree(prefetching_rtree, lsnn, coords, 100);
+}
+
 // Bug: If you querry a point that lies between two BBs that have a gap,
 // one BB will be pruned, even if it could contain a nearer match.
 BOOST_AUTO_TEST_CASE(regression_test)
@@ -482,4 +507,258 @@ BOOST_AUTO_TEST_CASE(bbox_search_tests)
     }
 }
 
+// Pruning subtrees without big components must not change the snapping result
+BOOST_FIXTURE_TEST_CASE(big_component_pruning_test, TestRandomGraphFixture_MultipleLevels)
+{
+    // every fourth segment is part of a big component
+    struct ComponentDataFacade : MockBaseDataFacade
+    {
+        ComponentID GetComponentID(const NodeID id) const override
+        {
+            return ComponentID{id % 4 == 0 ? 1u : 2u + id, id % 4 != 0};
+        }
+    };
+    const auto is_big_component = [](const TestData &data) {
+        return data.forward_segment_id.id % 4 == 0;
+    };
+
+    for (const auto i : irange<std::size_t>(0, edges.size()))
+    {
+        edges[i].forward_segment_id = {static_cast<NodeID>(i), true};
+        edges[i].reverse_segment_id = {static_cast<NodeID>(i), true};
+        edges[i].fwd_segment_position = 0;
+    }
+
+    const std::string nodes_path = "test_components.ramIndex";
+    const std::string leaves_path = "test_components.fileIndex";
+    TestStaticRTree builder(edges, nodes_path, leaves_path, coords, is_big_component);
+    TestStaticRTree rtree(nodes_path, leaves_path, coords);
+
+    const std::string unmarked_nodes_path = "test_components_unmarked.ramIndex";
+    const std::string unmarked_leaves_path = "test_components_unmarked.fileIndex";
+    TestStaticRTree unmarked_builder(edges, unmarked_nodes_path, unmarked_leaves_path, coords);
+    TestStaticRTree unmarked_rtree(unmarked_nodes_path, unmarked_leaves_path, coords);
+
+    ComponentDataFacade mockfacade;
+    engine::GeospatialQuery<TestStaticRTree, ComponentDataFacade> query(
+        rtree, coords, mockfacade);
+    engine::GeospatialQuery<TestStaticRTree, ComponentDataFacade> unmarked_query(
+        unmarked_rtree, coords, mockfacade);
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+    for (unsigned i = 0; i < 100; i++)
+    {
+        const Coordinate input{FixedLongitude{lon_udist(g)}, FixedLatitude{lat_udist(g)}};
+
+        const auto result = query.NearestPhantomNodeWithAlternativeFromBigComponent(
+            input, engine::Approach::UNRESTRICTED);
+        const auto expected = unmarked_query.NearestPhantomNodeWithAlternativeFromBigComponent(
+            input, engine::Approach::UNRESTRICTED);
+
+        // segments at the same distance may come in any order
+        BOOST_CHECK_EQUAL(result.first.location, expected.first.location);
+        BOOST_CHECK_EQUAL(result.second.location, expected.second.location);
+        BOOST_CHECK_EQUAL(result.second.forward_segment_id.id % 4, 0);
+    }
+}
+
+// Files written before the node flags were packed into the rectangle must not load silently
+BOOST_FIXTURE_TEST_CASE(outdated_file_format_test, TestRandomGraphFixture_MultipleLevels)
+{
+    const std::string nodes_path = "test_outdated.ramIndex";
+    const std::string leaves_path = "test_outdated.fileIndex";
+    TestStaticRTree builder(edges, nodes_path, leaves_path, coords);
+
+    // rewrite the file in the old layout: node count right after the fingerprint
+    {
+        storage::io::FileReader reader(nodes_path, storage::io::FileReader::VerifyFingerprint);
+        reader.Skip<std::uint64_t>(1);
+        std::vector<TestStaticRTree::TreeNode> tree(reader.ReadElementCount64());
+        reader.ReadInto(tree);
+        std::vector<std::uint64_t> level_sizes(reader.ReadElementCount64());
+        reader.ReadInto(level_sizes);
+
+        storage::io::FileWriter writer(nodes_path, storage::io::FileWriter::GenerateFingerprint);
+        writer.WriteElementCount64(tree.size());
+        writer.WriteFrom(tree);
+        writer.WriteElementCount64(level_sizes.size());
+        writer.WriteFrom(level_sizes);
+    }
+
+    BOOST_CHECK_THROW(TestStaticRTree(nodes_path, leaves_path, coords), util::RuntimeError);
+}
+
+// The spatial grid must not change any result, it only shortcuts the r-tree
+BOOST_AUTO_TEST_CASE(spatial_grid_test)
+{
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lon_udist(13.3 * COORDINATE_PRECISION,
+                                              13.5 * COORDINATE_PRECISION);
+    std::uniform_int_distribution<> lat_udist(52.4 * COORDINATE_PRECISION,
+                                              52.6 * COORDINATE_PRECISION);
+    std::uniform_int_distribution<> offset_udist(-0.002 * COORDINATE_PRECISION,
+                                                 0.002 * COORDINATE_PRECISION);
+
+    std::vector<Coordinate> coords;
+    std::vector<TestData> edges;
+    for (unsigned i = 0; i < 2000; i++)
+    {
+        const auto lon = lon_udist(g);
+        const auto lat = lat_udist(g);
+        coords.emplace_back(FixedLongitude{lon}, FixedLatitude{lat});
+        coords.emplace_back(FixedLongitude{lon + offset_udist(g)},
+                            FixedLatitude{lat + offset_udist(g)});
+
+        TestData data;
+        data.u = 2 * i;
+        data.v = 2 * i + 1;
+        data.forward_segment_id = {data.v, true};
+        data.reverse_segment_id = {data.u, true};
+        data.fwd_segment_position = 0;
+        edges.push_back(data);
+    }
+
+    const std::string nodes_path = "test_grid.ramIndex";
+    const std::string leaves_path = "test_grid.fileIndex";
+    TestStaticRTree builder(edges, nodes_path, leaves_path, coords);
+    TestStaticRTree rtree(nodes_path, leaves_path, coords);
+    StaticGrid<TestData> grid(edges, coords, 0.01 * COORDINATE_PRECISION);
+    BOOST_CHECK(!grid.Empty());
+
+    TestDataFacade mockfacade;
+    engine::GeospatialQuery<TestStaticRTree, TestDataFacade, StaticGrid<TestData>> rtree_query(
+        rtree, coords, mockfacade);
+    engine::GeospatialQuery<TestStaticRTree, TestDataFacade, StaticGrid<TestData>> grid_query(
+        rtree, coords, mockfacade, &grid);
+
+    const auto check_equal = [](const std::vector<engine::PhantomNodeWithDistance> &lhs,
+                                const std::vector<engine::PhantomNodeWithDistance> &rhs) {
+        BOOST_REQUIRE_EQUAL(lhs.size(), rhs.size());
+        for (const auto i : irange<std::size_t>(0, lhs.size()))
+        {
+            BOOST_CHECK_EQUAL(lhs[i].phantom_node.forward_segment_id.id,
+                              rhs[i].phantom_node.forward_segment_id.id);
+            BOOST_CHECK_EQUAL(lhs[i].phantom_node.location, rhs[i].phantom_node.location);
+        }
+    };
+
+    // also query outside of the grid, which has to fall back to the r-tree
+    std::uniform_int_distribution<> outside_udist(-0.05 * COORDINATE_PRECISION,
+                                                  0.05 * COORDINATE_PRECISION);
+    for (unsigned i = 0; i < 200; i++)
+    {
+        const Coordinate input{FixedLongitude{lon_udist(g) + outside_udist(g)},
+                               FixedLatitude{lat_udist(g) + outside_udist(g)}};
+
+        for (const unsigned number : {1, 5, 50})
+        {
+            check_equal(
+                rtree_query.NearestPhantomNodes(input, number, engine::Approach::UNRESTRICTED),
+                grid_query.NearestPhantomNodes(input, number, engine::Approach::UNRESTRICTED));
+        }
+        check_equal(
+            rtree_query.NearestPhantomNodesInRange(input, 200, engine::Approach::UNRESTRICTED),
+            grid_query.NearestPhantomNodesInRange(input, 200, engine::Approach::UNRESTRICTED));
+
+        const auto rtree_pair = rtree_query.NearestPhantomNodeWithAlternativeFromBigComponent(
+            input, engine::Approach::UNRESTRICTED);
+        const auto grid_pair = grid_query.NearestPhantomNodeWithAlternativeFromBigComponent(
+            input, engine::Approach::UNRESTRICTED);
+        BOOST_CHECK_EQUAL(rtree_pair.first.location, grid_pair.first.location);
+        BOOST_CHECK_EQUAL(rtree_pair.second.location, grid_pair.second.location);
+    }
+}
+
+// Snapping a whole trace must find the same candidates as snapping each point on its own
+BOOST_AUTO_TEST_CASE(trace_range_query_test)
+{
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lon_udist(13.3 * COORDINATE_PRECISION,
+                                              13.4 * COORDINATE_PRECISION);
+    std::uniform_int_distribution<> lat_udist(52.4 * COORDINATE_PRECISION,
+                                              52.5 * COORDINATE_PRECISION);
+    std::uniform_int_distribution<> offset_udist(-0.002 * COORDINATE_PRECISION,
+                                                 0.002 * COORDINATE_PRECISION);
+
+    std::vector<Coordinate> coords;
+    std::vector<TestData> edges;
+    for (unsigned i = 0; i < 5000; i++)
+    {
+        const auto lon = lon_udist(g);
+        const auto lat = lat_udist(g);
+        coords.emplace_back(FixedLongitude{lon}, FixedLatitude{lat});
+        coords.emplace_back(FixedLongitude{lon + offset_udist(g)},
+                            FixedLatitude{lat + offset_udist(g)});
+
+        TestData data;
+        data.u = 2 * i;
+        data.v = 2 * i + 1;
+        data.forward_segment_id = {data.v, true};
+        data.reverse_segment_id = {data.u, true};
+        data.fwd_segment_position = 0;
+        edges.push_back(data);
+    }
+
+    const std::string nodes_path = "test_trace.ramIndex";
+    const std::string leaves_path = "test_trace.fileIndex";
+    TestStaticRTree builder(edges, nodes_path, leaves_path, coords);
+    TestStaticRTree rtree(nodes_path, leaves_path, coords);
+    TestDataFacade mockfacade;
+    engine::GeospatialQuery<TestStaticRTree, TestDataFacade> query(rtree, coords, mockfacade);
+
+    // a random walk with steps of up to ~20m and a few jumps
+    std::uniform_int_distribution<> step_udist(-0.0002 * COORDINATE_PRECISION,
+                                               0.0002 * COORDINATE_PRECISION);
+    std::uniform_real_distribution<> radius_udist(5, 100);
+    std::vector<Coordinate> trace{Coordinate{FixedLongitude{lon_udist(g)},
+                                             FixedLatitude{lat_udist(g)}}};
+    for (unsigned i = 1; i < 300; i++)
+    {
+        if (i % 100 == 0)
+        {
+            trace.emplace_back(FixedLongitude{lon_udist(g)}, FixedLatitude{lat_udist(g)});
+        }
+        else
+        {
+            trace.emplace_back(FixedLongitude{static_cast<std::int32_t>(trace.back().lon) +
+                                              step_udist(g)},
+                               FixedLatitude{static_cast<std::int32_t>(trace.back().lat) +
+                                             step_udist(g)});
+        }
+    }
+    std::vector<double> radiuses(trace.size());
+    std::generate(radiuses.begin(), radiuses.end(), [&] { return radius_udist(g); });
+    const std::vector<engine::Approach> approaches(trace.size(),
+                                                   engine::Approach::UNRESTRICTED);
+
+    const auto by_segment = [](const engine::PhantomNodeWithDistance &lhs,
+                               const engine::PhantomNodeWithDistance &rhs) {
+        return lhs.phantom_node.forward_segment_id.id < rhs.phantom_node.forward_segment_id.id;
+    };
+
+    const auto candidates = query.NearestPhantomNodesInRange(trace, radiuses, approaches);
+    BOOST_REQUIRE_EQUAL(candidates.size(), trace.size());
+    std::size_t num_candidates = 0;
+    for (const auto i : irange<std::size_t>(0, trace.size()))
+    {
+        auto expected = query.NearestPhantomNodesInRange(
+            trace[i], radiuses[i], engine::Approach::UNRESTRICTED);
+        auto actual = candidates[i];
+        std::sort(expected.begin(), expected.end(), by_segment);
+        std::sort(actual.begin(), actual.end(), by_segment);
+
+        BOOST_REQUIRE_EQUAL(expected.size(), actual.size());
+        for (const auto j : irange<std::size_t>(0, expected.size()))
+        {
+            BOOST_CHECK_EQUAL(expected[j].phantom_node.forward_segment_id.id,
+                              actual[j].phantom_node.forward_segment_id.id);
+            BOOST_CHECK_EQUAL(expected[j].phantom_node.location, actual[j].phantom_node.location);
+        }
+        num_candidates += expected.size();
+    }
+    BOOST_CHECK_GT(num_candidates, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()